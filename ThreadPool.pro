@@ -3,29 +3,36 @@ QT       += core gui
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
+include($$PWD/warnings.pri)
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# 日志编译期最低级别（0=Debug 1=Info 2=Warning 3=Error），低于它的POOL_LOG_XXX语句整条去掉
+#DEFINES += POOL_LOG_MIN_LEVEL=1
+
+# 锁争用统计：按加锁调用点统计等待/持有时间，点“停止”时输出报告到日志区
+#DEFINES += POOL_LOCK_PROFILING
+
+include(threadpoolcore.pri)
+
 SOURCES += \
-    communication/filecommunication.cpp \
+    ganttview.cpp \
     main.cpp \
     mainwindow.cpp \
-    poolview.cpp \
-    scheduler.cpp \
-    taskqueue.cpp \
-    threadpool.cpp
+    metricschart.cpp \
+    poollistmodels.cpp \
+    poolmodel.cpp \
+    poolview.cpp
 
 HEADERS += \
-    communication/ICommunication.h \
-    communication/filecommunication.h \
+    ganttview.h \
     mainwindow.h \
-    poolview.h \
-    scheduler.h \
-    taskqueue.h \
-    threadpool.h \
-    visualinfo.h
+    metricschart.h \
+    poollistmodels.h \
+    poolmodel.h \
+    poolview.h
 
 FORMS += \
     mainwindow.ui
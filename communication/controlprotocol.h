@@ -0,0 +1,115 @@
+#ifndef CONTROLPROTOCOL_H
+#define CONTROLPROTOCOL_H
+
+#include <QByteArray>
+#include <QtEndian>
+
+/*
+ * 本地套接字控制面的帧格式（LocalSocketCommunication和tools/loadgen共用）
+ * 1. 每帧：[u32 长度(小端，含类型字节，不含自身)][u8 类型][负载]，所有整数都是小端。
+ * 2. 客户端 -> 服务端：
+ *    SubmitBatch     u32 requestId, u32 count, count × {u32 totalTimeMs, i32 priority, u32 memSize}
+ *    SetPolicy       u8 SchedulePolicy
+ *    SetThreadRange  u32 minNum, u32 maxNum
+ *    SubscribeStatus u8 0/1（订阅后每次状态上报都会收到StatusReport）
+ * 3. 服务端 -> 客户端：
+ *    SubmitAck         u32 requestId, i32 firstTaskId, u32 count（这批任务的ID为firstTaskId起连续count个）
+ *    TasksFinished     u32 count, count × {i32 taskId, u32 wallTimeUs, u32 cpuTimeUs}
+ *    StatusReport      CBOR编码的状态对象（与autoReportStatus()的字段相同）
+ *    Error             u8 错误码, UTF-8说明文字
+ *    NotificationsLost u64 服务端事件队列溢出次数（溢出期间的完成通知已丢失）
+ */
+
+namespace ControlProtocol {
+
+const char DEFAULT_SERVER_NAME[] = "threadpool-control";
+const int FRAME_HEADER_SIZE = 5;
+const quint32 MAX_FRAME_BYTES = 16 * 1024 * 1024;
+const int MAX_BATCH_TASKS = 65536;
+const int SUBMIT_HEADER_SIZE = 8;
+const int WIRE_TASK_SIZE = 12;
+const int FINISHED_ENTRY_SIZE = 12;
+
+enum MessageType : quint8
+{
+    SubmitBatch = 0x01,
+    SetPolicy = 0x02,
+    SetThreadRange = 0x03,
+    SubscribeStatus = 0x04,
+
+    SubmitAck = 0x81,
+    TasksFinished = 0x82,
+    StatusReport = 0x83,
+    Error = 0x84,
+    NotificationsLost = 0x85
+};
+
+enum ErrorCode : quint8
+{
+    MalformedFrame = 1,
+    UnknownMessage = 2,
+    InvalidArgument = 3
+};
+
+struct Frame
+{
+    quint8 type = 0;
+    const uchar* payload = nullptr;
+    int size = 0;           // 负载字节数
+    int totalSize = 0;      // 含帧头的字节数
+};
+
+enum class ParseResult
+{
+    Ok,
+    Incomplete,     // 数据还没收全
+    Invalid         // 长度非法，连接应断开
+};
+
+// 从buffer的offset处解析一帧（不拷贝，payload指向buffer内部）
+inline ParseResult parseFrame(const QByteArray& buffer, int offset, Frame& frame)
+{
+    if (buffer.size() - offset < FRAME_HEADER_SIZE) return ParseResult::Incomplete;
+    const uchar* data = reinterpret_cast<const uchar*>(buffer.constData()) + offset;
+    quint32 length = qFromLittleEndian<quint32>(data);
+    if (length < 1 || length > MAX_FRAME_BYTES) return ParseResult::Invalid;
+    if (quint32(buffer.size() - offset) < 4 + length) return ParseResult::Incomplete;
+    frame.type = data[4];
+    frame.payload = data + FRAME_HEADER_SIZE;
+    frame.size = int(length) - 1;
+    frame.totalSize = 4 + int(length);
+    return ParseResult::Ok;
+}
+
+// 追加写帧：beginFrame()预留帧头，写完负载后endFrame()回填长度
+inline int beginFrame(QByteArray& out, MessageType type)
+{
+    int start = out.size();
+    out.resize(start + FRAME_HEADER_SIZE);
+    out[start + 4] = char(type);
+    return start;
+}
+
+inline void endFrame(QByteArray& out, int start)
+{
+    quint32 length = quint32(out.size() - start - 4);
+    qToLittleEndian<quint32>(length, reinterpret_cast<uchar*>(out.data()) + start);
+}
+
+template <typename T>
+inline void append(QByteArray& out, T value)
+{
+    int offset = out.size();
+    out.resize(offset + int(sizeof(T)));
+    qToLittleEndian<T>(value, reinterpret_cast<uchar*>(out.data()) + offset);
+}
+
+template <typename T>
+inline T read(const uchar* data, int offset)
+{
+    return qFromLittleEndian<T>(data + offset);
+}
+
+} // namespace ControlProtocol
+
+#endif // CONTROLPROTOCOL_H
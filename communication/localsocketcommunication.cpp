@@ -0,0 +1,360 @@
+#include "localsocketcommunication.h"
+#include "../threadpool.h"
+#include <QCborMap>
+#include <QCborValue>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QElapsedTimer>
+#include <QTime>
+#include <QTimer>
+#include <atomic>
+#include <list>
+#include <map>
+
+using namespace ControlProtocol;
+
+// 服务端本体，运行在LocalSocketCommunication::m_thread里
+class ControlServer : public QObject
+{
+public:
+    ControlServer(ThreadPool* pool, const QString& name) : m_pool(pool), m_name(name) {}
+
+    void start();
+    void shutdown();
+    void broadcastStatus(const QJsonObject& status);
+    QJsonObject stats() const;
+
+private:
+    struct Client
+    {
+        QLocalSocket* socket = nullptr;
+        QByteArray input;
+        QByteArray output;              // 本轮待发的帧
+        QByteArray finished;            // 本轮的完成通知条目，排空事件后合并成一帧
+        int finishedCount = 0;
+        bool statusSubscribed = false;
+    };
+    // 一批任务的ID区间 [firstId, lastId]，用于把完成事件路由回提交它的客户端
+    struct Batch
+    {
+        int lastId = 0;
+        int remaining = 0;
+        Client* client = nullptr;       // 客户端断开后置空，完成事件直接丢弃
+    };
+
+    void onNewConnection();
+    void onReadyRead(Client* client);
+    void onDisconnected(Client* client);
+    bool handleFrame(Client* client, const Frame& frame);
+    bool handleSubmit(Client* client, const Frame& frame);
+    void sendError(Client* client, ErrorCode code, const char* message);
+    void drainEvents();
+    void pruneBatches();
+    void flush(Client* client);
+
+    ThreadPool* m_pool;
+    const QString m_name;
+    QLocalServer* m_server = nullptr;
+    QTimer* m_drainTimer = nullptr;
+    std::shared_ptr<PoolEventSubscription> m_subscription;
+    std::list<Client> m_clients;
+    std::map<int, Batch> m_batches;     // 以firstId为键
+    int m_staleUpToId = -1;             // 溢出时最后一个批次的firstId，它及之前的批次可能丢过完成事件；-1表示没有
+    QElapsedTimer m_pruneTimer;
+
+    std::atomic<int> m_clientCount{0};
+    std::atomic<quint64> m_batchCount{0};
+    std::atomic<quint64> m_taskCount{0};
+    std::atomic<quint64> m_notifiedCount{0};
+    std::atomic<quint64> m_lostCount{0};
+};
+
+void ControlServer::start()
+{
+    m_server = new QLocalServer(this);
+    // 上次异常退出可能留下同名的套接字文件
+    QLocalServer::removeServer(m_name);
+    if (!m_server->listen(m_name)) {
+        POOL_LOG_WARNING("[控制面]监听失败，外部提交不可用");
+        return;
+    }
+    QObject::connect(m_server, &QLocalServer::newConnection, this, [this]() { onNewConnection(); });
+
+    m_subscription = m_pool->subscribeEvents(LocalSocketCommunication::EVENT_QUEUE_CAPACITY);
+    m_drainTimer = new QTimer(this);
+    m_drainTimer->setTimerType(Qt::PreciseTimer);
+    QObject::connect(m_drainTimer, &QTimer::timeout, this, [this]() { drainEvents(); });
+    m_drainTimer->start(LocalSocketCommunication::DRAIN_INTERVAL_MS);
+    POOL_LOG_INFO("[控制面]开始监听本地套接字");
+}
+
+void ControlServer::shutdown()
+{
+    if (m_drainTimer) m_drainTimer->stop();
+    if (m_subscription) {
+        m_pool->unsubscribeEvents(m_subscription);
+        m_subscription = nullptr;
+    }
+    for (Client& client : m_clients) {
+        QObject::disconnect(client.socket, nullptr, this, nullptr);
+        client.socket->abort();
+    }
+    m_clients.clear();
+    m_batches.clear();
+    if (m_server) m_server->close();
+}
+
+void ControlServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        m_clients.emplace_back();
+        Client* client = &m_clients.back();
+        client->socket = socket;
+        socket->setParent(this);
+        QObject::connect(socket, &QLocalSocket::readyRead, this, [this, client]() { onReadyRead(client); });
+        QObject::connect(socket, &QLocalSocket::disconnected, this, [this, client]() { onDisconnected(client); });
+        m_clientCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ControlServer::onDisconnected(Client* client)
+{
+    for (auto& entry : m_batches) {
+        if (entry.second.client == client) entry.second.client = nullptr;
+    }
+    client->socket->deleteLater();
+    m_clients.remove_if([client](const Client& c) { return &c == client; });
+    m_clientCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ControlServer::onReadyRead(Client* client)
+{
+    client->input.append(client->socket->readAll());
+    int offset = 0;
+    Frame frame;
+    while (true) {
+        ParseResult result = parseFrame(client->input, offset, frame);
+        if (result == ParseResult::Incomplete) break;
+        if (result == ParseResult::Invalid || !handleFrame(client, frame)) {
+            // 协议错误：回一条Error后断开
+            sendError(client, MalformedFrame, "malformed frame");
+            flush(client);
+            client->socket->disconnectFromServer();
+            return;
+        }
+        offset += frame.totalSize;
+    }
+    client->input.remove(0, offset);
+    flush(client);
+}
+
+bool ControlServer::handleFrame(Client* client, const Frame& frame)
+{
+    switch (frame.type) {
+    case SubmitBatch:
+        return handleSubmit(client, frame);
+    case SetPolicy: {
+        if (frame.size != 1) return false;
+        quint8 policy = frame.payload[0];
+        if (policy > quint8(SchedulePolicy::HRRN)) {
+            sendError(client, InvalidArgument, "unknown schedule policy");
+            return true;
+        }
+        m_pool->setSchedulePolicy(static_cast<SchedulePolicy>(policy));
+        return true;
+    }
+    case SetThreadRange: {
+        if (frame.size != 8) return false;
+        quint32 minNum = read<quint32>(frame.payload, 0);
+        quint32 maxNum = read<quint32>(frame.payload, 4);
+        if (minNum > maxNum || maxNum == 0 || maxNum > 4096) {
+            sendError(client, InvalidArgument, "invalid thread range");
+            return true;
+        }
+        m_pool->setThreadRange(int(minNum), int(maxNum));
+        return true;
+    }
+    case SubscribeStatus:
+        if (frame.size != 1) return false;
+        client->statusSubscribed = frame.payload[0] != 0;
+        return true;
+    default:
+        sendError(client, UnknownMessage, "unknown message type");
+        return true;
+    }
+}
+
+bool ControlServer::handleSubmit(Client* client, const Frame& frame)
+{
+    if (frame.size < SUBMIT_HEADER_SIZE) return false;
+    quint32 requestId = read<quint32>(frame.payload, 0);
+    quint32 count = read<quint32>(frame.payload, 4);
+    if (count == 0 || count > quint32(MAX_BATCH_TASKS)
+        || frame.size != SUBMIT_HEADER_SIZE + int(count) * WIRE_TASK_SIZE) {
+        return false;
+    }
+
+    // 整批分配连续ID、一次addTasks()入队：每批只加一次线程池锁
+    int firstId = m_pool->allocateTaskIds(int(count));
+    int arrivalMs = QTime::currentTime().msecsSinceStartOfDay();
+    std::vector<Task> tasks(count);
+    const uchar* entry = frame.payload + SUBMIT_HEADER_SIZE;
+    for (quint32 i = 0; i < count; ++i, entry += WIRE_TASK_SIZE) {
+        Task& task = tasks[i];
+        task.id = firstId + int(i);
+        task.totalTimeMs = int(qMin<quint32>(read<quint32>(entry, 0), 3600 * 1000));
+        task.priority = read<qint32>(entry, 4);
+        task.memSize = read<quint32>(entry, 8);
+        task.memPtr = task.memSize > 0 ? m_pool->allocatePayload(task.memSize) : nullptr;
+        task.arrivalTimestampMs = arrivalMs;
+    }
+    m_pool->addTasks(std::move(tasks));
+
+    Batch batch;
+    batch.lastId = firstId + int(count) - 1;
+    batch.remaining = int(count);
+    batch.client = client;
+    m_batches.emplace(firstId, batch);
+    m_batchCount.fetch_add(1, std::memory_order_relaxed);
+    m_taskCount.fetch_add(count, std::memory_order_relaxed);
+
+    int start = beginFrame(client->output, SubmitAck);
+    append<quint32>(client->output, requestId);
+    append<qint32>(client->output, firstId);
+    append<quint32>(client->output, count);
+    endFrame(client->output, start);
+    return true;
+}
+
+void ControlServer::sendError(Client* client, ErrorCode code, const char* message)
+{
+    int start = beginFrame(client->output, Error);
+    append<quint8>(client->output, code);
+    client->output.append(message);
+    endFrame(client->output, start);
+}
+
+void ControlServer::drainEvents()
+{
+    PoolEvent event;
+    while (m_subscription->pop(event)) {
+        if (event.type != PoolEventType::TaskFinished) continue;
+        auto it = m_batches.upper_bound(event.taskId);
+        if (it == m_batches.begin()) continue;      // 不是控制面提交的任务
+        --it;
+        Batch& batch = it->second;
+        if (event.taskId > batch.lastId) continue;
+        if (Client* client = batch.client) {
+            append<qint32>(client->finished, event.taskId);
+            append<quint32>(client->finished, quint32(qMax(0, event.wallTimeUs)));
+            append<quint32>(client->finished, quint32(qMax(0, event.cpuTimeUs)));
+            client->finishedCount++;
+        }
+        if (--batch.remaining == 0) m_batches.erase(it);
+    }
+    // 事件队列溢出：丢掉的完成事件找不回来，通知所有客户端
+    if (m_subscription->takeOverflowed()) {
+        m_lostCount.fetch_add(1, std::memory_order_relaxed);
+        for (Client& client : m_clients) {
+            int start = beginFrame(client.output, NotificationsLost);
+            append<quint64>(client.output, 1);
+            endFrame(client.output, start);
+        }
+        POOL_LOG_WARNING("[控制面]事件队列溢出，部分完成通知丢失");
+        if (!m_batches.empty()) m_staleUpToId = m_batches.rbegin()->first;
+    }
+    pruneBatches();
+    for (Client& client : m_clients) {
+        if (client.finishedCount > 0) {
+            int start = beginFrame(client.output, TasksFinished);
+            append<quint32>(client.output, quint32(client.finishedCount));
+            client.output.append(client.finished);
+            endFrame(client.output, start);
+            m_notifiedCount.fetch_add(client.finishedCount, std::memory_order_relaxed);
+            client.finished.clear();
+            client.finishedCount = 0;
+        }
+        flush(&client);
+    }
+}
+
+void ControlServer::pruneBatches()
+{
+    if (m_staleUpToId < 0) return;
+    // 要遍历线程池的队列，限制频率
+    if (m_pruneTimer.isValid() && m_pruneTimer.elapsed() < LocalSocketCommunication::BATCH_PRUNE_INTERVAL_MS) return;
+    m_pruneTimer.start();
+    // 批次的ID区间互不相交，按firstId排序也就按lastId排序：从头删到第一个还有未完成任务的批次
+    int oldest = m_pool->getOldestPendingTaskId();
+    while (!m_batches.empty() && m_batches.begin()->second.lastId < oldest) {
+        m_batches.erase(m_batches.begin());
+    }
+    // 溢出前的批次都已清掉（或正常完成），不用再查
+    if (m_batches.empty() || m_batches.begin()->first > m_staleUpToId) {
+        m_staleUpToId = -1;
+        m_pruneTimer.invalidate();
+    }
+}
+
+void ControlServer::flush(Client* client)
+{
+    if (client->output.isEmpty()) return;
+    client->socket->write(client->output);
+    client->output.clear();
+    if (client->socket->bytesToWrite() > LocalSocketCommunication::MAX_PENDING_WRITE_BYTES) {
+        // 客户端长期不读，断开而不是无限缓存；排队执行，避免在遍历m_clients时触发disconnected
+        POOL_LOG_WARNING("[控制面]客户端接收过慢，断开连接");
+        QMetaObject::invokeMethod(client->socket, &QLocalSocket::abort, Qt::QueuedConnection);
+    }
+}
+
+void ControlServer::broadcastStatus(const QJsonObject& status)
+{
+    QByteArray payload;
+    for (Client& client : m_clients) {
+        if (!client.statusSubscribed) continue;
+        if (payload.isEmpty()) payload = QCborValue(QCborMap::fromJsonObject(status)).toCbor();
+        int start = beginFrame(client.output, StatusReport);
+        client.output.append(payload);
+        endFrame(client.output, start);
+        flush(&client);
+    }
+}
+
+QJsonObject ControlServer::stats() const
+{
+    QJsonObject stats;
+    stats["clients"] = m_clientCount.load(std::memory_order_relaxed);
+    stats["batches"] = static_cast<qint64>(m_batchCount.load(std::memory_order_relaxed));
+    stats["tasks"] = static_cast<qint64>(m_taskCount.load(std::memory_order_relaxed));
+    stats["notifiedTasks"] = static_cast<qint64>(m_notifiedCount.load(std::memory_order_relaxed));
+    stats["notificationOverflows"] = static_cast<qint64>(m_lostCount.load(std::memory_order_relaxed));
+    return stats;
+}
+
+LocalSocketCommunication::LocalSocketCommunication(ThreadPool* pool, const QString& serverName)
+{
+    m_server = new ControlServer(pool, serverName);
+    m_server->moveToThread(&m_thread);
+    QObject::connect(&m_thread, &QThread::started, m_server, [server = m_server]() { server->start(); });
+    m_thread.start();
+}
+
+LocalSocketCommunication::~LocalSocketCommunication()
+{
+    QMetaObject::invokeMethod(m_server, [server = m_server]() { server->shutdown(); }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_server;
+}
+
+bool LocalSocketCommunication::send(const QJsonObject& data)
+{
+    QMetaObject::invokeMethod(m_server, [server = m_server, data]() { server->broadcastStatus(data); }, Qt::QueuedConnection);
+    return true;
+}
+
+QJsonObject LocalSocketCommunication::receive()
+{
+    return m_server->stats();
+}
@@ -0,0 +1,43 @@
+#ifndef LOCALSOCKETCOMMUNICATION_H
+#define LOCALSOCKETCOMMUNICATION_H
+
+#include "ICommunication.h"
+#include "controlprotocol.h"
+#include <QString>
+#include <QThread>
+#include <memory>
+
+class ThreadPool;
+class ControlServer;
+
+/*
+ * 本地套接字控制面（QLocalServer，帧格式见controlprotocol.h）
+ * 1. 外部生产者按批提交任务，收到SubmitAck（分配的任务ID区间）和之后的TasksFinished完成通知；
+ *    也可以运行中切换调度策略、调整最小/最大线程数、订阅状态上报。
+ * 2. 服务端有自己的线程和事件循环：解帧、构造Task、addTasks()整批入队都不经过UI线程。
+ *    完成通知来自线程池的事件流（subscribeEvents），每DRAIN_INTERVAL_MS排空一次，按客户端合并成一帧发出。
+ *    事件队列溢出后，丢过完成事件的批次按线程池最早未完成的任务ID清理（每BATCH_PRUNE_INTERVAL_MS一次），批次表不会只增不减。
+ * 3. 作为状态上报输出挂到线程池上（addStatusSink）：send()把状态转给订阅了的客户端，
+ *    receive()返回控制面自身的统计（连接数、收到的批次和任务数、发出的通知数）。
+ * 4. 线程池析构时最先销毁状态输出，所以服务线程停止之后线程池才会关闭。
+ */
+class LocalSocketCommunication : public ICommunication
+{
+public:
+    static const int DRAIN_INTERVAL_MS = 2;
+    static const size_t EVENT_QUEUE_CAPACITY = 1 << 17;
+    static const qint64 MAX_PENDING_WRITE_BYTES = 64 * 1024 * 1024;    // 客户端不读数据时断开
+    static const int BATCH_PRUNE_INTERVAL_MS = 100;     // 事件队列溢出后，清理已完成批次的间隔
+
+    LocalSocketCommunication(ThreadPool* pool, const QString& serverName = ControlProtocol::DEFAULT_SERVER_NAME);
+    ~LocalSocketCommunication() override;
+
+    bool send(const QJsonObject& data) override;
+    QJsonObject receive() override;
+
+private:
+    QThread m_thread;
+    ControlServer* m_server = nullptr;     // 属于m_thread，线程结束后在析构函数里删除
+};
+
+#endif // LOCALSOCKETCOMMUNICATION_H
@@ -0,0 +1,193 @@
+#include "prometheusendpoint.h"
+#include "../threadpool.h"
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <atomic>
+
+// HTTP服务本体，运行在PrometheusEndpoint::m_thread里
+class MetricsHttpServer : public QObject
+{
+public:
+    MetricsHttpServer(ThreadPool* pool, quint16 port) : m_pool(pool), m_port(port) {}
+
+    void start();
+    void shutdown();
+    quint64 scrapeCount() const { return m_scrapes.load(std::memory_order_relaxed); }
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    void reply(QTcpSocket* socket, const char* status, const QByteArray& contentType, const QByteArray& body);
+
+    ThreadPool* m_pool;
+    const quint16 m_port;
+    QTcpServer* m_server = nullptr;
+    std::atomic<quint64> m_scrapes{0};
+};
+
+void MetricsHttpServer::start()
+{
+    m_server = new QTcpServer(this);
+    if (!m_server->listen(QHostAddress::LocalHost, m_port)) {
+        POOL_LOG_WARNING("[指标]监听端口失败，/metrics不可用");
+        return;
+    }
+    QObject::connect(m_server, &QTcpServer::newConnection, this, [this]() { onNewConnection(); });
+    POOL_LOG_INFO("[指标]Prometheus端点已启动: http://127.0.0.1:%1/metrics", m_server->serverPort());
+}
+
+void MetricsHttpServer::shutdown()
+{
+    if (m_server) m_server->close();
+}
+
+void MetricsHttpServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        socket->setParent(this);
+        QObject::connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MetricsHttpServer::onReadyRead(QTcpSocket* socket)
+{
+    // 请求头收全之前先留在socket缓冲区里
+    QByteArray head = socket->peek(PrometheusEndpoint::MAX_REQUEST_BYTES);
+    if (head.indexOf("\r\n\r\n") < 0) {
+        if (head.size() >= PrometheusEndpoint::MAX_REQUEST_BYTES) {
+            reply(socket, "431 Request Header Fields Too Large", "text/plain", "request too large\n");
+        }
+        return;
+    }
+    socket->readAll();
+
+    // 请求行：METHOD SP PATH SP VERSION
+    QList<QByteArray> requestLine = head.left(head.indexOf("\r\n")).split(' ');
+    if (requestLine.size() != 3) {
+        reply(socket, "400 Bad Request", "text/plain", "bad request\n");
+        return;
+    }
+    const QByteArray& method = requestLine[0];
+    QByteArray path = requestLine[1];
+    int query = path.indexOf('?');
+    if (query >= 0) path = path.left(query);
+    if (method != "GET" && method != "HEAD") {
+        reply(socket, "405 Method Not Allowed", "text/plain", "only GET is supported\n");
+        return;
+    }
+    if (path != "/metrics") {
+        reply(socket, "404 Not Found", "text/plain", "try /metrics\n");
+        return;
+    }
+    m_scrapes.fetch_add(1, std::memory_order_relaxed);
+    QByteArray body = PrometheusEndpoint::render(m_pool->getCounters());
+    if (method == "HEAD") body.clear();
+    reply(socket, "200 OK", "text/plain; version=0.0.4; charset=utf-8", body);
+}
+
+void MetricsHttpServer::reply(QTcpSocket* socket, const char* status, const QByteArray& contentType, const QByteArray& body)
+{
+    QByteArray response;
+    response.reserve(body.size() + 128);
+    response.append("HTTP/1.1 ").append(status).append("\r\n");
+    response.append("Content-Type: ").append(contentType).append("\r\n");
+    response.append("Content-Length: ").append(QByteArray::number(body.size())).append("\r\n");
+    response.append("Connection: close\r\n\r\n");
+    response.append(body);
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+namespace {
+
+void appendHeader(QByteArray& out, const char* name, const char* type, const char* help)
+{
+    out.append("# HELP ").append(name).append(' ').append(help).append('\n');
+    out.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+}
+
+void appendSample(QByteArray& out, const char* name, qint64 value)
+{
+    out.append(name).append(' ').append(QByteArray::number(value)).append('\n');
+}
+
+void appendHistogram(QByteArray& out, const char* name, const char* help, const LatencyHistogram& histogram)
+{
+    appendHeader(out, name, "histogram", help);
+    // 各桶分别读取后再累加，保证le递增时计数单调不减，_count与+Inf桶一致
+    quint64 cumulative = 0;
+    for (int i = 0; i <= LatencyHistogram::BUCKETS; ++i) {
+        cumulative += histogram.bucketCount(i);
+        out.append(name).append("_bucket{le=\"");
+        if (i < LatencyHistogram::BUCKETS) out.append(QByteArray::number(LatencyHistogram::BOUNDS[i], 'g', 6));
+        else out.append("+Inf");
+        out.append("\"} ").append(QByteArray::number(qint64(cumulative))).append('\n');
+    }
+    out.append(name).append("_sum ").append(QByteArray::number(histogram.sumSeconds(), 'g', 12)).append('\n');
+    out.append(name).append("_count ").append(QByteArray::number(qint64(cumulative))).append('\n');
+}
+
+} // namespace
+
+QByteArray PrometheusEndpoint::render(const PoolCounters& counters)
+{
+    QByteArray out;
+    out.reserve(4096);
+
+    appendHeader(out, "threadpool_tasks_submitted_total", "counter", "Tasks accepted into the queue.");
+    appendSample(out, "threadpool_tasks_submitted_total", qint64(counters.submitted.load(std::memory_order_relaxed)));
+    appendHeader(out, "threadpool_tasks_finished_total", "counter", "Tasks that finished executing.");
+    appendSample(out, "threadpool_tasks_finished_total", qint64(counters.finished.load(std::memory_order_relaxed)));
+    appendHeader(out, "threadpool_tasks_cancelled_total", "counter", "Tasks discarded without running (submitted after or queued at shutdown).");
+    appendSample(out, "threadpool_tasks_cancelled_total", qint64(counters.cancelled.load(std::memory_order_relaxed)));
+
+    appendHeader(out, "threadpool_threads_alive", "gauge", "Worker threads currently alive.");
+    appendSample(out, "threadpool_threads_alive", counters.aliveThreads.load(std::memory_order_relaxed));
+    appendHeader(out, "threadpool_threads_busy", "gauge", "Worker threads currently executing a task.");
+    appendSample(out, "threadpool_threads_busy", counters.busyThreads.load(std::memory_order_relaxed));
+
+    // 每种策略一条序列，当前策略为队列长度，其余为0，切换策略时序列不会消失
+    appendHeader(out, "threadpool_queue_depth", "gauge", "Tasks waiting in the queue, labelled by the active schedule policy.");
+    int activePolicy = counters.policy.load(std::memory_order_relaxed);
+    int queued = qMax(0, counters.queuedTasks.load(std::memory_order_relaxed));
+    for (int policy = int(SchedulePolicy::FIFO); policy <= int(SchedulePolicy::HRRN); ++policy) {
+        out.append("threadpool_queue_depth{policy=\"").append(schedulePolicyName(static_cast<SchedulePolicy>(policy)));
+        out.append("\"} ").append(QByteArray::number(policy == activePolicy ? queued : 0)).append('\n');
+    }
+
+    appendHistogram(out, "threadpool_task_wait_seconds", "Time from arrival to dispatch.", counters.waitTime);
+    appendHistogram(out, "threadpool_task_run_seconds", "Wall-clock execution time.", counters.runTime);
+    appendHistogram(out, "threadpool_task_latency_seconds", "Time from arrival to completion.", counters.latency);
+    return out;
+}
+
+PrometheusEndpoint::PrometheusEndpoint(ThreadPool* pool, quint16 port)
+{
+    m_server = new MetricsHttpServer(pool, port);
+    m_server->moveToThread(&m_thread);
+    QObject::connect(&m_thread, &QThread::started, m_server, [server = m_server]() { server->start(); });
+    m_thread.start();
+}
+
+PrometheusEndpoint::~PrometheusEndpoint()
+{
+    QMetaObject::invokeMethod(m_server, [server = m_server]() { server->shutdown(); }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_server;
+}
+
+bool PrometheusEndpoint::send(const QJsonObject& data)
+{
+    Q_UNUSED(data);
+    return true;
+}
+
+QJsonObject PrometheusEndpoint::receive()
+{
+    QJsonObject stats;
+    stats["scrapes"] = static_cast<qint64>(m_server->scrapeCount());
+    return stats;
+}
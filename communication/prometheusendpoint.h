@@ -0,0 +1,40 @@
+#ifndef PROMETHEUSENDPOINT_H
+#define PROMETHEUSENDPOINT_H
+
+#include "ICommunication.h"
+#include <QByteArray>
+#include <QThread>
+
+class ThreadPool;
+class PoolCounters;
+class MetricsHttpServer;
+
+/*
+ * 内置的最小HTTP服务，GET /metrics 按Prometheus文本格式输出线程池指标
+ * 1. 只监听本机地址，有自己的线程和事件循环，不经过UI线程。
+ * 2. 内容全部来自ThreadPool::getCounters()的原子计数器，渲染时不加线程池的锁，抓取不会阻塞工作线程。
+ * 3. 作为状态上报输出挂到线程池上（addStatusSink），生命周期跟随线程池；send()不需要做事，
+ *    receive()返回被抓取的次数。
+ * 4. 每个连接只处理一个请求，回复后关闭（Connection: close）。
+ */
+class PrometheusEndpoint : public ICommunication
+{
+public:
+    static const quint16 DEFAULT_PORT = 9464;
+    static const int MAX_REQUEST_BYTES = 8192;
+
+    PrometheusEndpoint(ThreadPool* pool, quint16 port = DEFAULT_PORT);
+    ~PrometheusEndpoint() override;
+
+    bool send(const QJsonObject& data) override;
+    QJsonObject receive() override;
+
+    // 把计数器渲染成Prometheus文本格式（text/plain; version=0.0.4）
+    static QByteArray render(const PoolCounters& counters);
+
+private:
+    QThread m_thread;
+    MetricsHttpServer* m_server = nullptr;     // 属于m_thread，线程结束后在析构函数里删除
+};
+
+#endif // PROMETHEUSENDPOINT_H
@@ -0,0 +1,138 @@
+#include "sharedmemorycommunication.h"
+#include "../poollog.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QtGlobal>
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+SharedMemoryCommunication::SharedMemoryCommunication(const QString& name)
+    : m_name(name)
+{
+#if defined(Q_OS_UNIX)
+    QByteArray shmName = m_name.toLocal8Bit();
+    int fd = shm_open(shmName.constData(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        POOL_LOG_WARNING("[共享内存]shm_open失败(errno=%1)，状态段不可用", errno);
+        return;
+    }
+    if (ftruncate(fd, sizeof(ShmStatus::Segment)) != 0) {
+        POOL_LOG_WARNING("[共享内存]ftruncate失败(errno=%1)，状态段不可用", errno);
+        close(fd);
+        return;
+    }
+    void* address = mmap(nullptr, sizeof(ShmStatus::Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        POOL_LOG_WARNING("[共享内存]mmap失败(errno=%1)，状态段不可用", errno);
+        return;
+    }
+    m_segment = static_cast<ShmStatus::Segment*>(address);
+
+    // 上一个写者可能异常退出过：先让读者认为段无效，再重新初始化
+    m_segment->magic.store(0, std::memory_order_relaxed);
+    m_segment->version = ShmStatus::VERSION;
+    m_segment->maxThreads = ShmStatus::MAX_THREADS;
+    m_segment->maxActiveTasks = ShmStatus::MAX_ACTIVE_TASKS;
+    // 写者在写到一半时崩溃会留下奇数seq，先补成偶数
+    uint64_t seq = m_segment->seq.load(std::memory_order_relaxed);
+    if (seq & 1) m_segment->seq.store(seq + 1, std::memory_order_relaxed);
+    beginWrite();
+    m_segment->counters = ShmStatus::Counters();
+    m_segment->counters.writerPid = int32_t(getpid());
+    endWrite();
+    m_segment->magic.store(ShmStatus::MAGIC, std::memory_order_release);
+#else
+    POOL_LOG_WARNING("[共享内存]当前平台不支持共享内存状态段");
+#endif
+}
+
+SharedMemoryCommunication::~SharedMemoryCommunication()
+{
+#if defined(Q_OS_UNIX)
+    if (!m_segment) return;
+    beginWrite();
+    m_segment->counters.writerPid = 0;
+    endWrite();
+    munmap(m_segment, sizeof(ShmStatus::Segment));
+    shm_unlink(m_name.toLocal8Bit().constData());
+#endif
+}
+
+void SharedMemoryCommunication::beginWrite()
+{
+    uint64_t seq = m_segment->seq.load(std::memory_order_relaxed);
+    m_segment->seq.store(seq + 1, std::memory_order_relaxed);
+    // 之后的数据写入不能排到seq变奇数之前
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SharedMemoryCommunication::endWrite()
+{
+    uint64_t seq = m_segment->seq.load(std::memory_order_relaxed);
+    m_segment->seq.store(seq + 1, std::memory_order_release);
+}
+
+bool SharedMemoryCommunication::send(const QJsonObject& data)
+{
+    m_last = data;
+    if (!m_segment) return false;
+
+    // 先在本地拼好计数器，临界区内只做拷贝
+    ShmStatus::Counters counters;
+    counters.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    counters.updateCount = ++m_updateCount;
+    counters.writerPid = m_segment->counters.writerPid;
+    counters.policy = data["policy"].toInt();
+    counters.aliveThreads = data["aliveThreads"].toInt();
+    counters.busyThreads = data["busyThreads"].toInt();
+    counters.waitingTasks = data["waitingTasks"].toInt();
+    counters.finishedTasks = data["finishedTasks"].toInt();
+    counters.submittedTasks = data["submittedTasks"].toInteger();
+    counters.memoryBudget = data["memoryBudget"].toInteger();
+    counters.memoryReserved = data["memoryReserved"].toInteger();
+    counters.cpuTimeMs = data["cpuTimeMs"].toInteger();
+    counters.taskCpuEfficiency = data["taskCpuEfficiency"].toDouble();
+
+    QJsonArray workers = data["workers"].toArray();
+    QJsonArray activeTasks = data["activeTasks"].toArray();
+    counters.threadCount = int32_t(qMin<qsizetype>(workers.size(), ShmStatus::MAX_THREADS));
+    counters.activeTaskCount = int32_t(qMin<qsizetype>(activeTasks.size(), ShmStatus::MAX_ACTIVE_TASKS));
+    counters.truncated = (counters.threadCount < workers.size() || counters.activeTaskCount < activeTasks.size()) ? 1 : 0;
+    counters.reserved = 0;
+
+    m_threads.resize(counters.threadCount);
+    for (int i = 0; i < counters.threadCount; ++i) {
+        QJsonObject worker = workers[i].toObject();
+        ShmStatus::ThreadEntry& entry = m_threads[i];
+        entry.id = worker["id"].toInt();
+        entry.state = worker["state"].toInt();
+        entry.curTaskId = worker["curTaskId"].toInt(-1);
+        entry.reserved = 0;
+        entry.cpuTimeMs = worker["cpuTimeMs"].toInteger();
+        entry.busyTimeMs = worker["busyTimeMs"].toInteger();
+        entry.voluntarySwitches = worker["voluntarySwitches"].toInteger();
+        entry.involuntarySwitches = worker["involuntarySwitches"].toInteger();
+    }
+    m_activeTasks.resize(counters.activeTaskCount);
+    for (int i = 0; i < counters.activeTaskCount; ++i) {
+        QJsonObject task = activeTasks[i].toObject();
+        ShmStatus::ActiveTask& entry = m_activeTasks[i];
+        entry.id = task["id"].toInt();
+        entry.threadId = task["threadId"].toInt(-1);
+        entry.memSize = task["memSize"].toInteger();
+    }
+
+    beginWrite();
+    m_segment->counters = counters;
+    memcpy(m_segment->threads, m_threads.data(), m_threads.size() * sizeof(ShmStatus::ThreadEntry));
+    memcpy(m_segment->activeTasks, m_activeTasks.data(), m_activeTasks.size() * sizeof(ShmStatus::ActiveTask));
+    endWrite();
+    return true;
+}
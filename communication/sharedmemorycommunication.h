@@ -0,0 +1,40 @@
+#ifndef SHAREDMEMORYCOMMUNICATION_H
+#define SHAREDMEMORYCOMMUNICATION_H
+
+#include "ICommunication.h"
+#include "shmstatus.h"
+#include <QString>
+#include <vector>
+
+/*
+ * 把autoReportStatus()的状态写进POSIX共享内存段（布局见shmstatus.h）
+ * 1. 外部监控程序映射同一个段直接读，不再有写文件和解析JSON的开销。
+ * 2. send()由线程池所在的线程调用，单写者；读者用seqlock，从不阻塞写者。
+ * 3. 析构时把writerPid清零并shm_unlink，已经映射的读者能看到写者已退出。
+ * 4. 只支持有shm_open的平台（Linux/macOS），其他平台isOpen()为false，send()什么都不做。
+ */
+class SharedMemoryCommunication : public ICommunication
+{
+public:
+    explicit SharedMemoryCommunication(const QString& name = ShmStatus::DEFAULT_NAME);
+    ~SharedMemoryCommunication() override;
+
+    bool isOpen() const { return m_segment != nullptr; }
+    bool send(const QJsonObject& data) override;
+    // 共享内存是给外部进程读的，这里返回最近一次send()的对象
+    QJsonObject receive() override { return m_last; }
+
+private:
+    void beginWrite();
+    void endWrite();
+
+    const QString m_name;
+    ShmStatus::Segment* m_segment = nullptr;
+    QJsonObject m_last;
+    int64_t m_updateCount = 0;
+    // 每次send()先转换到这里，写共享内存时只做memcpy
+    std::vector<ShmStatus::ThreadEntry> m_threads;
+    std::vector<ShmStatus::ActiveTask> m_activeTasks;
+};
+
+#endif // SHAREDMEMORYCOMMUNICATION_H
@@ -0,0 +1,86 @@
+#ifndef SHMSTATUS_H
+#define SHMSTATUS_H
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * 共享内存状态段的二进制布局（SharedMemoryCommunication写、ShmStatusReader读）
+ * 1. 只用定长POD和std::atomic，不依赖Qt，外部监控程序只需包含本头文件和shmstatusreader。
+ * 2. 一个写者，任意多个读者，用seqlock同步：
+ *    写者：seq+1(变奇数) -> release屏障 -> 写数据 -> seq+1(变偶数，release)
+ *    读者：读seq(acquire)，是奇数就重试 -> 拷贝数据 -> acquire屏障 -> 再读seq，不相等就重试
+ *    读者从不写共享内存，也不会阻塞写者；写者每次更新只多两次原子写。
+ * 3. magic最后写入（release），读者看到正确的magic后，maxThreads等几何信息才有效。
+ * 4. 超出容量的线程/活跃任务不写入，threadCount/activeTaskCount是实际写入的条数，
+ *    truncated标记本次是否有截断。
+ */
+
+namespace ShmStatus {
+
+const uint32_t MAGIC = 0x4D535054;          // "TPSM"
+const uint16_t VERSION = 1;
+const uint32_t MAX_THREADS = 256;
+const uint32_t MAX_ACTIVE_TASKS = 256;
+const char DEFAULT_NAME[] = "/threadpool_status";
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock需要无锁的64位原子量");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "magic需要无锁的32位原子量");
+
+// 计数器部分（受seq保护）
+struct Counters
+{
+    int64_t timestampMs;        // 写入时间，Unix纪元毫秒
+    int64_t updateCount;        // 第几次更新
+    int32_t writerPid;          // 写者进程号，写者关闭时置0
+    int32_t policy;             // SchedulePolicy
+    int32_t aliveThreads;
+    int32_t busyThreads;
+    int32_t waitingTasks;
+    int32_t finishedTasks;
+    int64_t submittedTasks;
+    int64_t memoryBudget;
+    int64_t memoryReserved;
+    int64_t cpuTimeMs;
+    double taskCpuEfficiency;
+    int32_t threadCount;        // threads[]中有效条数
+    int32_t activeTaskCount;    // activeTasks[]中有效条数
+    int32_t truncated;          // 1表示有线程或任务因容量不足没有写入
+    int32_t reserved;
+};
+
+struct ThreadEntry
+{
+    int32_t id;
+    int32_t state;              // ThreadState：0空闲 1忙碌
+    int32_t curTaskId;          // 空闲时为-1
+    int32_t reserved;
+    int64_t cpuTimeMs;
+    int64_t busyTimeMs;
+    int64_t voluntarySwitches;
+    int64_t involuntarySwitches;
+};
+
+struct ActiveTask
+{
+    int32_t id;
+    int32_t threadId;
+    int64_t memSize;
+};
+
+struct Segment
+{
+    std::atomic<uint32_t> magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t maxThreads;
+    uint32_t maxActiveTasks;
+    std::atomic<uint64_t> seq;
+    Counters counters;
+    ThreadEntry threads[MAX_THREADS];
+    ActiveTask activeTasks[MAX_ACTIVE_TASKS];
+};
+
+} // namespace ShmStatus
+
+#endif // SHMSTATUS_H
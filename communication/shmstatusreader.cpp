@@ -0,0 +1,100 @@
+#include "shmstatusreader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define SHM_STATUS_POSIX 1
+#endif
+
+ShmStatusReader::~ShmStatusReader()
+{
+    close();
+}
+
+bool ShmStatusReader::open(const std::string& name)
+{
+    close();
+#if defined(SHM_STATUS_POSIX)
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        m_error = "shm_open " + name + ": " + strerror(errno);
+        return false;
+    }
+    void* address = mmap(nullptr, sizeof(ShmStatus::Segment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        m_error = "mmap " + name + ": " + strerror(errno);
+        return false;
+    }
+    const auto* segment = static_cast<const ShmStatus::Segment*>(address);
+    if (segment->magic.load(std::memory_order_acquire) != ShmStatus::MAGIC
+        || segment->version != ShmStatus::VERSION
+        || segment->maxThreads != ShmStatus::MAX_THREADS
+        || segment->maxActiveTasks != ShmStatus::MAX_ACTIVE_TASKS) {
+        munmap(address, sizeof(ShmStatus::Segment));
+        m_error = "段未初始化或版本不匹配: " + name;
+        return false;
+    }
+    m_segment = segment;
+    m_error.clear();
+    return true;
+#else
+    m_error = "当前平台不支持POSIX共享内存";
+    return false;
+#endif
+}
+
+void ShmStatusReader::close()
+{
+#if defined(SHM_STATUS_POSIX)
+    if (m_segment) munmap(const_cast<ShmStatus::Segment*>(m_segment), sizeof(ShmStatus::Segment));
+#endif
+    m_segment = nullptr;
+}
+
+bool ShmStatusReader::read(ShmStatusSnapshot& snapshot, int maxRetries)
+{
+    if (!m_segment) return false;
+    for (int attempt = 0; attempt < maxRetries; ++attempt) {
+        uint64_t begin = m_segment->seq.load(std::memory_order_acquire);
+        if (begin & 1) {
+            // 写者正在写，让出CPU后重试
+            std::this_thread::yield();
+            continue;
+        }
+        // 拷贝期间写者可能改写数据，拷出来的值只有在seq前后一致时才采用
+        ShmStatus::Counters counters;
+        memcpy(&counters, &m_segment->counters, sizeof(counters));
+        int threadCount = std::clamp<int>(counters.threadCount, 0, ShmStatus::MAX_THREADS);
+        int taskCount = std::clamp<int>(counters.activeTaskCount, 0, ShmStatus::MAX_ACTIVE_TASKS);
+        snapshot.threads.resize(threadCount);
+        snapshot.activeTasks.resize(taskCount);
+        memcpy(snapshot.threads.data(), m_segment->threads, threadCount * sizeof(ShmStatus::ThreadEntry));
+        memcpy(snapshot.activeTasks.data(), m_segment->activeTasks, taskCount * sizeof(ShmStatus::ActiveTask));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t end = m_segment->seq.load(std::memory_order_relaxed);
+        if (begin == end) {
+            snapshot.seq = begin;
+            snapshot.counters = counters;
+            return true;
+        }
+    }
+    m_error = "读取重试次数过多（写者一直在写？）";
+    return false;
+}
+
+bool ShmStatusReader::writerAlive(const ShmStatusSnapshot& snapshot)
+{
+    if (snapshot.counters.writerPid <= 0) return false;
+#if defined(SHM_STATUS_POSIX)
+    return kill(pid_t(snapshot.counters.writerPid), 0) == 0 || errno == EPERM;
+#else
+    return true;
+#endif
+}
@@ -0,0 +1,47 @@
+#ifndef SHMSTATUSREADER_H
+#define SHMSTATUSREADER_H
+
+#include "shmstatus.h"
+#include <string>
+#include <vector>
+
+/*
+ * 共享内存状态段的读取端（不依赖Qt，外部监控程序可以直接拿去用）
+ * 1. open()只读映射段；写者还没创建段时返回false，可以稍后重试。
+ * 2. read()按seqlock协议拷贝一份一致的快照，写者正在写时自旋重试，超过maxRetries次返回false。
+ * 3. 写者重启后会重建同名段：writerAlive()为false或数据长时间不更新时，close()再open()即可。
+ */
+
+struct ShmStatusSnapshot
+{
+    uint64_t seq = 0;
+    ShmStatus::Counters counters = {};
+    std::vector<ShmStatus::ThreadEntry> threads;
+    std::vector<ShmStatus::ActiveTask> activeTasks;
+};
+
+class ShmStatusReader
+{
+public:
+    static const int DEFAULT_MAX_RETRIES = 1000;
+
+    ShmStatusReader() = default;
+    ~ShmStatusReader();
+    ShmStatusReader(const ShmStatusReader&) = delete;
+    ShmStatusReader& operator=(const ShmStatusReader&) = delete;
+
+    bool open(const std::string& name = ShmStatus::DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return m_segment != nullptr; }
+    const std::string& errorString() const { return m_error; }
+
+    bool read(ShmStatusSnapshot& snapshot, int maxRetries = DEFAULT_MAX_RETRIES);
+    // 写者进程是否还在（按快照里的writerPid检查）
+    static bool writerAlive(const ShmStatusSnapshot& snapshot);
+
+private:
+    const ShmStatus::Segment* m_segment = nullptr;
+    std::string m_error;
+};
+
+#endif // SHMSTATUSREADER_H
@@ -0,0 +1,45 @@
+#ifndef TELEMETRYFORMAT_H
+#define TELEMETRYFORMAT_H
+
+#include <QJsonObject>
+#include <QString>
+
+/*
+ * 遥测流的文件格式（TelemetrySink写、TelemetryReader读）
+ * 两种格式都只追加，进程崩溃时最多丢掉最后一条不完整的记录：
+ * 1. Binary：文件头 "TPTM" + 版本号1字节；之后每条记录为
+ *    [u32 长度(小端，不含自身)][i64 时间戳ms(小端)][CBOR编码的状态对象]。
+ * 2. JsonLines：每行一个紧凑JSON对象，时间戳放在"timestamp"字段（毫秒，Unix纪元）。
+ */
+
+enum class TelemetryFormat
+{
+    Binary,
+    JsonLines
+};
+
+struct TelemetryRecord
+{
+    qint64 timestampMs = 0;
+    QJsonObject data;
+};
+
+namespace TelemetryFile {
+    const char MAGIC[4] = {'T', 'P', 'T', 'M'};
+    const quint8 VERSION = 1;
+    const int HEADER_SIZE = 5;
+    const int RECORD_HEADER_SIZE = 4 + 8;
+    const quint32 MAX_RECORD_BYTES = 16 * 1024 * 1024;     // 读取时超过视为损坏
+    const char TIMESTAMP_KEY[] = "timestamp";
+
+    // 按扩展名选格式：.jsonl/.ndjson为JSON行，其余为二进制
+    inline TelemetryFormat formatForPath(const QString& path)
+    {
+        if (path.endsWith(".jsonl", Qt::CaseInsensitive) || path.endsWith(".ndjson", Qt::CaseInsensitive)) {
+            return TelemetryFormat::JsonLines;
+        }
+        return TelemetryFormat::Binary;
+    }
+}
+
+#endif // TELEMETRYFORMAT_H
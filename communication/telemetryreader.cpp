@@ -0,0 +1,88 @@
+#include "telemetryreader.h"
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QtEndian>
+#include <cstring>
+
+TelemetryReader::TelemetryReader(const QString& filePath)
+    : m_file(filePath)
+{
+}
+
+bool TelemetryReader::open()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    QByteArray header = m_file.peek(TelemetryFile::HEADER_SIZE);
+    if (header.size() >= 4 && memcmp(header.constData(), TelemetryFile::MAGIC, 4) == 0) {
+        if (header.size() < TelemetryFile::HEADER_SIZE || quint8(header[4]) != TelemetryFile::VERSION) {
+            m_error = "不支持的遥测文件版本";
+            return false;
+        }
+        m_format = TelemetryFormat::Binary;
+        m_file.seek(TelemetryFile::HEADER_SIZE);
+    } else {
+        m_format = TelemetryFormat::JsonLines;
+    }
+    return true;
+}
+
+bool TelemetryReader::next(TelemetryRecord& record)
+{
+    if (!m_file.isOpen() || !m_error.isEmpty()) return false;
+    return m_format == TelemetryFormat::Binary ? nextBinary(record) : nextJsonLine(record);
+}
+
+bool TelemetryReader::nextBinary(TelemetryRecord& record)
+{
+    qint64 start = m_file.pos();
+    uchar header[TelemetryFile::RECORD_HEADER_SIZE];
+    if (m_file.read(reinterpret_cast<char*>(header), sizeof(header)) != qint64(sizeof(header))) {
+        m_file.seek(start);     // 记录头还没写完整
+        return false;
+    }
+    quint32 length = qFromLittleEndian<quint32>(header);
+    if (length < 8 || length > TelemetryFile::MAX_RECORD_BYTES) {
+        m_error = QString("记录长度异常(%1)，偏移%2").arg(length).arg(start);
+        return false;
+    }
+    QByteArray payload = m_file.read(length - 8);
+    if (payload.size() != qint64(length - 8)) {
+        m_file.seek(start);     // 记录体还没写完整
+        return false;
+    }
+    QCborParserError parseError;
+    QCborValue value = QCborValue::fromCbor(payload, &parseError);
+    if (parseError.error != QCborError::NoError || !value.isMap()) {
+        m_error = QString("CBOR解码失败，偏移%1").arg(start);
+        return false;
+    }
+    record.timestampMs = qFromLittleEndian<qint64>(header + 4);
+    record.data = value.toMap().toJsonObject();
+    return true;
+}
+
+bool TelemetryReader::nextJsonLine(TelemetryRecord& record)
+{
+    while (true) {
+        qint64 start = m_file.pos();
+        QByteArray line = m_file.readLine();
+        if (line.isEmpty()) return false;
+        if (!line.endsWith('\n')) {
+            m_file.seek(start);     // 最后一行还没写完整
+            return false;
+        }
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            m_skipped++;
+            continue;
+        }
+        record.data = doc.object();
+        record.timestampMs = record.data.take(TelemetryFile::TIMESTAMP_KEY).toInteger();
+        return true;
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef TELEMETRYREADER_H
+#define TELEMETRYREADER_H
+
+#include "telemetryformat.h"
+#include <QFile>
+
+/*
+ * 逐条解码TelemetrySink写出的遥测文件
+ * 1. 根据文件头自动识别二进制/JSON行格式，不依赖扩展名。
+ * 2. 可以一边写一边读：读到末尾不完整的记录时next()返回false，之后文件变长了可以继续调用next()。
+ * 3. JSON行里解析失败的行（崩溃留下的半行）跳过并计数。
+ */
+class TelemetryReader
+{
+public:
+    explicit TelemetryReader(const QString& filePath);
+
+    bool open();
+    TelemetryFormat format() const { return m_format; }
+    QString errorString() const { return m_error; }
+    // 读下一条记录，没有完整的记录或文件损坏时返回false（损坏时errorString()非空）
+    bool next(TelemetryRecord& record);
+    // 跳过的损坏行数（只有JSON行格式会有）
+    int skippedCount() const { return m_skipped; }
+
+private:
+    bool nextBinary(TelemetryRecord& record);
+    bool nextJsonLine(TelemetryRecord& record);
+
+    QFile m_file;
+    TelemetryFormat m_format = TelemetryFormat::Binary;
+    QString m_error;
+    int m_skipped = 0;
+};
+
+#endif // TELEMETRYREADER_H
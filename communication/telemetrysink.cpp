@@ -0,0 +1,149 @@
+#include "telemetrysink.h"
+#include "../poollog.h"
+#include <QCborMap>
+#include <QCborValue>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+TelemetrySink::TelemetrySink(const QString& filePath, TelemetryFormat format)
+    : m_filePath(filePath), m_format(format)
+{
+    if (!openFile()) {
+        POOL_LOG_WARNING("[遥测]无法打开遥测文件，状态不会写出");
+        return;
+    }
+    m_writer = std::make_unique<WriterThread>(this);
+    m_writer->start(QThread::LowPriority);
+}
+
+TelemetrySink::~TelemetrySink()
+{
+    if (m_writer) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stopping = true;
+            m_wake.wakeOne();
+        }
+        m_writer->wait();
+    }
+}
+
+bool TelemetrySink::openFile()
+{
+    m_file.setFileName(m_filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) return false;
+
+    if (m_format == TelemetryFormat::JsonLines) {
+        // JSON行格式：读取方会跳过上次崩溃留下的半行
+        return m_file.seek(m_file.size());
+    }
+
+    // 二进制格式：新文件写文件头；已有文件校验文件头，并截掉末尾不完整的记录再续写
+    qint64 size = m_file.size();
+    QByteArray header = m_file.read(TelemetryFile::HEADER_SIZE);
+    bool valid = header.size() == TelemetryFile::HEADER_SIZE
+                 && memcmp(header.constData(), TelemetryFile::MAGIC, 4) == 0
+                 && quint8(header[4]) == TelemetryFile::VERSION;
+    if (!valid) {
+        if (size > 0) POOL_LOG_WARNING("[遥测]遥测文件头无法识别，已清空重写（原有%1字节）", size);
+        m_file.resize(0);
+        m_file.seek(0);
+        m_file.write(TelemetryFile::MAGIC, 4);
+        m_file.write(reinterpret_cast<const char*>(&TelemetryFile::VERSION), 1);
+        return m_file.flush();
+    }
+    qint64 end = TelemetryFile::HEADER_SIZE;
+    while (end + TelemetryFile::RECORD_HEADER_SIZE <= size) {
+        uchar lengthBytes[4];
+        if (!m_file.seek(end) || m_file.read(reinterpret_cast<char*>(lengthBytes), 4) != 4) break;
+        quint32 length = qFromLittleEndian<quint32>(lengthBytes);
+        if (length < 8 || length > TelemetryFile::MAX_RECORD_BYTES || end + 4 + length > size) break;
+        end += 4 + length;
+    }
+    if (end < size) {
+        POOL_LOG_WARNING("[遥测]遥测文件末尾有不完整的记录，截掉%1字节后续写", size - end);
+        m_file.resize(end);
+    }
+    return m_file.seek(end);
+}
+
+bool TelemetrySink::send(const QJsonObject& data)
+{
+    if (!m_writer) return false;
+    QMutexLocker locker(&m_mutex);
+    m_last = data;
+    if (m_pending.size() >= MAX_PENDING_RECORDS) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    TelemetryRecord record;
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.data = data;
+    m_pending.append(std::move(record));
+    // 第一条记录唤醒写线程开始计FLUSH_INTERVAL_MS，攒够一批时再唤醒一次提前写出
+    if (m_pending.size() == 1 || m_pending.size() == BATCH_RECORDS) m_wake.wakeOne();
+    return true;
+}
+
+QJsonObject TelemetrySink::receive()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_last;
+}
+
+void TelemetrySink::encode(const TelemetryRecord& record, QByteArray& out) const
+{
+    if (m_format == TelemetryFormat::JsonLines) {
+        QJsonObject object = record.data;
+        object[TelemetryFile::TIMESTAMP_KEY] = record.timestampMs;
+        out.append(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        out.append('\n');
+        return;
+    }
+    QByteArray payload = QCborValue(QCborMap::fromJsonObject(record.data)).toCbor();
+    uchar header[TelemetryFile::RECORD_HEADER_SIZE];
+    qToLittleEndian<quint32>(quint32(8 + payload.size()), header);
+    qToLittleEndian<qint64>(record.timestampMs, header + 4);
+    out.append(reinterpret_cast<const char*>(header), TelemetryFile::RECORD_HEADER_SIZE);
+    out.append(payload);
+}
+
+void TelemetrySink::writerLoop()
+{
+    QList<TelemetryRecord> batch;
+    QByteArray buffer;
+    while (true) {
+        bool stopping = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_pending.isEmpty() && !m_stopping) {
+                m_wake.wait(&m_mutex);
+            }
+            // 有记录但不够一批：最多再等FLUSH_INTERVAL_MS，把这段时间的记录一起写
+            if (!m_stopping && m_pending.size() < BATCH_RECORDS) {
+                m_wake.wait(&m_mutex, FLUSH_INTERVAL_MS);
+            }
+            batch.swap(m_pending);
+            stopping = m_stopping;
+        }
+
+        buffer.clear();
+        for (const TelemetryRecord& record : batch) {
+            encode(record, buffer);
+        }
+        if (!buffer.isEmpty()) {
+            if (m_file.write(buffer) == buffer.size()) {
+                m_written.fetch_add(batch.size(), std::memory_order_relaxed);
+            } else {
+                m_dropped.fetch_add(batch.size(), std::memory_order_relaxed);
+            }
+            m_file.flush();
+        }
+        batch.clear();
+        if (stopping) break;
+    }
+    m_file.close();
+}
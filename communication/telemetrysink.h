@@ -0,0 +1,71 @@
+#ifndef TELEMETRYSINK_H
+#define TELEMETRYSINK_H
+
+#include "ICommunication.h"
+#include "telemetryformat.h"
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+/*
+ * 追加写的遥测输出，替代每次整文件重写的FileCommunication
+ * 1. send()只把状态对象放进待写队列就返回（QJsonObject隐式共享，入队不拷贝内容），
+ *    编码和写文件都在后台写线程里完成，调用方不碰磁盘。
+ * 2. 写线程攒够BATCH_RECORDS条或距上次写入FLUSH_INTERVAL_MS后，一次write+flush整批写出。
+ * 3. 待写队列最多MAX_PENDING_RECORDS条，磁盘跟不上时丢弃新记录并计数，内存有上限。
+ * 4. 析构时写完队列中剩余的记录再返回。
+ */
+class TelemetrySink : public ICommunication
+{
+public:
+    static const int MAX_PENDING_RECORDS = 1024;
+    static const int BATCH_RECORDS = 64;
+    static const int FLUSH_INTERVAL_MS = 500;
+
+    TelemetrySink(const QString& filePath, TelemetryFormat format);
+    ~TelemetrySink() override;
+
+    bool isOpen() const { return m_file.isOpen(); }
+    // 入队，队列满或文件没打开时返回false
+    bool send(const QJsonObject& data) override;
+    // 最近一次send()的对象
+    QJsonObject receive() override;
+
+    quint64 writtenCount() const { return m_written.load(std::memory_order_relaxed); }
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    class WriterThread : public QThread
+    {
+    public:
+        explicit WriterThread(TelemetrySink* sink) : m_sink(sink) {}
+    protected:
+        void run() override { m_sink->writerLoop(); }
+    private:
+        TelemetrySink* m_sink;
+    };
+
+    bool openFile();
+    void writerLoop();
+    void encode(const TelemetryRecord& record, QByteArray& out) const;
+
+    const QString m_filePath;
+    const TelemetryFormat m_format;
+    QFile m_file;                       // 只由写线程写
+
+    QMutex m_mutex;                     // 保护下面的队列和标志
+    QWaitCondition m_wake;
+    QList<TelemetryRecord> m_pending;
+    QJsonObject m_last;
+    bool m_stopping = false;
+
+    std::atomic<quint64> m_written{0};
+    std::atomic<quint64> m_dropped{0};
+    std::unique_ptr<WriterThread> m_writer;
+};
+
+#endif // TELEMETRYSINK_H
@@ -0,0 +1,30 @@
+# 线程池核心库（纯C++17，不依赖Qt）：任务链表、就绪队列、调度器、线程CPU采样、计数器、负载轨迹、合成负载生成、参考负载、std::thread后端、parallelFor和离散事件仿真
+# Qt程序经由threadpoolcore.pri包含；非Qt工程可直接编译core.pro得到静态库libthreadpoolcore
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/loadgenerator.cpp \
+    $$PWD/parallelfor.cpp \
+    $$PWD/poolsimulator.cpp \
+    $$PWD/referenceworkloads.cpp \
+    $$PWD/scheduler.cpp \
+    $$PWD/stdthreadpool.cpp \
+    $$PWD/tasklist.cpp \
+    $$PWD/taskqueue.cpp \
+    $$PWD/threadcpu.cpp \
+    $$PWD/workloadtrace.cpp
+
+HEADERS += \
+    $$PWD/loadgenerator.h \
+    $$PWD/parallelfor.h \
+    $$PWD/poolcounters.h \
+    $$PWD/poolobserver.h \
+    $$PWD/poolsimulator.h \
+    $$PWD/poolsizing.h \
+    $$PWD/referenceworkloads.h \
+    $$PWD/scheduler.h \
+    $$PWD/stdthreadpool.h \
+    $$PWD/tasklist.h \
+    $$PWD/taskqueue.h \
+    $$PWD/threadcpu.h \
+    $$PWD/workloadtrace.h
@@ -0,0 +1,12 @@
+# 单独编译线程池核心为静态库，供不使用Qt的服务嵌入
+TEMPLATE = lib
+TARGET = threadpoolcore
+
+CONFIG += staticlib c++17
+include($$PWD/../warnings.pri)
+CONFIG -= qt
+
+unix: LIBS += -pthread
+unix: QMAKE_CXXFLAGS += -pthread
+
+include(core.pri)
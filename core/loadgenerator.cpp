@@ -0,0 +1,348 @@
+#include "loadgenerator.h"
+#include "tasklist.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+const int64_t SPIN_THRESHOLD_NS = 200000;       // 离下一个到期不足200us时不再sleep，只让出CPU
+const int64_t MAX_SLEEP_NS = 10000000;          // 单次最多睡10ms，stop()能及时生效
+
+std::vector<std::string> split(const std::string& text, char separator)
+{
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    while (true) {
+        size_t end = text.find(separator, begin);
+        parts.push_back(text.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+    return parts;
+}
+
+bool toDouble(const std::string& text, double& value)
+{
+    if (text.empty()) return false;
+    char* end = nullptr;
+    double parsed = strtod(text.c_str(), &end);
+    if (*end != '\0' || !std::isfinite(parsed)) return false;
+    value = parsed;
+    return true;
+}
+
+const char* arrivalName(ArrivalProcess process)
+{
+    switch (process) {
+    case ArrivalProcess::Uniform: return "uniform";
+    case ArrivalProcess::Poisson: return "poisson";
+    case ArrivalProcess::OnOff: return "onoff";
+    case ArrivalProcess::Diurnal: return "diurnal";
+    }
+    return "?";
+}
+
+} // namespace
+
+bool parseArrivalSpec(const std::string& text, ArrivalSpec& spec)
+{
+    std::vector<std::string> parts = split(text, ':');
+    ArrivalSpec parsed = spec;
+    if (parts[0] == "uniform" && parts.size() == 1) {
+        parsed.process = ArrivalProcess::Uniform;
+    } else if (parts[0] == "poisson" && parts.size() == 1) {
+        parsed.process = ArrivalProcess::Poisson;
+    } else if (parts[0] == "onoff" && parts.size() == 3) {
+        parsed.process = ArrivalProcess::OnOff;
+        if (!toDouble(parts[1], parsed.onMs) || !toDouble(parts[2], parsed.offMs)) return false;
+        if (parsed.onMs <= 0 || parsed.offMs < 0) return false;
+    } else if (parts[0] == "diurnal" && parts.size() == 3) {
+        parsed.process = ArrivalProcess::Diurnal;
+        if (!toDouble(parts[1], parsed.periodS) || !toDouble(parts[2], parsed.amplitude)) return false;
+        if (parsed.periodS <= 0 || parsed.amplitude < 0 || parsed.amplitude > 1) return false;
+    } else {
+        return false;
+    }
+    spec = parsed;
+    return true;
+}
+
+bool parseServiceSpec(const std::string& text, ServiceSpec& spec)
+{
+    std::vector<std::string> parts = split(text, ':');
+    ServiceSpec parsed;
+    double* fields[] = {&parsed.a, &parsed.b, &parsed.c};
+    size_t expected = 0;
+    if (parts[0] == "fixed") { parsed.distribution = ServiceDistribution::Fixed; expected = 1; }
+    else if (parts[0] == "uniform") { parsed.distribution = ServiceDistribution::Uniform; expected = 2; }
+    else if (parts[0] == "exp") { parsed.distribution = ServiceDistribution::Exponential; expected = 1; }
+    else if (parts[0] == "lognormal") { parsed.distribution = ServiceDistribution::Lognormal; expected = 2; }
+    else if (parts[0] == "bimodal") { parsed.distribution = ServiceDistribution::Bimodal; expected = 3; }
+    else return false;
+    if (parts.size() != expected + 1) return false;
+    for (size_t i = 0; i < expected; ++i) {
+        if (!toDouble(parts[i + 1], *fields[i]) || *fields[i] < 0) return false;
+    }
+    switch (parsed.distribution) {
+    case ServiceDistribution::Uniform: if (parsed.b < parsed.a) return false; break;
+    case ServiceDistribution::Lognormal: if (parsed.a <= 0) return false; break;
+    case ServiceDistribution::Bimodal: if (parsed.c > 1) return false; break;
+    default: break;
+    }
+    spec = parsed;
+    return true;
+}
+
+bool parsePriorityMix(const std::string& text, std::vector<PriorityWeight>& mix)
+{
+    std::vector<PriorityWeight> parsed;
+    double total = 0.0;
+    for (const std::string& item : split(text, ',')) {
+        std::vector<std::string> pair = split(item, ':');
+        double priority = 0.0;
+        PriorityWeight entry;
+        if (pair.size() != 2 || !toDouble(pair[0], priority) || !toDouble(pair[1], entry.weight)) return false;
+        if (priority != std::floor(priority) || std::fabs(priority) > INT_MAX || entry.weight < 0) return false;
+        entry.priority = int(priority);
+        total += entry.weight;
+        parsed.push_back(entry);
+    }
+    if (total <= 0) return false;
+    mix = parsed;
+    return true;
+}
+
+std::string describeLoadSpec(const LoadSpec& spec)
+{
+    char buffer[512];
+    std::string text;
+    const ArrivalSpec& arrival = spec.arrival;
+    if (arrival.ratePerSec <= 0) {
+        text = "all at t=0";
+    } else {
+        snprintf(buffer, sizeof(buffer), "%s %.0f tasks/s", arrivalName(arrival.process), arrival.ratePerSec);
+        text = buffer;
+        if (arrival.process == ArrivalProcess::OnOff) {
+            snprintf(buffer, sizeof(buffer), " (on %.0f ms / off %.0f ms)", arrival.onMs, arrival.offMs);
+            text += buffer;
+        } else if (arrival.process == ArrivalProcess::Diurnal) {
+            snprintf(buffer, sizeof(buffer), " (period %.0f s, amplitude %.2f)", arrival.periodS, arrival.amplitude);
+            text += buffer;
+        }
+    }
+    const ServiceSpec& service = spec.service;
+    switch (service.distribution) {
+    case ServiceDistribution::Fixed: snprintf(buffer, sizeof(buffer), ", service fixed %.0f ms", service.a); break;
+    case ServiceDistribution::Uniform: snprintf(buffer, sizeof(buffer), ", service uniform %.0f..%.0f ms", service.a, service.b); break;
+    case ServiceDistribution::Exponential: snprintf(buffer, sizeof(buffer), ", service exp mean %.0f ms", service.a); break;
+    case ServiceDistribution::Lognormal:
+        snprintf(buffer, sizeof(buffer), ", service lognormal median %.0f ms sigma %.2f", service.a, service.b);
+        break;
+    case ServiceDistribution::Bimodal:
+        snprintf(buffer, sizeof(buffer), ", service bimodal %.0f/%.0f ms (%.0f%% long)", service.a, service.b, service.c * 100);
+        break;
+    }
+    text += buffer;
+    if (!spec.priorities.empty()) {
+        text += ", priorities ";
+        for (size_t i = 0; i < spec.priorities.size(); ++i) {
+            snprintf(buffer, sizeof(buffer), "%s%d:%g", i > 0 ? "," : "", spec.priorities[i].priority, spec.priorities[i].weight);
+            text += buffer;
+        }
+    }
+    if (!spec.kinds.empty()) {
+        text += ", kinds ";
+        for (size_t i = 0; i < spec.kinds.size(); ++i) {
+            snprintf(buffer, sizeof(buffer), "%s%s:%g", i > 0 ? "," : "", taskKindName(spec.kinds[i].kind), spec.kinds[i].weight);
+            text += buffer;
+        }
+    }
+    snprintf(buffer, sizeof(buffer), ", %d producer(s), seed %llu", spec.producers, (unsigned long long)spec.seed);
+    text += buffer;
+    return text;
+}
+
+ArrivalSchedule::ArrivalSchedule(const LoadSpec& spec, int producer)
+    : m_arrival(spec.arrival)
+    , m_service(spec.service)
+    , m_random(spec.seed * 0x9E3779B97F4A7C15ULL + uint64_t(producer))
+{
+    int producers = spec.producers > 0 ? spec.producers : 1;
+    m_rate = m_arrival.ratePerSec / producers;
+    // 固定间隔时各生产者错开，合起来仍是均匀的
+    if (m_arrival.process == ArrivalProcess::Uniform && m_arrival.ratePerSec > 0) {
+        m_nowS = producer / m_arrival.ratePerSec;
+    }
+    std::vector<double> weights;
+    for (const PriorityWeight& entry : spec.priorities) {
+        m_priorities.push_back(entry.priority);
+        weights.push_back(entry.weight);
+    }
+    if (m_priorities.empty()) {
+        m_priorities.push_back(1);
+        weights.push_back(1.0);
+    }
+    m_priorityPick = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+    weights.clear();
+    for (const TaskKindWeight& entry : spec.kinds) {
+        m_kinds.push_back(entry.kind);
+        weights.push_back(entry.weight);
+    }
+    if (m_kinds.empty()) {
+        m_kinds.push_back(TaskKind::Sleep);
+        weights.push_back(1.0);
+    }
+    m_kindPick = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+}
+
+void ArrivalSchedule::next(int64_t& dueNs, int& totalTimeMs, int& priority, TaskKind& kind)
+{
+    dueNs = int64_t(nextArrivalS() * 1e9);
+    totalTimeMs = sampleServiceMs();
+    priority = m_priorities[m_priorityPick(m_random)];
+    // 只有一种类型时不抽样，保持与加入类型之前相同的随机序列
+    kind = m_kinds.size() == 1 ? m_kinds[0] : m_kinds[m_kindPick(m_random)];
+}
+
+double ArrivalSchedule::nextArrivalS()
+{
+    if (m_rate <= 0) return 0.0;
+    switch (m_arrival.process) {
+    case ArrivalProcess::Uniform: {
+        double arrival = m_nowS;
+        m_nowS += 1.0 / m_rate;
+        return arrival;
+    }
+    case ArrivalProcess::Poisson:
+        m_nowS += std::exponential_distribution<double>(m_rate)(m_random);
+        return m_nowS;
+    case ArrivalProcess::OnOff: {
+        // m_nowS累计的是ON时间：在ON时间轴上按泊松推进，再映射回真实时间（跳过OFF段）
+        m_nowS += std::exponential_distribution<double>(m_rate)(m_random);
+        double onS = m_arrival.onMs / 1000.0;
+        double cycleS = onS + m_arrival.offMs / 1000.0;
+        double cycles = std::floor(m_nowS / onS);
+        return cycles * cycleS + (m_nowS - cycles * onS);
+    }
+    case ArrivalProcess::Diurnal: {
+        // thinning：按峰值速率生成候选，再以λ(t)/λmax的概率接受
+        double peak = m_rate * (1.0 + m_arrival.amplitude);
+        std::exponential_distribution<double> gap(peak);
+        std::uniform_real_distribution<double> accept(0.0, 1.0);
+        while (true) {
+            m_nowS += gap(m_random);
+            double rate = m_rate * (1.0 + m_arrival.amplitude * std::sin(2.0 * PI * m_nowS / m_arrival.periodS));
+            if (accept(m_random) * peak <= rate) return m_nowS;
+        }
+    }
+    }
+    return m_nowS;
+}
+
+int ArrivalSchedule::sampleServiceMs()
+{
+    double ms = 0.0;
+    switch (m_service.distribution) {
+    case ServiceDistribution::Fixed:
+        ms = m_service.a;
+        break;
+    case ServiceDistribution::Uniform:
+        ms = std::uniform_real_distribution<double>(m_service.a, std::nextafter(m_service.b, HUGE_VAL))(m_random);
+        break;
+    case ServiceDistribution::Exponential:
+        ms = m_service.a > 0 ? std::exponential_distribution<double>(1.0 / m_service.a)(m_random) : 0.0;
+        break;
+    case ServiceDistribution::Lognormal:
+        ms = std::lognormal_distribution<double>(std::log(m_service.a), m_service.b)(m_random);
+        break;
+    case ServiceDistribution::Bimodal:
+        ms = std::bernoulli_distribution(m_service.c)(m_random) ? m_service.b : m_service.a;
+        break;
+    }
+    if (ms >= INT_MAX / 2) return INT_MAX / 2;
+    return ms > 0 ? int(ms + 0.5) : 0;
+}
+
+LoadGenerator::LoadGenerator(const LoadSpec& spec, Sink sink)
+    : m_spec(spec)
+    , m_sink(std::move(sink))
+{
+    if (m_spec.producers < 1) m_spec.producers = 1;
+    if (m_spec.maxBatch < 1) m_spec.maxBatch = 1;
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    stop();
+}
+
+void LoadGenerator::start()
+{
+    m_start = std::chrono::steady_clock::now();
+    m_running.store(m_spec.producers, std::memory_order_release);
+    // 任务数按生产者均分，余数给前几个
+    int64_t share = m_spec.tasks / m_spec.producers;
+    int64_t rest = m_spec.tasks % m_spec.producers;
+    for (int i = 0; i < m_spec.producers; ++i) {
+        m_threads.emplace_back(&LoadGenerator::producerLoop, this, i, share + (i < rest ? 1 : 0));
+    }
+}
+
+void LoadGenerator::stop()
+{
+    m_stop.store(true, std::memory_order_relaxed);
+    for (std::thread& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_threads.clear();
+}
+
+void LoadGenerator::producerLoop(int producer, int64_t tasks)
+{
+    ArrivalSchedule schedule(m_spec, producer);
+    const int64_t limitNs = m_spec.durationS > 0 ? int64_t(m_spec.durationS * 1e9) : INT64_MAX;
+    std::vector<Task> batch;
+    std::vector<int64_t> dueNs;
+    batch.reserve(size_t(m_spec.maxBatch));
+    dueNs.reserve(size_t(m_spec.maxBatch));
+
+    int64_t nextDueNs = 0;
+    int totalTimeMs = 0;
+    int priority = 0;
+    TaskKind kind = TaskKind::Sleep;
+    if (tasks > 0) schedule.next(nextDueNs, totalTimeMs, priority, kind);
+    while (tasks > 0 && nextDueNs < limitNs && !m_stop.load(std::memory_order_relaxed)) {
+        int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+        if (nextDueNs > nowNs) {
+            int64_t waitNs = nextDueNs - nowNs;
+            if (waitNs > SPIN_THRESHOLD_NS) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(waitNs - SPIN_THRESHOLD_NS / 2, MAX_SLEEP_NS)));
+            } else {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        // 已到期的全部取出（落后时一批补齐），批次大小受maxBatch限制
+        batch.clear();
+        dueNs.clear();
+        while (tasks > 0 && nextDueNs <= nowNs && nextDueNs < limitNs && int(batch.size()) < m_spec.maxBatch) {
+            batch.emplace_back();
+            Task& task = batch.back();
+            task.totalTimeMs = totalTimeMs;
+            task.priority = priority;
+            task.kind = kind;
+            task.memSize = m_spec.memSize;
+            dueNs.push_back(nextDueNs);
+            if (--tasks > 0) schedule.next(nextDueNs, totalTimeMs, priority, kind);
+        }
+        size_t count = batch.size();
+        m_sink(producer, batch, dueNs);
+        m_generated.fetch_add(int64_t(count), std::memory_order_relaxed);
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_running.fetch_sub(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,147 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "referenceworkloads.h"
+
+/*
+ * 合成负载生成器（开环）：到达时刻事先按分布排好，与线程池处理得快慢无关
+ * 1. 到达过程：固定间隔、泊松、开关突发（ON期间泊松，OFF期间不到达）、昼夜周期（速率按正弦变化的泊松，用thinning采样）。
+ * 2. 执行时间：固定、均匀、指数、对数正态、双峰；优先级和任务类型（TaskKind）按权重混合。
+ * 3. 多个生产者线程各自按rate/producers生成一份独立的序列（泊松过程叠加后仍是泊松），种子固定时序列可复现。
+ * 4. 生产者醒来后把所有已到期的任务一批交给Sink；落后于计划时不降速、也不丢任务，下一批把欠的一次补上。
+ *    Sink同时拿到每个任务的计划到达时刻，延迟应从计划时刻算起（避免coordinated omission：
+ *    提交被阻塞的那段时间也算进延迟，而不是被悄悄从样本里抹掉）。
+ */
+
+enum class ArrivalProcess
+{
+    Uniform,        // 固定间隔1/rate
+    Poisson,
+    OnOff,          // ON onMs毫秒（期间速率为rate）、OFF offMs毫秒交替
+    Diurnal         // rate*(1+amplitude*sin(2πt/period))
+};
+
+struct ArrivalSpec
+{
+    ArrivalProcess process = ArrivalProcess::Poisson;
+    double ratePerSec = 0.0;        // 0：全部任务在开始时刻到达
+    double onMs = 100.0;
+    double offMs = 400.0;
+    double periodS = 60.0;
+    double amplitude = 0.8;         // 0~1
+};
+
+enum class ServiceDistribution
+{
+    Fixed,          // a
+    Uniform,        // [a, b]
+    Exponential,    // 均值a
+    Lognormal,      // 中位数a，对数标准差b
+    Bimodal         // 概率c取b（长任务），否则取a
+};
+
+struct ServiceSpec
+{
+    ServiceDistribution distribution = ServiceDistribution::Uniform;
+    double a = 20.0;
+    double b = 200.0;
+    double c = 0.0;
+};
+
+struct PriorityWeight
+{
+    int priority = 1;
+    double weight = 1.0;
+};
+
+struct LoadSpec
+{
+    ArrivalSpec arrival;
+    ServiceSpec service;
+    std::vector<PriorityWeight> priorities;     // 为空时全部为优先级1
+    std::vector<TaskKindWeight> kinds;          // 为空时全部为TaskKind::Sleep
+    size_t memSize = 0;
+    int producers = 1;
+    int64_t tasks = 1000;                       // 所有生产者合计
+    double durationS = 0.0;                     // 计划到达时刻超过它就停止，0不限
+    int maxBatch = 4096;
+    uint64_t seed = 1;
+};
+
+// 命令行写法，失败返回false且不改spec：
+//   到达  uniform | poisson | onoff:ON_MS:OFF_MS | diurnal:PERIOD_S:AMPLITUDE
+//   执行  fixed:MS | uniform:MIN:MAX | exp:MEAN | lognormal:MEDIAN:SIGMA | bimodal:SHORT:LONG:P_LONG
+//   优先级 P:W,P:W,...（如1:70,5:20,10:10）
+bool parseArrivalSpec(const std::string& text, ArrivalSpec& spec);
+bool parseServiceSpec(const std::string& text, ServiceSpec& spec);
+bool parsePriorityMix(const std::string& text, std::vector<PriorityWeight>& mix);
+std::string describeLoadSpec(const LoadSpec& spec);
+
+// 一个生产者的到达序列，只依赖spec、生产者编号和种子
+class ArrivalSchedule
+{
+public:
+    ArrivalSchedule(const LoadSpec& spec, int producer);
+
+    // 下一个任务：计划到达时刻（相对开始，ns）、执行时间、优先级和类型
+    void next(int64_t& dueNs, int& totalTimeMs, int& priority, TaskKind& kind);
+
+private:
+    double nextArrivalS();
+    int sampleServiceMs();
+
+    ArrivalSpec m_arrival;
+    ServiceSpec m_service;
+    double m_rate = 0.0;            // 本生产者分到的速率
+    double m_nowS = 0.0;
+    std::mt19937_64 m_random;
+    std::vector<int> m_priorities;
+    std::discrete_distribution<size_t> m_priorityPick;
+    std::vector<TaskKind> m_kinds;
+    std::discrete_distribution<size_t> m_kindPick;
+};
+
+class LoadGenerator
+{
+public:
+    // 在生产者线程上调用：tasks[i]的计划到达时刻为dueNs[i]（相对startTime()），
+    // Sink负责分配ID、载荷并提交；tasks可以被move走
+    using Sink = std::function<void(int producer, std::vector<Task>& tasks, const std::vector<int64_t>& dueNs)>;
+
+    LoadGenerator(const LoadSpec& spec, Sink sink);
+    ~LoadGenerator();
+    LoadGenerator(const LoadGenerator&) = delete;
+    LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+    // 开始计时并启动生产者线程，只能调用一次
+    void start();
+    // 让生产者提前结束并等它们退出；尚未到期的任务不再生成
+    void stop();
+    bool isFinished() const { return m_running.load(std::memory_order_acquire) == 0; }
+
+    std::chrono::steady_clock::time_point startTime() const { return m_start; }
+    int64_t generatedCount() const { return m_generated.load(std::memory_order_relaxed); }
+    int64_t batchCount() const { return m_batches.load(std::memory_order_relaxed); }
+
+private:
+    void producerLoop(int producer, int64_t tasks);
+
+    LoadSpec m_spec;
+    Sink m_sink;
+    std::chrono::steady_clock::time_point m_start;
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_stop{false};
+    std::atomic<int> m_running{0};
+    std::atomic<int64_t> m_generated{0};
+    std::atomic<int64_t> m_batches{0};
+};
+
+#endif // LOADGENERATOR_H
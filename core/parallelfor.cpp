@@ -0,0 +1,112 @@
+#include "parallelfor.h"
+#include <climits>
+
+namespace ParallelDetail {
+
+namespace {
+
+// 领取票：持有作业的引用，作业结束后才被执行到的票直接返回
+struct Ticket
+{
+    std::shared_ptr<ParallelJob> job;
+};
+
+// 票没被执行就被线程池丢弃：只释放对作业的引用，区间仍在栈里，由调用线程做完
+void discardTicket(void* arg)
+{
+    delete static_cast<Ticket*>(arg);
+}
+
+} // namespace
+
+ParallelJob::ParallelJob(Submitter submit, int64_t begin, int64_t grain)
+    : m_submit(std::move(submit))
+    , m_begin(begin)
+    , m_grain(grain < 1 ? 1 : grain)
+{
+}
+
+void ParallelJob::run(int64_t end)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active = 1;
+    }
+    processGuarded(m_begin, end);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active--;
+    }
+    // 自己的区间做完后继续领取，栈空时等别人手里的区间（它们还可能再分出新的区间）
+    helpUntilIdle(true);
+    if (m_exception) std::rethrow_exception(m_exception);
+}
+
+void ParallelJob::splitIfDemanded(int64_t begin, int64_t& end)
+{
+    if (m_pending.load(std::memory_order_relaxed) != 0) return;
+    int64_t chunks = (end - begin + m_grain - 1) / m_grain;
+    if (chunks < 2) return;
+    // 区间起点总是m_begin+k*grain，对半分后仍然对齐
+    int64_t mid = begin + chunks / 2 * m_grain;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ranges.emplace_back(mid, end);
+        m_pending.store(int(m_ranges.size()), std::memory_order_relaxed);
+    }
+    m_changed.notify_all();
+    end = mid;
+
+    Task task;
+    task.function = &ParallelJob::runTicket;
+    task.cleanup = &discardTicket;
+    task.internal = true;
+    task.arg = new Ticket{shared_from_this()};
+    task.totalTimeMs = 1;           // 只是估计值，SJF/HRRN按它排序（HRRN不能为0）
+    task.priority = INT_MAX;        // 调用线程在等它，PRIO下排最前
+    task.arrivalTimestampMs = currentTimeOfDayMs();
+    m_submit(std::move(task));
+}
+
+void ParallelJob::runTicket(void* arg)
+{
+    std::unique_ptr<Ticket> ticket(static_cast<Ticket*>(arg));
+    ticket->job->helpUntilIdle(false);
+}
+
+void ParallelJob::helpUntilIdle(bool wait)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        if (!m_ranges.empty()) {
+            std::pair<int64_t, int64_t> range = m_ranges.back();
+            m_ranges.pop_back();
+            m_pending.store(int(m_ranges.size()), std::memory_order_relaxed);
+            m_active++;
+            lock.unlock();
+            processGuarded(range.first, range.second);
+            lock.lock();
+            m_active--;
+            if (m_active == 0 && m_ranges.empty()) m_changed.notify_all();
+            continue;
+        }
+        if (!wait || m_active == 0) return;
+        m_changed.wait(lock);
+    }
+}
+
+void ParallelJob::processGuarded(int64_t begin, int64_t end)
+{
+    try {
+        processRange(begin, end);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exception) m_exception = std::current_exception();
+        m_cancelled.store(true, std::memory_order_relaxed);
+        // 栈里剩下的区间不再做
+        m_ranges.clear();
+        m_pending.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace ParallelDetail
@@ -0,0 +1,154 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "tasklist.h"
+
+/*
+ * parallelFor/parallelReduce的公共部分（两种线程池共用，线程池只提供“提交一个Task”）
+ * 1. 懒惰二分（lazy binary splitting）：持有区间的线程每做完grain个下标检查一次需求——本作业没有待领取的区间时，
+ *    把剩余部分对半分出去，压入作业自己的区间栈并提交一个“领取票”任务；有区间在等人领时不再分，
+ *    线程池忙时最多多出一个待领区间，不会过度拆分。
+ * 2. 领取票在工作线程上执行时从区间栈里取区间来做，取不到（已被别人做掉）就直接返回；
+ *    票没执行就被线程池丢弃（关闭时）时由Task::discard()释放，区间仍由调用线程做完。
+ *    领取票标记为Task::internal，线程池不把它算作任务（计数、直方图、轨迹、事件都跳过）。
+ * 3. 调用线程自己从整个区间开始做，做完后继续从区间栈取，栈空后才等其他线程手里的区间做完；
+ *    调用线程是工作线程（嵌套调用）时也一样，它一个人也能把整个作业做完，不会因为线程池满而死锁。
+ * 4. 分出去的区间边界对齐到begin+k*grain，body每次拿到的[b,e)不超过grain个下标。
+ * 5. body抛出的第一个异常在调用线程重新抛出，其余还没开始的块不再执行。
+ */
+
+namespace ParallelDetail {
+
+class ParallelJob : public std::enable_shared_from_this<ParallelJob>
+{
+public:
+    using Submitter = std::function<void(Task&&)>;
+
+    ParallelJob(Submitter submit, int64_t begin, int64_t grain);
+    virtual ~ParallelJob() = default;
+
+    // 在调用线程上执行[begin,end)并等整个作业结束
+    void run(int64_t end);
+
+protected:
+    // 处理一个区间：每做grain个下标前调用splitIfDemanded
+    virtual void processRange(int64_t begin, int64_t end) = 0;
+    void splitIfDemanded(int64_t begin, int64_t& end);
+    bool cancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+    int64_t grain() const { return m_grain; }
+
+private:
+    static void runTicket(void* arg);
+    void helpUntilIdle(bool wait);
+    void processGuarded(int64_t begin, int64_t end);
+
+    Submitter m_submit;
+    const int64_t m_begin;
+    const int64_t m_grain;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::vector<std::pair<int64_t, int64_t>> m_ranges;     // 待领取的区间
+    std::atomic<int> m_pending{0};                          // m_ranges.size()，splitIfDemanded不加锁读
+    int m_active = 0;                                       // 正在被处理的区间数
+    std::atomic<bool> m_cancelled{false};
+    std::exception_ptr m_exception;
+};
+
+template <typename Body>
+class ForJob : public ParallelJob
+{
+public:
+    ForJob(Submitter submit, int64_t begin, int64_t grain, Body& body)
+        : ParallelJob(std::move(submit), begin, grain), m_body(body) {}
+
+protected:
+    void processRange(int64_t begin, int64_t end) override
+    {
+        while (begin < end && !cancelled()) {
+            splitIfDemanded(begin, end);
+            int64_t chunkEnd = std::min(end, begin + grain());
+            m_body(begin, chunkEnd);
+            begin = chunkEnd;
+        }
+    }
+
+private:
+    Body& m_body;
+};
+
+template <typename T, typename Map, typename Combine>
+class ReduceJob : public ParallelJob
+{
+public:
+    ReduceJob(Submitter submit, int64_t begin, int64_t grain, const T& identity, Map& map, Combine& combine)
+        : ParallelJob(std::move(submit), begin, grain), m_identity(identity), m_map(map), m_combine(combine) {}
+
+    // 按区间起点从左到右合并，combine只需满足结合律
+    T result()
+    {
+        std::sort(m_partials.begin(), m_partials.end(),
+                  [](const std::pair<int64_t, T>& a, const std::pair<int64_t, T>& b) { return a.first < b.first; });
+        T value = m_identity;
+        for (std::pair<int64_t, T>& partial : m_partials) value = m_combine(std::move(value), std::move(partial.second));
+        return value;
+    }
+
+protected:
+    void processRange(int64_t begin, int64_t end) override
+    {
+        // 一个区间在一个线程上从左到右做完，分出去的总是右半部分，所以本地部分和对应连续的[start,begin)
+        const int64_t start = begin;
+        T value = m_identity;
+        while (begin < end && !cancelled()) {
+            splitIfDemanded(begin, end);
+            int64_t chunkEnd = std::min(end, begin + grain());
+            value = m_combine(std::move(value), m_map(begin, chunkEnd));
+            begin = chunkEnd;
+        }
+        std::lock_guard<std::mutex> lock(m_partialMutex);
+        m_partials.emplace_back(start, std::move(value));
+    }
+
+private:
+    const T m_identity;
+    Map& m_map;
+    Combine& m_combine;
+    std::mutex m_partialMutex;
+    std::vector<std::pair<int64_t, T>> m_partials;
+};
+
+} // namespace ParallelDetail
+
+// body(b, e)处理[b,e)，每次不超过grain个下标；grain<1按1处理
+template <typename Body>
+void parallelFor(const ParallelDetail::ParallelJob::Submitter& submit, int64_t begin, int64_t end, int64_t grain, Body&& body)
+{
+    if (begin >= end) return;
+    auto job = std::make_shared<ParallelDetail::ForJob<std::remove_reference_t<Body>>>(submit, begin, grain, body);
+    job->run(end);
+}
+
+// map(b, e)返回[b,e)的部分结果，combine(x, y)合并相邻的两段（x在左），identity为单位元
+template <typename T, typename Map, typename Combine>
+T parallelReduce(const ParallelDetail::ParallelJob::Submitter& submit, int64_t begin, int64_t end, int64_t grain,
+                 T identity, Map&& map, Combine&& combine)
+{
+    if (begin >= end) return identity;
+    auto job = std::make_shared<ParallelDetail::ReduceJob<T, std::remove_reference_t<Map>, std::remove_reference_t<Combine>>>(
+        submit, begin, grain, identity, map, combine);
+    job->run(end);
+    return job->result();
+}
+
+#endif // PARALLELFOR_H
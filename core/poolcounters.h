@@ -0,0 +1,63 @@
+#ifndef POOLCOUNTERS_H
+#define POOLCOUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include "scheduler.h"
+
+/*
+ * 线程池的累计计数器和直方图，供外部抓取（如Prometheus端点）无锁读取
+ * 1. 只在线程池已有的状态变化点更新（入队、开始执行、完成、线程增减），都是relaxed原子操作，不新增加锁。
+ *    只有StdThreadPool更新它们，Qt版ThreadPool::getCounters()返回的就是它内部那一份。
+ * 2. 读者不加任何锁，各项之间不保证是同一时刻的值；抓取间隔远大于更新间隔，这点误差可以接受。
+ * 3. 直方图的桶边界固定（秒），按Prometheus的格式累计输出。
+ */
+
+// 固定桶边界的累计直方图，观测值以微秒记录
+class LatencyHistogram
+{
+public:
+    static const int BUCKETS = 16;
+    // 桶上界（秒），最后还有一个+Inf桶
+    static constexpr double BOUNDS[BUCKETS] = {
+        0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+        0.25, 0.5, 1, 2.5, 5, 10, 30, 60
+    };
+
+    void observe(int64_t us)
+    {
+        if (us < 0) us = 0;
+        int bucket = 0;
+        while (bucket < BUCKETS && us > int64_t(BOUNDS[bucket] * 1e6)) bucket++;
+        m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_sumUs.fetch_add(us, std::memory_order_relaxed);
+    }
+
+    // 第bucket个桶（非累计），bucket == BUCKETS 为+Inf桶
+    uint64_t bucketCount(int bucket) const { return m_counts[bucket].load(std::memory_order_relaxed); }
+    double sumSeconds() const { return m_sumUs.load(std::memory_order_relaxed) / 1e6; }
+
+private:
+    std::atomic<uint64_t> m_counts[BUCKETS + 1] = {};
+    std::atomic<int64_t> m_sumUs{0};
+};
+
+class PoolCounters
+{
+public:
+    // 计数器（只增不减）
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> finished{0};
+    std::atomic<uint64_t> cancelled{0};     // 没有执行就被丢弃的任务：线程池关闭后提交的、关闭时还在排队的
+    // 仪表（随状态变化，写入方都持有线程池的锁，读者直接读）
+    std::atomic<int> aliveThreads{0};
+    std::atomic<int> busyThreads{0};
+    std::atomic<int> queuedTasks{0};
+    std::atomic<int> policy{int(SchedulePolicy::FIFO)};
+    // 排队等待（到达->开始执行）、执行（墙钟）、端到端（到达->完成）
+    LatencyHistogram waitTime;
+    LatencyHistogram runTime;
+    LatencyHistogram latency;
+};
+
+#endif // POOLCOUNTERS_H
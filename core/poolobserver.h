@@ -0,0 +1,50 @@
+#ifndef POOLOBSERVER_H
+#define POOLOBSERVER_H
+
+#include <cstdint>
+#include "scheduler.h"
+
+struct Task;
+
+/*
+ * StdThreadPool的回调接口（替代Qt信号）
+ * 1. 回调在工作线程/管理线程上直接同步调用，没有事件投递，也不分配内存。
+ * 2. 一般的回调调用时不持有线程池的锁，但实现必须线程安全且足够快：慢回调会直接拖慢工作线程。
+ * 3. 带Locked后缀的回调在持有线程池锁时调用，实现方可以借此让自己的记录（如事件序号）与队列状态一致；
+ *    里面不能调用线程池的任何接口，只能再加实现方自己的锁（加锁顺序固定为线程池的锁在前）。
+ * 4. 内部任务（Task::internal）不触发任务相关的回调。
+ * 5. 需要回到某个事件循环的（比如Qt界面），由实现自己合并或排队后再投递。Qt版ThreadPool就是这样一个实现。
+ */
+class PoolObserver
+{
+public:
+    virtual ~PoolObserver() = default;
+
+    // 任务入队后（addTask/addTasks里逐个调用）
+    virtual void onTaskEnqueuedLocked(const Task& task) { (void)task; }
+    // 工作线程取到任务时，此时任务已出队、尚未开始执行
+    virtual void onTaskDispatchedLocked(int threadId, const Task& task) { (void)threadId; (void)task; }
+    virtual void onPolicyChangedLocked(SchedulePolicy policy) { (void)policy; }
+
+    // 在工作线程上，开始执行之前
+    virtual void onTaskStarted(int threadId, const Task& task) { (void)threadId; (void)task; }
+    // 大于0时，没有function的任务按这个步长分段执行，每段结束调用onTaskProgress（线程池创建时读取一次）
+    virtual int progressStepMs() const { return 0; }
+    virtual void onTaskProgress(int threadId, const Task& task, int elapsedMs) { (void)threadId; (void)task; (void)elapsedMs; }
+    // wallNs/cpuNs为任务执行期间的墙钟时间和本线程CPU时间
+    virtual void onTaskFinished(int threadId, const Task& task, int64_t wallNs, int64_t cpuNs)
+    {
+        (void)threadId; (void)task; (void)wallNs; (void)cpuNs;
+    }
+    // 在新工作线程上、取第一个任务之前调用，可以在这里做线程本地的初始化
+    virtual void onThreadSpawned(int threadId) { (void)threadId; }
+    // 在退出的工作线程上调用，之后这个线程不会再有回调
+    virtual void onThreadExited(int threadId) { (void)threadId; }
+    // 管理线程每次检查扩缩容后调用：检查时的排队数/存活/忙线程数，本次新建的线程数和请求退出的线程数
+    virtual void onSizingChecked(int queueSize, int aliveNum, int busyNum, int spawned, int exitRequests)
+    {
+        (void)queueSize; (void)aliveNum; (void)busyNum; (void)spawned; (void)exitRequests;
+    }
+};
+
+#endif // POOLOBSERVER_H
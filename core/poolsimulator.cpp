@@ -0,0 +1,212 @@
+#include "poolsimulator.h"
+#include "tasklist.h"
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <queue>
+
+namespace {
+
+// 仿真期间让本线程的currentTimeOfDayMs()读虚拟时钟（HRRN排序要用），离开作用域恢复
+class VirtualClockScope
+{
+public:
+    explicit VirtualClockScope(const int* nowMs) { setThreadVirtualClock(nowMs); }
+    ~VirtualClockScope() { setThreadVirtualClock(nullptr); }
+};
+
+struct FinishEvent
+{
+    int timeMs;
+    uint64_t seq;       // 同一时刻按开始顺序完成，结果可重复
+    int worker;
+    bool operator>(const FinishEvent& other) const
+    {
+        return timeMs != other.timeMs ? timeMs > other.timeMs : seq > other.seq;
+    }
+};
+
+struct SimWorker
+{
+    bool alive = true;
+    bool busy = false;
+    int taskIndex = -1;
+};
+
+SimPercentiles percentiles(std::vector<double>& samples)
+{
+    SimPercentiles result;
+    if (samples.empty()) return result;
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double p) { return samples[size_t(p * double(samples.size() - 1))]; };
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+    result.p50 = at(0.50);
+    result.p90 = at(0.90);
+    result.p99 = at(0.99);
+    result.max = samples.back();
+    result.mean = sum / double(samples.size());
+    return result;
+}
+
+} // namespace
+
+SimResult PoolSimulator::run(const std::vector<SimTask>& workload)
+{
+    SimResult result;
+    result.policy = m_config.policy;
+    result.tasks = int(workload.size());
+    const int minNum = std::max(0, m_config.minThreads);
+    const int maxNum = std::max(std::max(1, minNum), m_config.maxThreads);
+
+    // 按到达时间处理，同一时刻保持提交顺序
+    std::vector<int> arrivals(workload.size());
+    for (size_t i = 0; i < arrivals.size(); ++i) arrivals[i] = int(i);
+    std::stable_sort(arrivals.begin(), arrivals.end(), [&workload](int a, int b) {
+        return workload[size_t(a)].arrivalMs < workload[size_t(b)].arrivalMs;
+    });
+
+    int nowMs = 0;
+    VirtualClockScope clock(&nowMs);
+    std::unique_ptr<TaskScheduler> scheduler(createScheduler(m_config.policy));
+    TaskNodePool nodes;
+    TaskList queue;
+
+    std::vector<SimWorker> workers;
+    std::vector<int> idle;              // 空闲线程的下标，后进先出
+    std::priority_queue<FinishEvent, std::vector<FinishEvent>, std::greater<FinishEvent>> finishes;
+    uint64_t seq = 0;
+    int alive = 0;
+    int busy = 0;
+    int exitNum = 0;
+
+    std::vector<double> queueWait;
+    std::vector<double> turnaround;
+    std::vector<double> ratios;
+    queueWait.reserve(workload.size());
+    turnaround.reserve(workload.size());
+    ratios.reserve(workload.size());
+    double aliveIntegral = 0.0;
+    double busyIntegral = 0.0;
+
+    auto spawn = [&]() {
+        workers.push_back(SimWorker());
+        idle.push_back(int(workers.size()) - 1);
+        alive++;
+        result.threadsSpawned++;
+        result.peakThreads = std::max(result.peakThreads, alive);
+    };
+    // 对应StdThreadPool::workerLoop里每轮取任务前的缩容检查，返回true表示该线程退出
+    auto exitCheck = [&](int worker) {
+        if (exitNum > 0 && alive > minNum) {
+            exitNum--;
+            alive--;
+            workers[size_t(worker)].alive = false;
+            result.threadsExited++;
+            return true;
+        }
+        if (exitNum > 0) exitNum = 0;
+        return false;
+    };
+
+    for (int i = 0; i < minNum; ++i) spawn();
+
+    size_t nextArrival = 0;
+    size_t finished = 0;
+    int nextCheckMs = m_config.managerIntervalMs;
+    while (finished < workload.size()) {
+        int nextMs = INT_MAX;
+        if (!finishes.empty()) nextMs = std::min(nextMs, finishes.top().timeMs);
+        if (nextArrival < arrivals.size()) nextMs = std::min(nextMs, workload[size_t(arrivals[nextArrival])].arrivalMs);
+        if (m_config.managerIntervalMs > 0) nextMs = std::min(nextMs, nextCheckMs);
+        if (nextMs == INT_MAX) break;   // 没有线程也不会再扩容（managerIntervalMs<=0且minThreads=0）
+        aliveIntegral += double(alive) * (nextMs - nowMs);
+        busyIntegral += double(busy) * (nextMs - nowMs);
+        nowMs = nextMs;
+
+        // 1. 任务完成：线程回到取任务循环，先做缩容检查
+        while (!finishes.empty() && finishes.top().timeMs == nowMs) {
+            FinishEvent event = finishes.top();
+            finishes.pop();
+            result.events++;
+            SimWorker& worker = workers[size_t(event.worker)];
+            const SimTask& task = workload[size_t(worker.taskIndex)];
+            int waitMs = nowMs - task.arrivalMs;
+            turnaround.push_back(waitMs);
+            result.totalWaitingTimeMs += waitMs;
+            if (task.totalTimeMs > 0) {
+                double ratio = (waitMs + task.totalTimeMs) / double(task.totalTimeMs);
+                ratios.push_back(ratio);
+                result.totalResponseRatio += ratio;
+            }
+            worker.busy = false;
+            worker.taskIndex = -1;
+            busy--;
+            finished++;
+            if (!exitCheck(event.worker)) idle.push_back(event.worker);
+        }
+
+        // 2. 任务到达：按调度策略入队
+        while (nextArrival < arrivals.size() && workload[size_t(arrivals[nextArrival])].arrivalMs == nowMs) {
+            int index = arrivals[nextArrival++];
+            const SimTask& simTask = workload[size_t(index)];
+            Task task;
+            task.id = index;      // 用下标作ID，出队时直接找回SimTask
+            task.totalTimeMs = simTask.totalTimeMs;
+            task.priority = simTask.priority;
+            task.arrivalTimestampMs = simTask.arrivalMs;
+            scheduler->insertByPolicy(queue, nodes.acquire(std::move(task)));
+            result.events++;
+        }
+
+        // 3. 管理线程检查：扩容和缩容都按检查开始时的快照判断
+        if (m_config.managerIntervalMs > 0 && nowMs == nextCheckMs) {
+            nextCheckMs += m_config.managerIntervalMs;
+            result.events++;
+            int queued = queue.size();
+            int liveNum = alive;
+            int busyNum = busy;
+            int spawnNum = PoolSizing::expandCount(queued, liveNum, maxNum);
+            for (int i = 0; i < spawnNum; ++i) spawn();
+            if (PoolSizing::shouldShrink(busyNum, liveNum, minNum)) {
+                exitNum = PoolSizing::EXPAND_NUMBER;
+                // 被唤醒的空闲线程退出
+                while (exitNum > 0 && !idle.empty()) {
+                    int worker = idle.back();
+                    if (!exitCheck(worker)) break;
+                    idle.pop_back();
+                }
+            }
+        }
+
+        // 4. 空闲线程取任务
+        while (!idle.empty() && !queue.isEmpty()) {
+            int workerIndex = idle.back();
+            idle.pop_back();
+            if (exitCheck(workerIndex)) continue;
+            if (scheduler->needDynamicSort()) scheduler->sortQueue(queue);
+            TaskNode* node = queue.takeFirst();
+            int index = node->task.id;
+            nodes.release(node);
+
+            const SimTask& task = workload[size_t(index)];
+            int runMs = std::max(0, task.totalTimeMs);
+            if (m_config.stepMs > 0 && runMs > 0) runMs = (runMs + m_config.stepMs - 1) / m_config.stepMs * m_config.stepMs;
+            queueWait.push_back(nowMs - task.arrivalMs);
+            SimWorker& worker = workers[size_t(workerIndex)];
+            worker.busy = true;
+            worker.taskIndex = index;
+            busy++;
+            finishes.push(FinishEvent{nowMs + runMs, seq++, workerIndex});
+        }
+    }
+
+    result.makespanMs = nowMs;
+    result.queueWaitMs = percentiles(queueWait);
+    result.turnaroundMs = percentiles(turnaround);
+    result.responseRatio = percentiles(ratios);
+    if (nowMs > 0) result.averageThreads = aliveIntegral / nowMs;
+    if (aliveIntegral > 0.0) result.utilization = busyIntegral / aliveIntegral;
+    while (TaskNode* node = queue.takeFirst()) nodes.release(node);
+    return result;
+}
@@ -0,0 +1,80 @@
+#ifndef POOLSIMULATOR_H
+#define POOLSIMULATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "scheduler.h"
+#include "poolsizing.h"
+
+/*
+ * 离散事件仿真：不起线程、不sleep，用虚拟时钟按事件推进，几秒内跑完真实需要数小时的负载
+ * 1. 排队和出队用真实的TaskScheduler（insertByPolicy/sortQueue/takeFirst），HRRN的响应比按虚拟时间计算。
+ * 2. 扩缩容用PoolSizing：每CHECK_INTERVAL_MS检查一次，规则与ThreadPool的管理线程相同；
+ *    缩容时空闲线程立即退出，忙线程做完当前任务后退出。
+ * 3. 任务执行时间按ThreadPool::executeTask的分段sleep取整到stepMs的整数倍（stepMs=0则不取整），
+ *    线程取任务、唤醒等开销视为0。
+ * 4. 同一毫秒内的事件按“任务完成→任务到达→管理线程检查”的顺序处理。
+ * 5. 不加锁，一个PoolSimulator只在一个线程里用；不同实例可以在不同线程里并行跑。
+ */
+
+// 仿真负载里的一个任务，时间都是相对仿真开始的毫秒数
+struct SimTask
+{
+    int id = 0;
+    int arrivalMs = 0;
+    int totalTimeMs = 0;
+    int priority = 0;
+};
+
+struct SimConfig
+{
+    int minThreads = 2;
+    int maxThreads = 8;
+    SchedulePolicy policy = SchedulePolicy::FIFO;
+    int stepMs = 20;                                    // 对应ThreadPool::STEP_TIME_MS
+    int managerIntervalMs = PoolSizing::CHECK_INTERVAL_MS;
+};
+
+// 一组样本的分位数
+struct SimPercentiles
+{
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+};
+
+struct SimResult
+{
+    SchedulePolicy policy = SchedulePolicy::FIFO;
+    int tasks = 0;
+    int64_t makespanMs = 0;             // 最后一个任务完成的时刻，对应getTotalTimeMs()
+    // 与ThreadPool::getTotalWaitingTimeMs()/getTotalResponseRatio()口径相同：
+    // “等待时间”为完成-到达，响应比为(等待时间+执行时间)/执行时间，均为所有已完成任务之和
+    int64_t totalWaitingTimeMs = 0;
+    double totalResponseRatio = 0.0;
+    SimPercentiles queueWaitMs;         // 到达→开始执行
+    SimPercentiles turnaroundMs;        // 到达→完成
+    SimPercentiles responseRatio;
+    int peakThreads = 0;
+    double averageThreads = 0.0;        // 按时间加权的存活线程数
+    double utilization = 0.0;           // 忙线程时间/存活线程时间
+    int threadsSpawned = 0;             // 含初始的minThreads个
+    int threadsExited = 0;
+    uint64_t events = 0;
+};
+
+class PoolSimulator
+{
+public:
+    explicit PoolSimulator(const SimConfig& config) : m_config(config) {}
+
+    // 运行一次完整仿真；workload不要求按到达时间排序
+    SimResult run(const std::vector<SimTask>& workload);
+
+private:
+    SimConfig m_config;
+};
+
+#endif // POOLSIMULATOR_H
@@ -0,0 +1,29 @@
+#ifndef POOLSIZING_H
+#define POOLSIZING_H
+
+#include <algorithm>
+
+/*
+ * 管理线程的扩缩容规则（StdThreadPool和PoolSimulator共用，保证仿真与真实线程池一致）
+ * 1. 扩容：任务数>存活线程数 && 存活线程数<最大线程数时，每次最多新建EXPAND_NUMBER个。
+ * 2. 缩容：忙线程*2<存活线程数 && 存活线程数>最小线程数时，请求EXPAND_NUMBER个线程退出，
+ *    空闲线程被唤醒后退出，忙线程做完当前任务后退出，退到最小线程数为止。
+ */
+struct PoolSizing
+{
+    static constexpr int EXPAND_NUMBER = 2;
+    static constexpr int CHECK_INTERVAL_MS = 5000;
+
+    // 本轮应新建的线程数
+    static int expandCount(int queued, int alive, int maxNum)
+    {
+        if (queued > alive && alive < maxNum) return std::min(EXPAND_NUMBER, maxNum - alive);
+        return 0;
+    }
+    static bool shouldShrink(int busy, int alive, int minNum)
+    {
+        return busy * 2 < alive && alive > minNum;
+    }
+};
+
+#endif // POOLSIZING_H
@@ -0,0 +1,322 @@
+#include "referenceworkloads.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const KIND_NAMES[ReferenceWorkloads::KIND_COUNT] = {"sleep", "matmul", "checksum", "memstream", "chase", "mixedio"};
+const char* const UNIT_NAMES[ReferenceWorkloads::KIND_COUNT] = {"ms", "96^3 matmul", "4KB hashed", "64KB copied", "1024 hops", "ms"};
+
+const int MATRIX_N = 96;                            // 3个矩阵共216KB，放得进L2
+const int MATRIX_BLOCK = 32;
+const size_t HASH_BLOCK = 4096;
+const size_t HASH_BUFFER_SIZE = 1 << 20;            // 载荷小于一个块时用的共享缓冲
+const size_t STREAM_CHUNK = 64 * 1024;
+const size_t STREAM_SOURCE_SIZE = 64u << 20;        // 远大于末级缓存，读一定走内存
+const size_t STREAM_TARGET_SIZE = 8u << 20;
+const size_t CHASE_NODES = 1u << 20;                // 每个节点一条缓存行，共64MB
+const int CHASE_HOPS = 1024;
+const int CALIBRATE_ROUNDS = 3;
+const int MIXED_SLICE_MS = 2;                       // MixedIo每2ms：前一半计算，后一半阻塞
+
+struct alignas(64) ChaseNode
+{
+    uint32_t next;
+    uint32_t pad[15];
+};
+
+std::atomic<uint64_t> g_sink{0};
+std::once_flag g_calibrated;
+double g_unitsPerMs[ReferenceWorkloads::KIND_COUNT] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+
+std::once_flag g_hashBufferOnce;
+std::unique_ptr<uint32_t[]> g_hashBuffer;
+std::once_flag g_streamOnce;
+std::unique_ptr<char[]> g_streamSource;
+std::once_flag g_chaseOnce;
+std::unique_ptr<ChaseNode[]> g_chase;
+
+const uint32_t* hashBuffer()
+{
+    std::call_once(g_hashBufferOnce, []() {
+        g_hashBuffer.reset(new uint32_t[HASH_BUFFER_SIZE / sizeof(uint32_t)]);
+        for (size_t i = 0; i < HASH_BUFFER_SIZE / sizeof(uint32_t); ++i) g_hashBuffer[i] = uint32_t(i * 2654435761u);
+    });
+    return g_hashBuffer.get();
+}
+
+const char* streamSource()
+{
+    std::call_once(g_streamOnce, []() {
+        g_streamSource.reset(new char[STREAM_SOURCE_SIZE]);
+        memset(g_streamSource.get(), 0x5a, STREAM_SOURCE_SIZE);   // 先写一遍，避免首轮读到零页
+    });
+    return g_streamSource.get();
+}
+
+const ChaseNode* chaseList()
+{
+    std::call_once(g_chaseOnce, []() {
+        // Sattolo算法生成单个大环，遍历时每一跳都落在随机的缓存行上
+        std::vector<uint32_t> order(CHASE_NODES);
+        for (uint32_t i = 0; i < CHASE_NODES; ++i) order[i] = i;
+        std::mt19937 random(12345);
+        for (size_t i = CHASE_NODES - 1; i > 0; --i) {
+            std::swap(order[i], order[std::uniform_int_distribution<size_t>(0, i - 1)(random)]);
+        }
+        g_chase.reset(new ChaseNode[CHASE_NODES]);
+        for (size_t i = 0; i < CHASE_NODES; ++i) g_chase[order[i]].next = order[(i + 1) % CHASE_NODES];
+    });
+    return g_chase.get();
+}
+
+struct ThreadState
+{
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<double> c;
+    std::unique_ptr<char[]> streamTarget;
+    size_t streamOffset = 0;
+    size_t hashOffset = 0;
+    uint32_t chaseCursor = 0;
+};
+
+ThreadState& threadState()
+{
+    thread_local ThreadState state;
+    return state;
+}
+
+void matmulUnits(int64_t units)
+{
+    ThreadState& state = threadState();
+    const size_t n = MATRIX_N;
+    if (state.a.empty()) {
+        state.a.assign(n * n, 1.0);
+        state.b.assign(n * n, 0.5);
+        state.c.assign(n * n, 0.0);
+        for (size_t i = 0; i < n * n; ++i) state.a[i] += double(i % 7) * 0.01;
+    }
+    double* a = state.a.data();
+    double* b = state.b.data();
+    double* c = state.c.data();
+    for (int64_t unit = 0; unit < units; ++unit) {
+        std::fill(c, c + n * n, 0.0);
+        for (size_t ii = 0; ii < n; ii += MATRIX_BLOCK) {
+            for (size_t kk = 0; kk < n; kk += MATRIX_BLOCK) {
+                for (size_t jj = 0; jj < n; jj += MATRIX_BLOCK) {
+                    for (size_t i = ii; i < ii + MATRIX_BLOCK; ++i) {
+                        for (size_t k = kk; k < kk + MATRIX_BLOCK; ++k) {
+                            double aik = a[i * n + k];
+                            for (size_t j = jj; j < jj + MATRIX_BLOCK; ++j) c[i * n + j] += aik * b[k * n + j];
+                        }
+                    }
+                }
+            }
+        }
+        // 结果喂回b，下一轮依赖这一轮，不会被合并
+        b[unit % int64_t(n * n)] = c[(unit * 7) % int64_t(n * n)] * 1e-9;
+    }
+    g_sink.fetch_add(uint64_t(c[0]), std::memory_order_relaxed);
+}
+
+// 8路独立的乘法-异或哈希，内层循环没有跨路依赖，编译器可以自动向量化
+uint32_t hashBlock(const uint32_t* words, size_t count, uint32_t seed)
+{
+    uint32_t lanes[8];
+    for (int i = 0; i < 8; ++i) lanes[i] = seed + uint32_t(i);
+    for (size_t w = 0; w + 8 <= count; w += 8) {
+        for (int i = 0; i < 8; ++i) lanes[i] = (lanes[i] ^ words[w + size_t(i)]) * 0x9E3779B1u;
+    }
+    uint32_t hash = 0;
+    for (int i = 0; i < 8; ++i) hash = (hash ^ lanes[i]) * 0x85EBCA6Bu;
+    return hash;
+}
+
+void checksumUnits(int64_t units, const void* payload, size_t payloadSize)
+{
+    ThreadState& state = threadState();
+    const uint32_t* buffer = hashBuffer();
+    size_t bufferSize = HASH_BUFFER_SIZE;
+    if (payload && payloadSize >= HASH_BLOCK) {
+        buffer = static_cast<const uint32_t*>(payload);
+        bufferSize = payloadSize / HASH_BLOCK * HASH_BLOCK;
+    }
+    size_t offset = state.hashOffset % bufferSize;
+    uint32_t hash = 0;
+    for (int64_t unit = 0; unit < units; ++unit) {
+        hash = hashBlock(buffer + offset / sizeof(uint32_t), HASH_BLOCK / sizeof(uint32_t), hash);
+        offset += HASH_BLOCK;
+        if (offset >= bufferSize) offset = 0;
+    }
+    state.hashOffset = offset;
+    g_sink.fetch_add(hash, std::memory_order_relaxed);
+}
+
+void memStreamUnits(int64_t units)
+{
+    ThreadState& state = threadState();
+    const char* source = streamSource();
+    if (!state.streamTarget) state.streamTarget.reset(new char[STREAM_TARGET_SIZE]);
+    size_t offset = state.streamOffset;
+    for (int64_t unit = 0; unit < units; ++unit) {
+        memcpy(state.streamTarget.get() + offset % STREAM_TARGET_SIZE, source + offset % STREAM_SOURCE_SIZE, STREAM_CHUNK);
+        offset = (offset + STREAM_CHUNK) % STREAM_SOURCE_SIZE;     // 源是目标的整数倍，两边同时回绕
+    }
+    state.streamOffset = offset;
+    g_sink.fetch_add(uint64_t(state.streamTarget[offset % STREAM_TARGET_SIZE]), std::memory_order_relaxed);
+}
+
+void chaseUnits(int64_t units)
+{
+    ThreadState& state = threadState();
+    const ChaseNode* nodes = chaseList();
+    uint32_t cursor = state.chaseCursor;
+    if (cursor == 0) {
+        // 各线程从不同位置出发
+        cursor = uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id()) % CHASE_NODES);
+    }
+    for (int64_t unit = 0; unit < units; ++unit) {
+        for (int hop = 0; hop < CHASE_HOPS; ++hop) cursor = nodes[cursor].next;
+    }
+    state.chaseCursor = cursor;
+    g_sink.fetch_add(cursor, std::memory_order_relaxed);
+}
+
+void runUnits(TaskKind kind, int64_t units, const void* payload, size_t payloadSize)
+{
+    switch (kind) {
+    case TaskKind::MatMul: matmulUnits(units); break;
+    case TaskKind::Checksum: checksumUnits(units, payload, payloadSize); break;
+    case TaskKind::MemStream: memStreamUnits(units); break;
+    case TaskKind::PointerChase: chaseUnits(units); break;
+    default: break;
+    }
+}
+
+// 不区分大小写比较（strcasecmp只有POSIX有）
+bool equalsIgnoreCase(const std::string& text, const char* name)
+{
+    return std::equal(text.begin(), text.end(), name, name + strlen(name), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
+} // namespace
+
+const char* taskKindName(TaskKind kind)
+{
+    int index = int(kind);
+    return index >= 0 && index < ReferenceWorkloads::KIND_COUNT ? KIND_NAMES[index] : "?";
+}
+
+bool parseTaskKind(const std::string& text, TaskKind& kind)
+{
+    for (int i = 0; i < ReferenceWorkloads::KIND_COUNT; ++i) {
+        if (equalsIgnoreCase(text, KIND_NAMES[i]) || (text.size() == 1 && text[0] == char('0' + i))) {
+            kind = static_cast<TaskKind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseTaskKindMix(const std::string& text, std::vector<TaskKindWeight>& mix)
+{
+    std::vector<TaskKindWeight> parsed;
+    double total = 0.0;
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t end = text.find(',', begin);
+        if (end == std::string::npos) end = text.size();
+        std::string item = text.substr(begin, end - begin);
+        size_t colon = item.find(':');
+        TaskKindWeight entry;
+        if (!parseTaskKind(item.substr(0, colon), entry.kind)) return false;
+        if (colon != std::string::npos) {
+            char* tail = nullptr;
+            entry.weight = strtod(item.c_str() + colon + 1, &tail);
+            if (tail == item.c_str() + colon + 1 || *tail != '\0' || !(entry.weight >= 0)) return false;
+        }
+        total += entry.weight;
+        parsed.push_back(entry);
+        begin = end + 1;
+    }
+    if (total <= 0) return false;
+    mix = parsed;
+    return true;
+}
+
+void ReferenceWorkloads::calibrate()
+{
+    std::call_once(g_calibrated, []() {
+        for (int i = int(TaskKind::MatMul); i <= int(TaskKind::PointerChase); ++i) {
+            TaskKind kind = static_cast<TaskKind>(i);
+            runUnits(kind, 1, nullptr, 0);      // 预热：创建共享数据和线程缓冲
+            // 跑CALIBRATE_ROUNDS轮取最快的一轮，排除被抢占、降频等干扰
+            double best = 0.0;
+            for (int round = 0; round < CALIBRATE_ROUNDS; ++round) {
+                int64_t done = 0;
+                int64_t batch = 1;
+                auto start = Clock::now();
+                double elapsedMs = 0.0;
+                while (elapsedMs < CALIBRATE_MS) {
+                    runUnits(kind, batch, nullptr, 0);
+                    done += batch;
+                    elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                    if (elapsedMs < CALIBRATE_MS / 4) batch *= 2;
+                }
+                best = std::max(best, double(done) / elapsedMs);
+            }
+            g_unitsPerMs[i] = best;
+        }
+        // MixedIo的计算部分就是Checksum
+        g_unitsPerMs[int(TaskKind::MixedIo)] = 1.0;
+    });
+}
+
+double ReferenceWorkloads::unitsPerMs(TaskKind kind)
+{
+    calibrate();
+    int index = int(kind);
+    return index >= 0 && index < KIND_COUNT ? g_unitsPerMs[index] : 1.0;
+}
+
+const char* ReferenceWorkloads::unitName(TaskKind kind)
+{
+    int index = int(kind);
+    return index >= 0 && index < KIND_COUNT ? UNIT_NAMES[index] : "?";
+}
+
+void ReferenceWorkloads::run(TaskKind kind, int workMs, const void* payload, size_t payloadSize)
+{
+    if (workMs <= 0) return;
+    if (kind == TaskKind::Sleep) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(workMs));
+        return;
+    }
+    calibrate();
+    if (kind == TaskKind::MixedIo) {
+        // 每片前一半做哈希、后一半阻塞等待（相当于一次同步I/O），CPU利用率约50%
+        double checksumPerMs = g_unitsPerMs[int(TaskKind::Checksum)];
+        for (int doneMs = 0; doneMs < workMs; doneMs += MIXED_SLICE_MS) {
+            int sliceMs = std::min(MIXED_SLICE_MS, workMs - doneMs);
+            double computeMs = sliceMs / 2.0;
+            checksumUnits(std::max<int64_t>(1, int64_t(std::llround(computeMs * checksumPerMs))), payload, payloadSize);
+            std::this_thread::sleep_for(std::chrono::microseconds(int64_t((sliceMs - computeMs) * 1000)));
+        }
+        return;
+    }
+    int64_t units = std::max<int64_t>(1, int64_t(std::llround(workMs * g_unitsPerMs[int(kind)])));
+    runUnits(kind, units, payload, payloadSize);
+}
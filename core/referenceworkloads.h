@@ -0,0 +1,45 @@
+#ifndef REFERENCEWORKLOADS_H
+#define REFERENCEWORKLOADS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tasklist.h"
+
+/*
+ * 参考负载：任务真正占用CPU、缓存和内存带宽，而不是sleep
+ * 1. 每种TaskKind定义一个工作单元，校准时在单个线程上各跑几轮、每轮约CALIBRATE_MS毫秒，测出每毫秒能做多少个单元；
+ *    之后totalTimeMs毫秒的任务做totalTimeMs*unitsPerMs个单元。多个线程同时跑会争用缓存和内存带宽，
+ *    实际耗时随之变长，线程数-吞吐曲线因此能反映硬件的极限。
+ * 2. 大块只读数据（MemStream的源、PointerChase的链表、Checksum的默认缓冲）全局共享一份，第一次用到时创建；
+ *    要写的（矩阵、memcpy目标）每个线程一份thread_local。
+ * 3. 计算结果累加到全局原子变量，防止被编译器优化掉。
+ * 4. 线程安全。calibrate()只做一次，最好在线程池开始干活前调用；没调用时第一次run()会在当时的线程上做。
+ */
+
+struct TaskKindWeight
+{
+    TaskKind kind = TaskKind::Sleep;
+    double weight = 1.0;
+};
+
+const char* taskKindName(TaskKind kind);
+// 名字不区分大小写：sleep matmul checksum memstream chase mixedio，或编号0~5
+bool parseTaskKind(const std::string& text, TaskKind& kind);
+// 如"matmul:1,chase:2"，失败返回false且不改mix
+bool parseTaskKindMix(const std::string& text, std::vector<TaskKindWeight>& mix);
+
+struct ReferenceWorkloads
+{
+    static constexpr int KIND_COUNT = 6;
+    static constexpr int CALIBRATE_MS = 20;
+
+    static void calibrate();
+    static double unitsPerMs(TaskKind kind);
+    static const char* unitName(TaskKind kind);
+    // 在当前线程上做workMs毫秒（按校准折算）的kind负载；payload不为空时Checksum/MixedIo对它做哈希
+    static void run(TaskKind kind, int workMs, const void* payload, size_t payloadSize);
+};
+
+#endif // REFERENCEWORKLOADS_H
@@ -0,0 +1,100 @@
+#include "scheduler.h"
+#include "tasklist.h"
+#include <algorithm>
+
+// 静态策略插入时直接有序插入，O(n)遍历链表，不再整队重排
+
+// ============================FIFO============================
+void FIFOScheduler::insertByPolicy(TaskList &tasks, TaskNode* node) {
+    tasks.pushBack(node);
+}
+void FIFOScheduler::sortQueue(TaskList &tasks) {
+    tasks.sort([](const Task& a, const Task& b) {
+        return a.id < b.id;
+    });
+}
+// ============================LIFO============================
+void LIFOScheduler::insertByPolicy(TaskList &tasks, TaskNode* node) {
+    tasks.pushFront(node);
+}
+void LIFOScheduler::sortQueue(TaskList &tasks) {
+    tasks.sort([](const Task& a, const Task& b) {
+        return a.id > b.id;
+    });
+}
+// ============================SJF============================
+void SJFScheduler::insertByPolicy(TaskList &tasks, TaskNode* node) {
+    tasks.insertSorted(node, [](const Task& a, const Task& b) {
+        return a.totalTimeMs < b.totalTimeMs;
+    });
+}
+void SJFScheduler::sortQueue(TaskList &tasks) {
+    tasks.sort([](const Task& a, const Task& b) {
+        return a.totalTimeMs < b.totalTimeMs;
+    });
+}
+// ============================LJF============================
+void LJFScheduler::insertByPolicy(TaskList &tasks, TaskNode* node) {
+    tasks.insertSorted(node, [](const Task& a, const Task& b) {
+        return a.totalTimeMs > b.totalTimeMs;
+    });
+}
+void LJFScheduler::sortQueue(TaskList &tasks) {
+    tasks.sort([](const Task& a, const Task& b) {
+        return a.totalTimeMs > b.totalTimeMs;
+    });
+}
+// ============================PRIO============================
+void PRIOScheduler::insertByPolicy(TaskList &tasks, TaskNode* node) {
+    tasks.insertSorted(node, [](const Task& a, const Task& b) {
+        return a.priority > b.priority;
+    });
+}
+void PRIOScheduler::sortQueue(TaskList &tasks) {
+    tasks.sort([](const Task& a, const Task& b) {
+        return a.priority > b.priority;
+    });
+}
+// ============================HRRN============================
+void HRRNScheduler::insertByPolicy(TaskList &tasks, TaskNode* node) {
+    tasks.pushBack(node);
+    sortQueue(tasks);
+}
+void HRRNScheduler::sortQueue(TaskList &tasks) {
+    int currentTime = currentTimeOfDayMs();
+
+    tasks.sort([currentTime](const Task& a, const Task& b) {
+        int waitTimeA = currentTime - a.arrivalTimestampMs;
+        int waitTimeB = currentTime - b.arrivalTimestampMs;
+        
+        double responseRatioA = (waitTimeA + a.totalTimeMs) / (double)a.totalTimeMs;
+        double responseRatioB = (waitTimeB + b.totalTimeMs) / (double)b.totalTimeMs;
+        
+        return responseRatioA > responseRatioB; // 响应比高的排在前面
+    });
+
+}
+// ============================工厂============================
+TaskScheduler* createScheduler(SchedulePolicy policy) {
+    switch (policy) {
+        case SchedulePolicy::FIFO: return new FIFOScheduler();
+        case SchedulePolicy::LIFO: return new LIFOScheduler();
+        case SchedulePolicy::SJF:  return new SJFScheduler();
+        case SchedulePolicy::LJF:  return new LJFScheduler();
+        case SchedulePolicy::PRIO: return new PRIOScheduler();
+        case SchedulePolicy::HRRN: return new HRRNScheduler();
+        default:                   return new FIFOScheduler();
+    }
+}
+
+const char* schedulePolicyName(SchedulePolicy policy) {
+    switch (policy) {
+        case SchedulePolicy::FIFO: return "FIFO";
+        case SchedulePolicy::LIFO: return "LIFO";
+        case SchedulePolicy::SJF:  return "SJF";
+        case SchedulePolicy::LJF:  return "LJF";
+        case SchedulePolicy::PRIO: return "PRIO";
+        case SchedulePolicy::HRRN: return "HRRN";
+        default:                   return "FIFO";
+    }
+}
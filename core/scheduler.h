@@ -1,10 +1,10 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
-#include <QList>
-
 // 前向声明，避免循环依赖
 struct Task;
+struct TaskNode;
+class TaskList;
 
 enum class SchedulePolicy
 {
@@ -20,9 +20,9 @@ class TaskScheduler
 {
 public:
     virtual ~TaskScheduler() = default;
-    // 插入并排序
-    virtual void insertByPolicy(QList<Task> &tasks, const Task& task) = 0;
-    virtual void sortQueue(QList<Task> &tasks) = 0;
+    // 插入并排序（只挂接节点，不拷贝Task）
+    virtual void insertByPolicy(TaskList &tasks, TaskNode* node) = 0;
+    virtual void sortQueue(TaskList &tasks) = 0;
     virtual bool needDynamicSort() const { return false; }
 };
 
@@ -34,8 +34,8 @@ class FIFOScheduler : public TaskScheduler
 {
 public:
     ~FIFOScheduler() override = default;
-    void insertByPolicy(QList<Task> &tasks, const Task& task) override;
-    void sortQueue(QList<Task> &tasks) override;
+    void insertByPolicy(TaskList &tasks, TaskNode* node) override;
+    void sortQueue(TaskList &tasks) override;
 };
 
 /* 后进先出LIFO
@@ -46,40 +46,40 @@ class LIFOScheduler : public TaskScheduler
 {
 public:
     ~LIFOScheduler() override = default;
-    void insertByPolicy(QList<Task> &tasks, const Task& task) override;
-    void sortQueue(QList<Task> &tasks) override;
+    void insertByPolicy(TaskList &tasks, TaskNode* node) override;
+    void sortQueue(TaskList &tasks) override;
 };
 
 /* 短作业优先SJF
-插入：按总耗时排序（升序）
+插入：按总耗时有序插入（升序）
 取出：takeFirst（取队头）
 */
 class SJFScheduler : public TaskScheduler
 {
 public:
     ~SJFScheduler() override = default;
-    void insertByPolicy(QList<Task> &tasks, const Task& task) override;
-    void sortQueue(QList<Task> &tasks) override;
+    void insertByPolicy(TaskList &tasks, TaskNode* node) override;
+    void sortQueue(TaskList &tasks) override;
 };
 
 /* 长作业优先LJF
-插入：按总耗时排序（降序）
+插入：按总耗时有序插入（降序）
 取出：takeFirst（取队头）
 */
 class LJFScheduler : public TaskScheduler
 {
 public:
     ~LJFScheduler() override = default;
-    void insertByPolicy(QList<Task> &tasks, const Task& task) override;
-    void sortQueue(QList<Task> &tasks) override;
+    void insertByPolicy(TaskList &tasks, TaskNode* node) override;
+    void sortQueue(TaskList &tasks) override;
 };
 
 class PRIOScheduler : public TaskScheduler
 {
 public:
     ~PRIOScheduler() override = default;
-    void insertByPolicy(QList<Task> &tasks, const Task& task) override;
-    void sortQueue(QList<Task> &tasks) override;
+    void insertByPolicy(TaskList &tasks, TaskNode* node) override;
+    void sortQueue(TaskList &tasks) override;
 };
 /* 最高响应比优先HRRN
 插入：append（加到队尾）
@@ -90,9 +90,14 @@ class HRRNScheduler : public TaskScheduler
 {
 public:
     ~HRRNScheduler() override = default;
-    void insertByPolicy(QList<Task> &tasks, const Task& task) override;
-    void sortQueue(QList<Task> &tasks) override;
+    void insertByPolicy(TaskList &tasks, TaskNode* node) override;
+    void sortQueue(TaskList &tasks) override;
     bool needDynamicSort() const override { return true; }
 };
 
+// 根据策略创建调度器（调用方负责释放）
+TaskScheduler* createScheduler(SchedulePolicy policy);
+// 策略名，用于日志和报表
+const char* schedulePolicyName(SchedulePolicy policy);
+
 #endif // SCHEDULER_H
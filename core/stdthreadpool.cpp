@@ -0,0 +1,380 @@
+#include "stdthreadpool.h"
+#include "threadcpu.h"
+#include "referenceworkloads.h"
+#include <algorithm>
+#include <chrono>
+
+StdThreadPool::StdThreadPool(int minNum, int maxNum, PoolObserver* observer, PayloadReleaser releaser)
+    : m_observer(observer)
+    , m_progressStepMs(observer ? observer->progressStepMs() : 0)
+    , m_releaser(std::move(releaser))
+    , m_minNum(minNum < 0 ? 0 : minNum)
+    , m_maxNum(maxNum < m_minNum ? m_minNum : maxNum)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < m_minNum; ++i) {
+            spawnThreadLocked();
+        }
+    }
+    m_manager = std::thread(&StdThreadPool::managerLoop, this);
+}
+
+StdThreadPool::~StdThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_notEmpty.notify_all();
+    m_managerWake.notify_all();
+    m_manager.join();
+
+    // 关闭后不会再创建线程，可以在锁外join
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+    m_workers.clear();
+
+    // 未执行的任务，释放其载荷
+    Task task;
+    while (m_queue.takeFirst(task)) {
+        releasePayload(task);
+        task.discard();
+        if (!task.internal) m_counters.cancelled.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_counters.queuedTasks.store(0, std::memory_order_relaxed);
+    m_idle.notify_all();
+}
+
+void StdThreadPool::spawnThreadLocked()
+{
+    auto worker = std::make_unique<Worker>();
+    worker->id = m_nextThreadId++;
+    worker->thread = std::thread(&StdThreadPool::workerLoop, this, worker.get());
+    m_aliveNum++;
+    m_counters.aliveThreads.store(m_aliveNum, std::memory_order_relaxed);
+    m_workers.emplace_back(std::move(worker));
+}
+
+void StdThreadPool::workerLoop(Worker* worker)
+{
+    if (m_observer) m_observer->onThreadSpawned(worker->id);
+    ThreadCpuSample cpuSample;
+    while (true) {
+        Task task;
+        bool shouldExit = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // 没有可调度的任务（队列为空，或剩余内存预算放不下任何任务）时等待
+            m_notEmpty.wait(lock, [this]() {
+                return m_shutdown || m_exitNum > 0 || m_queue.hasDispatchableTask(m_memoryBudget, m_memReserved);
+            });
+            // 缩容退出
+            if (m_exitNum > 0 && m_aliveNum > m_minNum) {
+                m_exitNum--;
+                shouldExit = true;
+            } else if (m_exitNum > 0) {
+                // 已到最小线程数，取消剩余的缩容请求，避免空转
+                m_exitNum = 0;
+            }
+            // 线程池关闭
+            if (m_shutdown) shouldExit = true;
+            if (shouldExit) {
+                m_aliveNum--;
+                m_counters.aliveThreads.store(m_aliveNum, std::memory_order_relaxed);
+                worker->exited = true;
+            } else {
+                // 按内存预算取任务，取不到则回去继续等待
+                if (!m_queue.takeTask(task, m_memoryBudget, m_memReserved)) continue;
+                m_busyNum++;
+                m_memReserved += task.memSize;  // 占用内存预算
+                worker->curTaskId = task.id;
+                m_counters.busyThreads.store(m_busyNum, std::memory_order_relaxed);
+                if (!task.internal) {
+                    m_counters.queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                    if (m_observer) m_observer->onTaskDispatchedLocked(worker->id, task);
+                }
+            }
+        }   // 释放锁
+        if (shouldExit) {
+            if (m_observer) m_observer->onThreadExited(worker->id);
+            return;
+        }
+
+        // 内部任务（parallelFor的领取票）只占用线程，不计入直方图和计数，也不通知观察者
+        const bool counted = !task.internal;
+        const size_t memSize = task.memSize;    // releasePayload会清零，归还预算时要用
+        if (counted) {
+            int waitMs = currentTimeOfDayMs() - task.arrivalTimestampMs;
+            m_counters.waitTime.observe(int64_t(waitMs) * 1000);
+            if (m_observer) m_observer->onTaskStarted(worker->id, task);
+        }
+
+        // 执行任务，前后各采样一次线程CPU时间
+        cpuSample = sampleThreadCpu();
+        auto wallStart = std::chrono::steady_clock::now();
+        executeTask(worker->id, task);
+        int64_t wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wallStart).count();
+        int64_t cpuNs = sampleThreadCpu().cpuNs - cpuSample.cpuNs;
+        task.finishTimestampMs = currentTimeOfDayMs();
+
+        if (counted) {
+            m_counters.runTime.observe(wallNs / 1000);
+            m_counters.latency.observe(int64_t(task.finishTimestampMs - task.arrivalTimestampMs) * 1000);
+            m_counters.finished.fetch_add(1, std::memory_order_relaxed);
+            if (m_observer) m_observer->onTaskFinished(worker->id, task, wallNs, cpuNs);
+        }
+        // 任务完成后自动释放载荷
+        releasePayload(task);
+
+        bool idle = false;
+        bool budgetReleased = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyNum--;
+            m_memReserved -= memSize;   // 归还内存预算
+            worker->curTaskId = -1;
+            m_counters.busyThreads.store(m_busyNum, std::memory_order_relaxed);
+            idle = m_busyNum == 0 && m_queue.isEmpty();
+            budgetReleased = m_memoryBudget > 0 && memSize > 0;
+        }
+        // 归还了内存预算，之前放不下的任务可能可以调度了
+        if (budgetReleased) m_notEmpty.notify_all();
+        if (idle) m_idle.notify_all();
+    }
+}
+
+void StdThreadPool::managerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_shutdown) {
+        m_managerWake.wait_for(lock, std::chrono::milliseconds(MANAGER_CHECK_INTERVAL_MS), [this]() { return m_shutdown; });
+        if (m_shutdown) break;
+
+        // 回收已退出的线程
+        std::vector<std::unique_ptr<Worker>> exited;
+        for (auto it = m_workers.begin(); it != m_workers.end();) {
+            if ((*it)->exited) {
+                exited.emplace_back(std::move(*it));
+                it = m_workers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        // 扩容/缩容规则见PoolSizing
+        const int queueSize = m_queue.taskNumber();
+        const int aliveNum = m_aliveNum;
+        const int busyNum = m_busyNum;
+        int spawn = PoolSizing::expandCount(queueSize, aliveNum, m_maxNum);
+        for (int i = 0; i < spawn; ++i) {
+            spawnThreadLocked();
+        }
+        int exitRequests = 0;
+        if (PoolSizing::shouldShrink(busyNum, aliveNum, m_minNum)) {
+            m_exitNum = THREAD_EXPAND_NUMBER;
+            exitRequests = THREAD_EXPAND_NUMBER;
+        }
+
+        lock.unlock();
+        if (exitRequests > 0) m_notEmpty.notify_all();
+        for (auto& worker : exited) worker->thread.join();
+        if (m_observer) m_observer->onSizingChecked(queueSize, aliveNum, busyNum, spawn, exitRequests);
+        lock.lock();
+    }
+}
+
+void StdThreadPool::enqueueLocked(Task&& task)
+{
+    const Task& queued = m_queue.addTask(std::move(task));
+    if (m_observer && !queued.internal) m_observer->onTaskEnqueuedLocked(queued);
+}
+
+void StdThreadPool::addTask(Task&& task)
+{
+    // 内部任务不记轨迹、不计数（见Task::internal）
+    const bool counted = !task.internal;
+    if (counted && m_workloadRecorder.isOpen()) m_workloadRecorder.record(&task, 1);
+    bool accepted = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_shutdown) {
+            enqueueLocked(std::move(task));
+            if (counted) {
+                m_counters.submitted.fetch_add(1, std::memory_order_relaxed);
+                m_counters.queuedTasks.fetch_add(1, std::memory_order_relaxed);
+            }
+            accepted = true;
+        }
+    }
+    if (!accepted) {
+        // 线程池已关闭，task没有被移走
+        releasePayload(task);
+        task.discard();
+        if (counted) m_counters.cancelled.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_notEmpty.notify_one();
+}
+
+void StdThreadPool::addTasks(std::vector<Task>&& tasks)
+{
+    if (tasks.empty()) return;
+    if (m_workloadRecorder.isOpen()) m_workloadRecorder.record(tasks.data(), tasks.size());
+    int count = static_cast<int>(tasks.size());
+    bool accepted = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_shutdown) {
+            for (auto& task : tasks) enqueueLocked(std::move(task));
+            m_counters.submitted.fetch_add(count, std::memory_order_relaxed);
+            m_counters.queuedTasks.fetch_add(count, std::memory_order_relaxed);
+            accepted = true;
+        }
+    }
+    if (!accepted) {
+        for (auto& task : tasks) {
+            releasePayload(task);
+            task.discard();
+        }
+        m_counters.cancelled.fetch_add(count, std::memory_order_relaxed);
+    } else {
+        // 一次唤醒所有等待线程，由它们自行竞争取任务
+        m_notEmpty.notify_all();
+    }
+    tasks.clear();
+}
+
+int StdThreadPool::allocateTaskIds(int count)
+{
+    return m_nextTaskId.fetch_add(count, std::memory_order_relaxed);
+}
+
+ParallelDetail::ParallelJob::Submitter StdThreadPool::taskSubmitter()
+{
+    return [this](Task&& task) {
+        task.id = allocateTaskIds(1);
+        addTask(std::move(task));
+    };
+}
+
+int StdThreadPool::getOldestPendingTaskId() const
+{
+    // 先读下一个ID：之后提交的任务ID都不会比它小
+    int oldest = m_nextTaskId.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.forEachTask([&oldest](const Task& task) { oldest = std::min(oldest, task.id); });
+    for (const auto& worker : m_workers) {
+        if (worker->curTaskId >= 0) oldest = std::min(oldest, worker->curTaskId);
+    }
+    return oldest;
+}
+
+bool StdThreadPool::waitForDone(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto done = [this]() { return (m_queue.isEmpty() && m_busyNum == 0) || m_shutdown; };
+    if (timeoutMs < 0) {
+        m_idle.wait(lock, done);
+        return true;
+    }
+    return m_idle.wait_for(lock, std::chrono::milliseconds(timeoutMs), done);
+}
+
+void StdThreadPool::setSchedulePolicy(SchedulePolicy policy)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.setScheduler(std::unique_ptr<TaskScheduler>(createScheduler(policy)));
+    m_policy = policy;
+    m_counters.policy.store(int(policy), std::memory_order_relaxed);
+    if (m_observer) m_observer->onPolicyChangedLocked(policy);
+}
+
+void StdThreadPool::setMemoryBudget(size_t budgetBytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_memoryBudget = budgetBytes;
+    }
+    // 预算变化后重新检查等待中的任务
+    m_notEmpty.notify_all();
+}
+
+size_t StdThreadPool::getMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryBudget;
+}
+
+size_t StdThreadPool::getMemoryReserved() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memReserved;
+}
+
+uint64_t StdThreadPool::getQueueAllocationCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.allocationCount();
+}
+
+uint64_t StdThreadPool::getSubmittedTaskNumber() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.enqueueCount();
+}
+
+SchedulePolicy StdThreadPool::getSchedulePolicy() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_policy;
+}
+
+void StdThreadPool::setThreadRange(int minNum, int maxNum)
+{
+    if (minNum < 0) minNum = 0;
+    if (maxNum < minNum) maxNum = minNum;
+    bool shrink = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_shutdown) return;
+        m_minNum = minNum;
+        m_maxNum = maxNum;
+        // 低于新的最小值：立即补齐
+        while (m_aliveNum < m_minNum) {
+            spawnThreadLocked();
+        }
+        // 高于新的最大值：让多出来的线程空闲后退出（忙线程执行完当前任务再退出）
+        if (m_aliveNum > m_maxNum) {
+            m_exitNum = m_aliveNum - m_maxNum;
+            shrink = true;
+        }
+    }
+    if (shrink) m_notEmpty.notify_all();
+}
+
+void StdThreadPool::executeTask(int threadId, const Task& task)
+{
+    if (task.function) {
+        task.function(task.arg);
+    } else if (m_progressStepMs > 0 && !task.internal) {
+        // 观察者要进度：分段执行，每段结束报告已完成的时间
+        for (int elapsedMs = 0; elapsedMs < task.totalTimeMs;) {
+            int stepMs = std::min(m_progressStepMs, task.totalTimeMs - elapsedMs);
+            ReferenceWorkloads::run(task.kind, stepMs, task.memPtr, task.memSize);
+            elapsedMs += stepMs;
+            m_observer->onTaskProgress(threadId, task, elapsedMs);
+        }
+    } else if (task.totalTimeMs > 0) {
+        ReferenceWorkloads::run(task.kind, task.totalTimeMs, task.memPtr, task.memSize);
+    }
+}
+
+void StdThreadPool::releasePayload(Task& task)
+{
+    if (task.memPtr && m_releaser) {
+        m_releaser(task.memPtr, task.memSize);
+    }
+    task.memPtr = nullptr;
+    task.memSize = 0;
+}
@@ -0,0 +1,147 @@
+#ifndef STDTHREADPOOL_H
+#define STDTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "taskqueue.h"
+#include "poolcounters.h"
+#include "poolobserver.h"
+#include "poolsizing.h"
+#include "workloadtrace.h"
+#include "parallelfor.h"
+
+/*
+ * 不依赖Qt的线程池（std::thread + std::mutex/std::condition_variable + 原子计数器）
+ * 1. 这是唯一的线程池引擎：就绪队列（TaskQueue，6种调度器和内存预算）、工作线程和管理线程（扩缩容规则见PoolSizing）都在这里。
+ * 2. 状态变化不发信号，只更新PoolCounters并同步调用PoolObserver；热路径上没有事件投递和内存分配。
+ * 3. Task::function不为空时在工作线程里调用function(arg)；为空时按totalTimeMs和kind模拟负载（见referenceworkloads.h）。
+ * 4. 任务完成后载荷（memPtr/memSize）交给PayloadReleaser释放；没有设置时载荷归调用方管理。
+ * 5. 可视化快照、事件流、时间线和信号由Qt版ThreadPool通过PoolObserver在外面一层做，这里不含。
+ * 6. 析构时等正在执行的任务结束，排队中的任务直接丢弃（计入cancelled）。
+ */
+class StdThreadPool
+{
+public:
+    using PayloadReleaser = std::function<void(void* ptr, size_t size)>;
+
+    static constexpr int MANAGER_CHECK_INTERVAL_MS = PoolSizing::CHECK_INTERVAL_MS;
+    static constexpr int THREAD_EXPAND_NUMBER = PoolSizing::EXPAND_NUMBER;
+
+    StdThreadPool(int minNum, int maxNum, PoolObserver* observer = nullptr, PayloadReleaser releaser = nullptr);
+    ~StdThreadPool();
+    StdThreadPool(const StdThreadPool&) = delete;
+    StdThreadPool& operator=(const StdThreadPool&) = delete;
+
+    /// 任务相关/////////
+    void addTask(Task&& task);
+    // 批量添加，一次加锁、一次唤醒
+    void addTasks(std::vector<Task>&& tasks);
+    // 分配count个连续的任务ID，返回第一个
+    int allocateTaskIds(int count);
+    // 等到队列为空且没有线程在执行任务；timeoutMs<0表示一直等，超时返回false
+    bool waitForDone(int timeoutMs = -1);
+    // 排队中和执行中任务的最小ID，没有时返回下一个要分配的ID：比它小的已提交任务都已结束。
+    // 要遍历队列，只适合偶尔调用
+    int getOldestPendingTaskId() const;
+    // 持锁调用inspect(const TaskQueue&)读取排队中的任务；inspect里不能调用线程池的接口（同PoolObserver的Locked回调）
+    template <typename Inspect>
+    void inspectQueue(Inspect&& inspect) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        inspect(static_cast<const TaskQueue&>(m_queue));
+    }
+
+    // 数据并行：懒惰二分拆分区间，调用线程一起干活，见parallelfor.h
+    template <typename Body>
+    void parallelFor(int64_t begin, int64_t end, int64_t grain, Body&& body)
+    {
+        ::parallelFor(taskSubmitter(), begin, end, grain, std::forward<Body>(body));
+    }
+    template <typename T, typename Map, typename Combine>
+    T parallelReduce(int64_t begin, int64_t end, int64_t grain, T identity, Map&& map, Combine&& combine)
+    {
+        return ::parallelReduce(taskSubmitter(), begin, end, grain, std::move(identity),
+                                std::forward<Map>(map), std::forward<Combine>(combine));
+    }
+
+    /// 线程与调度/////////
+    void setSchedulePolicy(SchedulePolicy policy);
+    SchedulePolicy getSchedulePolicy() const;
+    // 运行中调整最小/最大线程数：不足最小值立即创建，超过最大值的线程空闲后退出
+    void setThreadRange(int minNum, int maxNum);
+
+    // 内存预算（0表示不限）：调度时跳过放不下的任务，优先调度能放下的任务，规则见TaskQueue::takeTask
+    void setMemoryBudget(size_t budgetBytes);
+    size_t getMemoryBudget() const;
+    // 已预留内存：正在执行任务的memSize之和（占用预算的部分）
+    size_t getMemoryReserved() const;
+
+    // 负载轨迹：记录此后每次提交的任务，格式见workloadtrace.h
+    bool startWorkloadRecording(const std::string& path) { return m_workloadRecorder.open(path); }
+    void stopWorkloadRecording() { m_workloadRecorder.close(); }
+    uint64_t getRecordedTaskNumber() const { return m_workloadRecorder.recordCount(); }
+
+    // 以下读取都不加锁
+    int getWaitingTaskNumber() const { return m_counters.queuedTasks.load(std::memory_order_relaxed); }
+    int getBusyNumber() const { return m_counters.busyThreads.load(std::memory_order_relaxed); }
+    int getAliveNumber() const { return m_counters.aliveThreads.load(std::memory_order_relaxed); }
+    const PoolCounters& getCounters() const { return m_counters; }
+    // 节点池堆分配次数 / 累计入队次数（加锁读），两段时间内的差值之比即每个任务的平均分配次数
+    uint64_t getQueueAllocationCount() const;
+    uint64_t getSubmittedTaskNumber() const;
+
+private:
+    // parallelFor提交领取票用：分配ID后addTask
+    ParallelDetail::ParallelJob::Submitter taskSubmitter();
+
+    struct Worker
+    {
+        int id = 0;
+        std::thread thread;
+        bool exited = false;    // 由m_mutex保护，管理线程据此回收
+        int curTaskId = -1;     // 正在执行的任务（含内部任务），由m_mutex保护
+    };
+
+    void workerLoop(Worker* worker);
+    void managerLoop();
+    // 创建并启动一个工作线程（调用方需持有m_mutex）；观察者在新线程上收到onThreadSpawned
+    void spawnThreadLocked();
+    // 调用方需持有m_mutex
+    void enqueueLocked(Task&& task);
+    void executeTask(int threadId, const Task& task);
+    void releasePayload(Task& task);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;     // 有任务/需要缩容/关闭
+    std::condition_variable m_idle;         // 队列空且没有忙线程
+    std::condition_variable m_managerWake;  // 只用于关闭时唤醒管理线程
+
+    TaskQueue m_queue;
+    SchedulePolicy m_policy = SchedulePolicy::FIFO;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::thread m_manager;
+    PoolObserver* m_observer;
+    int m_progressStepMs = 0;       // 见PoolObserver::progressStepMs
+    PayloadReleaser m_releaser;
+    PoolCounters m_counters;
+    WorkloadTraceWriter m_workloadRecorder;
+
+    int m_minNum;
+    int m_maxNum;
+    int m_busyNum = 0;
+    int m_aliveNum = 0;
+    int m_exitNum = 0;
+    size_t m_memoryBudget = 0;      // 内存预算，0表示不限
+    size_t m_memReserved = 0;       // 正在执行任务占用的预算
+    bool m_shutdown = false;
+    int m_nextThreadId = 1;
+    std::atomic<int> m_nextTaskId{1};
+};
+
+#endif // STDTHREADPOOL_H
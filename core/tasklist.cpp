@@ -0,0 +1,99 @@
+#include "tasklist.h"
+#include <chrono>
+#include <ctime>
+
+// ============================TaskList============================
+void TaskList::insertBefore(TaskNode* pos, TaskNode* node)
+{
+    node->next = pos;
+    node->prev = pos ? pos->prev : m_tail;
+    if (node->prev) node->prev->next = node;
+    else m_head = node;
+    if (pos) pos->prev = node;
+    else m_tail = node;
+    m_size++;
+}
+
+void TaskList::remove(TaskNode* node)
+{
+    if (node->prev) node->prev->next = node->next;
+    else m_head = node->next;
+    if (node->next) node->next->prev = node->prev;
+    else m_tail = node->prev;
+    node->prev = node->next = nullptr;
+    m_size--;
+}
+
+TaskNode* TaskList::takeFirst()
+{
+    TaskNode* node = m_head;
+    if (node) remove(node);
+    return node;
+}
+
+void TaskList::relink()
+{
+    m_head = m_tail = nullptr;
+    for (TaskNode* node : m_scratch) {
+        node->prev = m_tail;
+        node->next = nullptr;
+        if (m_tail) m_tail->next = node;
+        else m_head = node;
+        m_tail = node;
+    }
+}
+
+// ============================TaskNodePool============================
+TaskNode* TaskNodePool::acquire(Task&& task)
+{
+    if (!m_freeList) {
+        // 空闲链表用完，整块申请CHUNK_SIZE个节点
+        std::unique_ptr<TaskNode[]> chunk(new TaskNode[CHUNK_SIZE]);
+        for (int i = 0; i < CHUNK_SIZE; ++i) {
+            chunk[i].next = m_freeList;
+            m_freeList = &chunk[i];
+        }
+        m_chunks.emplace_back(std::move(chunk));
+    }
+    TaskNode* node = m_freeList;
+    m_freeList = node->next;
+    node->prev = node->next = nullptr;
+    node->deferCount = 0;
+    node->task = std::move(task);
+    m_acquireCount++;
+    return node;
+}
+
+void TaskNodePool::release(TaskNode* node)
+{
+    node->task = Task();
+    node->prev = nullptr;
+    node->next = m_freeList;
+    m_freeList = node;
+}
+
+// ============================时间============================
+namespace {
+thread_local const int* t_virtualNowMs = nullptr;
+}
+
+void setThreadVirtualClock(const int* nowMs)
+{
+    t_virtualNowMs = nowMs;
+}
+
+int currentTimeOfDayMs()
+{
+    if (t_virtualNowMs) return *t_virtualNowMs;
+    using namespace std::chrono;
+    system_clock::time_point now = system_clock::now();
+    std::time_t seconds = system_clock::to_time_t(now);
+    std::tm local{};
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    int ms = int(duration_cast<milliseconds>(now.time_since_epoch()).count() % 1000);
+    return ((local.tm_hour * 60 + local.tm_min) * 60 + local.tm_sec) * 1000 + ms;
+}
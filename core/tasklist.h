@@ -0,0 +1,179 @@
+#ifndef TASKLIST_H
+#define TASKLIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+/*
+ * 任务和就绪队列的数据结构（不依赖Qt，由TaskQueue组合使用）
+ * 1. Task只能移动不能拷贝：从提交到工作线程全程std::move，memPtr等载荷不会被复制。
+ * 2. 队列是侵入式双向链表，节点从TaskNodePool的空闲链表中复用，稳态下入队/出队不再分配内存。
+ * 3. 这里都不加锁，由持有它们的队列负责同步。
+ */
+
+using callback = void(*)(void*);
+
+// 任务类型：Sleep只是等待totalTimeMs；其余为core/referenceworkloads.h里的真实负载，
+// 工作量按校准结果折算，使其在空闲CPU上约耗时totalTimeMs
+enum class TaskKind : uint8_t
+{
+    Sleep,
+    MatMul,         // 分块矩阵乘，算力受限
+    Checksum,       // 对载荷（或共享缓冲）做可向量化的哈希，带宽/算力均衡
+    MemStream,      // 大块memcpy，内存带宽受限
+    PointerChase,   // 随机链表遍历，内存延迟受限
+    MixedIo         // 计算与阻塞等待交替，模拟带I/O的任务
+};
+
+struct Task
+{
+    Task() = default;
+    // 只能移动，不能拷贝：载荷(memPtr/arg)的所有权随Task一起转移
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& other) noexcept { *this = std::move(other); }
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            id = other.id;
+            function = other.function;
+            cleanup = other.cleanup;
+            arg = std::exchange(other.arg, nullptr);
+            totalTimeMs = other.totalTimeMs;
+            priority = other.priority;
+            kind = other.kind;
+            internal = other.internal;
+            arrivalTimestampMs = other.arrivalTimestampMs;
+            finishTimestampMs = other.finishTimestampMs;
+            memSize = other.memSize;
+            memPtr = std::exchange(other.memPtr, nullptr);
+        }
+        return *this;
+    }
+
+    // 任务没有执行就被丢弃（线程池关闭时拒绝提交、析构时清出队列）时调用，释放arg
+    void discard()
+    {
+        if (cleanup && arg) cleanup(std::exchange(arg, nullptr));
+    }
+
+    int id = 0;
+    callback function = nullptr;
+    callback cleanup = nullptr;     // function的arg需要释放时设置，见discard()
+    void* arg = nullptr;
+    int totalTimeMs = 0;    // 总耗时
+    int priority = 0;       // 优先级
+    TaskKind kind = TaskKind::Sleep;
+    // 线程池自己拆出的任务（parallelFor的领取票）：不计入任务计数/统计、不记轨迹、不发任务事件
+    bool internal = false;
+    // 这里不需要加state字段，因为taskQueue里的task状态一定是waiting
+    int arrivalTimestampMs = 0;  // 到达时间
+    int finishTimestampMs = 0;   // 完成时间
+    // 内存字段
+    size_t memSize = 0;
+    void* memPtr = nullptr;
+};
+
+// 侵入式链表节点：Task直接嵌在节点里，入队出队只改指针
+struct TaskNode
+{
+    Task task;
+    TaskNode* prev = nullptr;
+    TaskNode* next = nullptr;
+    int deferCount = 0;     // 因内存预算不足被后面的任务插队的次数
+};
+
+/*
+侵入式双向链表（不拥有节点，节点由TaskNodePool管理）
+- 调度器通过它插入/排序，不再操作QList<Task>
+- sort时只排序节点指针，Task本身不移动
+*/
+class TaskList
+{
+public:
+    TaskNode* head() const { return m_head; }
+    TaskNode* tail() const { return m_tail; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    void pushBack(TaskNode* node) { insertBefore(nullptr, node); }
+    void pushFront(TaskNode* node) { insertBefore(m_head, node); }
+    // 插入到pos之前，pos为nullptr时插入到队尾
+    void insertBefore(TaskNode* pos, TaskNode* node);
+    // 从链表中摘下节点（不释放）
+    void remove(TaskNode* node);
+    TaskNode* takeFirst();
+
+    // 有序插入：插到第一个"比node更靠后"的节点之前，相等元素保持到达顺序
+    template<typename Less>
+    void insertSorted(TaskNode* node, Less less)
+    {
+        TaskNode* pos = m_head;
+        while (pos && !less(node->task, pos->task)) pos = pos->next;
+        insertBefore(pos, node);
+    }
+
+    // 稳定排序：只排指针再重新串链，Task不拷贝
+    template<typename Less>
+    void sort(Less less)
+    {
+        if (m_size < 2) return;
+        m_scratch.clear();
+        for (TaskNode* n = m_head; n; n = n->next) m_scratch.push_back(n);
+        std::stable_sort(m_scratch.begin(), m_scratch.end(), [&less](const TaskNode* a, const TaskNode* b) {
+            return less(a->task, b->task);
+        });
+        relink();
+    }
+
+    template<typename F>
+    void forEach(F&& f) const
+    {
+        for (const TaskNode* n = m_head; n; n = n->next) f(n->task);
+    }
+
+private:
+    void relink();
+
+    TaskNode* m_head = nullptr;
+    TaskNode* m_tail = nullptr;
+    int m_size = 0;
+    std::vector<TaskNode*> m_scratch;   // 排序用的指针缓冲区，复用避免每次分配
+};
+
+/*
+节点池：按块(CHUNK_SIZE个节点)向堆申请，用完的节点挂回空闲链表复用
+- 不加锁，和TaskList一起由TaskQueue的持有者加锁保护
+- allocationCount()统计真正的堆分配次数，用于衡量每个任务的分配开销
+*/
+class TaskNodePool
+{
+public:
+    TaskNodePool() = default;
+    TaskNodePool(const TaskNodePool&) = delete;
+    TaskNodePool& operator=(const TaskNodePool&) = delete;
+
+    TaskNode* acquire(Task&& task);
+    void release(TaskNode* node);
+
+    uint64_t allocationCount() const { return m_chunks.size(); }
+    uint64_t acquireCount() const { return m_acquireCount; }
+
+private:
+    static const int CHUNK_SIZE = 64;
+
+    std::vector<std::unique_ptr<TaskNode[]>> m_chunks;
+    TaskNode* m_freeList = nullptr;
+    uint64_t m_acquireCount = 0;
+};
+
+// 本地时间当天零点起的毫秒数（与QTime::currentTime().msecsSinceStartOfDay()一致），用于Task的到达/完成时间
+int currentTimeOfDayMs();
+// 仿真用：让本线程的currentTimeOfDayMs()改为读取*nowMs（虚拟时钟，见PoolSimulator），传nullptr恢复真实时钟
+void setThreadVirtualClock(const int* nowMs);
+
+#endif // TASKLIST_H
@@ -0,0 +1,87 @@
+#include "taskqueue.h"
+
+TaskQueue::TaskQueue()
+    : m_scheduler(createScheduler(SchedulePolicy::FIFO))
+{
+}
+
+TaskQueue::~TaskQueue()
+{
+    while (TaskNode* node = m_queue.takeFirst()) {
+        m_nodePool.release(node);
+    }
+}
+
+const Task& TaskQueue::addTask(Task&& task)
+{
+    TaskNode* node = m_nodePool.acquire(std::move(task));
+    m_sortedAtMs = -1;  // 新任务没有参与上次重排
+    m_scheduler->insertByPolicy(m_queue, node);
+    return node->task;
+}
+
+TaskNode* TaskQueue::findDispatchable(size_t budget, size_t reserved) const
+{
+    if (budget == 0) return m_queue.head();
+    size_t available = reserved < budget ? budget - reserved : 0;
+    for (TaskNode* node = m_queue.head(); node; node = node->next) {
+        // 超过整个预算的任务按预算计，等其他任务都释放后单独运行
+        size_t need = node->task.memSize < budget ? node->task.memSize : budget;
+        if (need <= available) return node;
+        // 已被插队太多次，后面的任务不能再越过它
+        if (node->deferCount >= MAX_DEFER_COUNT) return nullptr;
+    }
+    return nullptr;
+}
+
+TaskNode* TaskQueue::prepareDispatch(size_t budget, size_t reserved)
+{
+    if (m_queue.isEmpty()) return nullptr;
+    if (m_scheduler->needDynamicSort()) {
+        // HRRN按毫秒时刻算响应比：同一毫秒内且之后没有新任务插入，上次的顺序仍然有效，
+        // 刚做完hasDispatchableTask的takeTask直接沿用
+        int now = currentTimeOfDayMs();
+        if (now != m_sortedAtMs) {
+            m_scheduler->sortQueue(m_queue);
+            m_sortedAtMs = now;
+        }
+    }
+    return findDispatchable(budget, reserved);
+}
+
+bool TaskQueue::hasDispatchableTask(size_t budget, size_t reserved)
+{
+    // 不限预算时任何任务都能取，不用排序
+    if (budget == 0) return !m_queue.isEmpty();
+    return prepareDispatch(budget, reserved) != nullptr;
+}
+
+bool TaskQueue::takeTask(Task& task, size_t budget, size_t reserved)
+{
+    TaskNode* node = prepareDispatch(budget, reserved);
+    if (!node) return false;
+    // 被跳过的任务记一次插队
+    for (TaskNode* skipped = m_queue.head(); skipped != node; skipped = skipped->next) {
+        skipped->deferCount++;
+    }
+    m_queue.remove(node);
+    task = std::move(node->task);
+    m_nodePool.release(node);
+    return true;
+}
+
+bool TaskQueue::takeFirst(Task& task)
+{
+    TaskNode* node = m_queue.takeFirst();
+    if (!node) return false;
+    task = std::move(node->task);
+    m_nodePool.release(node);
+    return true;
+}
+
+void TaskQueue::setScheduler(std::unique_ptr<TaskScheduler> scheduler)
+{
+    m_scheduler = std::move(scheduler);
+    m_scheduler->sortQueue(m_queue);
+    m_sortedAtMs = -1;
+}
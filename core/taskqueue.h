@@ -0,0 +1,71 @@
+#ifndef TASKQUEUE_H
+#define TASKQUEUE_H
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "scheduler.h"
+#include "tasklist.h"
+
+/*
+ * 就绪队列：侵入式链表TaskList + 节点池TaskNodePool + 调度策略 + 内存预算下的取任务规则
+ * 1. 不加锁，由持有它的线程池（StdThreadPool::m_mutex）负责同步。
+ * 2. Task只能移动：入队时移进节点，出队时移给调用方，节点回到节点池复用。
+ * 3. 内存预算的规则（跳过放不下的任务、防止大任务饿死）只在这里实现一份。
+ */
+class TaskQueue
+{
+public:
+    TaskQueue();
+    ~TaskQueue();
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    // 按当前策略插入，返回队列里的任务（在它被取走之前有效）
+    const Task& addTask(Task&& task);
+
+    /*
+    内存预算下取任务（budget为0表示不限）：
+    - 按当前策略的顺序，取第一个 memSize <= budget - reserved 的任务，尽量贴近原策略
+    - 超过整个预算的大任务，只有在 reserved 为0时才能运行，避免永远无法调度
+    - 队头任务被插队 MAX_DEFER_COUNT 次后，后面的任务不能再越过它，防止大任务饿死
+    没有可调度的任务时返回false
+    */
+    bool takeTask(Task& task, size_t budget, size_t reserved);
+    // 是否有在预算内可调度的任务（与takeTask走同一个查找；不限预算时只看队列是否为空）
+    bool hasDispatchableTask(size_t budget, size_t reserved);
+    // 不管策略和预算，取队头（关闭时清空队列用）
+    bool takeFirst(Task& task);
+
+    // 按调度顺序遍历所有任务（不拷贝）
+    template<typename F>
+    void forEachTask(F&& f) const
+    {
+        m_queue.forEach(std::forward<F>(f));
+    }
+    int taskNumber() const { return m_queue.size(); }
+    bool isEmpty() const { return m_queue.isEmpty(); }
+
+    // 节点池堆分配次数 / 累计入队次数，两者之比即每个任务的平均分配次数
+    uint64_t allocationCount() const { return m_nodePool.allocationCount(); }
+    uint64_t enqueueCount() const { return m_nodePool.acquireCount(); }
+
+    // 切换调度策略，已排队的任务按新策略重排
+    void setScheduler(std::unique_ptr<TaskScheduler> scheduler);
+
+private:
+    static const int MAX_DEFER_COUNT = 8;
+
+    TaskNode* findDispatchable(size_t budget, size_t reserved) const;
+    // 动态策略（HRRN）先按当前时刻重排，再找可调度的节点；hasDispatchableTask和takeTask都走这里，
+    // 两者对“哪个任务放得下”的判断一致，工作线程不会被唤醒后取不到任务空转，也不会有任务可取却一直睡
+    // 重排结果按毫秒复用（见m_sortedAtMs），持锁期间的排序最多每毫秒一次
+    TaskNode* prepareDispatch(size_t budget, size_t reserved);
+
+    TaskList m_queue;
+    TaskNodePool m_nodePool;
+    std::unique_ptr<TaskScheduler> m_scheduler;
+    int m_sortedAtMs = -1;      // 动态策略上次重排的时刻，插入新任务或换策略后置-1
+};
+
+#endif // TASKQUEUE_H
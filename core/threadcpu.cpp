@@ -0,0 +1,57 @@
+#include "threadcpu.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+
+ThreadCpuSample sampleThreadCpu()
+{
+    ThreadCpuSample sample;
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        sample.cpuNs = int64_t(k.QuadPart + u.QuadPart) * 100;  // 单位100ns
+    }
+#else
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        sample.cpuNs = int64_t(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+#endif
+#if defined(RUSAGE_THREAD)
+    rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        sample.voluntarySwitches = usage.ru_nvcsw;
+        sample.involuntarySwitches = usage.ru_nivcsw;
+    }
+#endif
+#endif
+    return sample;
+}
+
+bool threadCpuTimeSupported()
+{
+#if defined(_WIN32) || defined(CLOCK_THREAD_CPUTIME_ID)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool contextSwitchesSupported()
+{
+#if !defined(_WIN32) && defined(RUSAGE_THREAD)
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,42 @@
+#ifndef THREADCPU_H
+#define THREADCPU_H
+
+#include <cstdint>
+
+/*
+ * 线程级CPU时间采样
+ * 1. 只能采样调用线程自己：Linux/macOS用CLOCK_THREAD_CPUTIME_ID，Windows用GetThreadTimes。
+ * 2. 上下文切换次数来自getrusage(RUSAGE_THREAD)，只有Linux支持，其他平台恒为0。
+ * 3. 线程阻塞在sleep/IO上时CPU时间不增长，所以“CPU时间/墙钟时间”才是真实的CPU占用。
+ */
+
+struct ThreadCpuSample
+{
+    int64_t cpuNs = 0;
+    int64_t voluntarySwitches = 0;       // 主动让出CPU（阻塞、sleep、等锁）
+    int64_t involuntarySwitches = 0;     // 时间片用完被抢占
+
+    ThreadCpuSample operator-(const ThreadCpuSample& other) const
+    {
+        ThreadCpuSample result;
+        result.cpuNs = cpuNs - other.cpuNs;
+        result.voluntarySwitches = voluntarySwitches - other.voluntarySwitches;
+        result.involuntarySwitches = involuntarySwitches - other.involuntarySwitches;
+        return result;
+    }
+    ThreadCpuSample& operator+=(const ThreadCpuSample& other)
+    {
+        cpuNs += other.cpuNs;
+        voluntarySwitches += other.voluntarySwitches;
+        involuntarySwitches += other.involuntarySwitches;
+        return *this;
+    }
+};
+
+// 采样调用线程的累计CPU时间和上下文切换次数
+ThreadCpuSample sampleThreadCpu();
+// 当前平台是否支持线程CPU时间 / 上下文切换计数
+bool threadCpuTimeSupported();
+bool contextSwitchesSupported();
+
+#endif // THREADCPU_H
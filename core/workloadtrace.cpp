@@ -0,0 +1,165 @@
+#include "workloadtrace.h"
+#include "tasklist.h"
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'T', 'P', 'W', 'T'};
+const size_t HEADER_SIZE = 16;
+const size_t MAX_RECORD_SIZE = 6 * 10;      // 6个字段，每个最多10字节
+
+size_t putVarint(uint8_t* out, uint64_t value)
+{
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = uint8_t(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = uint8_t(value);
+    return n;
+}
+
+bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+uint64_t zigzag(int64_t value)
+{
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value)
+{
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+} // namespace
+
+bool WorkloadTraceWriter::open(const std::string& path)
+{
+    close();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file = fopen(path.c_str(), "wb");
+    if (!m_file) return false;
+
+    uint8_t header[HEADER_SIZE] = {};
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    header[4] = VERSION;
+    uint64_t startUnixMs = uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    for (int i = 0; i < 8; ++i) header[8 + i] = uint8_t(startUnixMs >> (8 * i));
+    if (fwrite(header, 1, HEADER_SIZE, m_file) != HEADER_SIZE) {
+        fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+    m_start = std::chrono::steady_clock::now();
+    m_lastArrivalUs = 0;
+    m_lastFlushUs = 0;
+    m_records.store(0, std::memory_order_relaxed);
+    m_open.store(true, std::memory_order_release);
+    return true;
+}
+
+void WorkloadTraceWriter::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_open.store(false, std::memory_order_release);
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void WorkloadTraceWriter::record(const Task* tasks, size_t count)
+{
+    if (count == 0) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) return;
+    // 在锁内取时间，保证记录顺序与到达时刻一致（增量不会为负）
+    int64_t arrivalUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_start).count();
+    uint8_t buffer[MAX_RECORD_SIZE];
+    for (size_t i = 0; i < count; ++i) {
+        const Task& task = tasks[i];
+        size_t n = 0;
+        n += putVarint(buffer + n, uint64_t(i == 0 ? arrivalUs - m_lastArrivalUs : 0));
+        n += putVarint(buffer + n, uint64_t(task.totalTimeMs > 0 ? task.totalTimeMs : 0));
+        n += putVarint(buffer + n, zigzag(task.priority));
+        n += putVarint(buffer + n, uint64_t(task.memSize));
+        n += putVarint(buffer + n, i == 0 ? 1 : 0);
+        n += putVarint(buffer + n, uint64_t(task.kind));
+        fwrite(buffer, 1, n, m_file);     // FILE自带缓冲，这里不直接触发系统调用
+    }
+    m_lastArrivalUs = arrivalUs;
+    // 按时间间隔刷新，崩溃时丢失的记录有上限，又不会每批都触发一次write
+    if (arrivalUs - m_lastFlushUs >= int64_t(FLUSH_INTERVAL_MS) * 1000) {
+        fflush(m_file);
+        m_lastFlushUs = arrivalUs;
+    }
+    m_records.fetch_add(count, std::memory_order_relaxed);
+}
+
+bool WorkloadTraceReader::load(const std::string& path, std::vector<TraceRecord>& records, std::string* error,
+                               bool* truncated, uint64_t* startUnixMs)
+{
+    auto fail = [error](const char* message) {
+        if (error) *error = message;
+        return false;
+    };
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return fail("cannot open file");
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t n = 0;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + n);
+    fclose(file);
+
+    if (data.size() < HEADER_SIZE || memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) return fail("not a workload trace");
+    const uint8_t version = data[4];
+    if (version < 1 || version > WorkloadTraceWriter::VERSION) return fail("unsupported trace version");
+    const int fieldCount = version >= 2 ? 6 : 5;
+    if (startUnixMs) {
+        *startUnixMs = 0;
+        for (int i = 0; i < 8; ++i) *startUnixMs |= uint64_t(data[8 + i]) << (8 * i);
+    }
+
+    records.clear();
+    if (truncated) *truncated = false;
+    const uint8_t* p = data.data() + HEADER_SIZE;
+    const uint8_t* end = data.data() + data.size();
+    int64_t arrivalUs = 0;
+    uint32_t group = 0;
+    while (p < end) {
+        uint64_t fields[6] = {};
+        bool complete = true;
+        for (int i = 0; i < fieldCount; ++i) {
+            if (!getVarint(p, end, fields[i])) {
+                complete = false;
+                break;
+            }
+        }
+        if (!complete) {
+            if (truncated) *truncated = true;
+            break;
+        }
+        TraceRecord record;
+        arrivalUs += int64_t(fields[0]);
+        group += uint32_t(fields[4]);
+        record.arrivalUs = arrivalUs;
+        record.totalTimeMs = int(fields[1]);
+        record.priority = int(unzigzag(fields[2]));
+        record.memSize = fields[3];
+        record.group = group;
+        record.kind = uint8_t(fields[5]);
+        records.push_back(record);
+    }
+    return true;
+}
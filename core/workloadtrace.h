@@ -0,0 +1,78 @@
+#ifndef WORKLOADTRACE_H
+#define WORKLOADTRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct Task;
+
+/*
+ * 负载轨迹：记录每次提交的任务（到达时刻、执行时间、优先级、载荷大小、批次），之后可原样重放
+ * 文件格式（小端）：
+ *   头部16字节：魔数"TPWT"、版本u8(=2)、3字节保留、u64开始记录时的Unix毫秒时间
+ *   之后每个任务一条记录，全部为LEB128变长整数：
+ *     到达时刻增量(us) 执行时间(ms) 优先级(zigzag) 载荷字节数 批次增量 任务类型(TaskKind)
+ *   版本1没有任务类型字段，读出来都是TaskKind::Sleep。
+ *   到达时刻用单调时钟、相对开始记录的时刻；批次即一次addTask()/addTasks()调用，同一批的批次增量为0。
+ *   典型任务一条记录7~10字节。没有尾部；写入端每FLUSH_INTERVAL_MS把stdio缓冲刷到内核，
+ *   进程崩溃时丢掉最近这段时间内的记录，文件末尾可能留下一条不完整的记录（读取端会忽略）。
+ */
+
+struct TraceRecord
+{
+    int64_t arrivalUs = 0;      // 相对开始记录的时刻
+    int totalTimeMs = 0;
+    int priority = 0;
+    uint64_t memSize = 0;
+    uint32_t group = 0;         // 从1开始，同一次提交的任务相同
+    uint8_t kind = 0;           // TaskKind
+};
+
+// 写入端：线程安全，多个提交线程可以同时记录；记录顺序即到达顺序
+class WorkloadTraceWriter
+{
+public:
+    static const uint8_t VERSION = 2;
+    static const int FLUSH_INTERVAL_MS = 100;
+
+    WorkloadTraceWriter() = default;
+    ~WorkloadTraceWriter() { close(); }
+    WorkloadTraceWriter(const WorkloadTraceWriter&) = delete;
+    WorkloadTraceWriter& operator=(const WorkloadTraceWriter&) = delete;
+
+    // 打开（截断）文件并写头部；已在记录时先关闭之前的文件
+    bool open(const std::string& path);
+    void close();
+    // 提交路径先判断这个，未记录时不加锁
+    bool isOpen() const { return m_open.load(std::memory_order_acquire); }
+
+    // 记录一次提交的count个任务，它们属于同一批次
+    void record(const Task* tasks, size_t count);
+
+    uint64_t recordCount() const { return m_records.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex m_mutex;
+    std::atomic<bool> m_open{false};
+    FILE* m_file = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+    int64_t m_lastArrivalUs = 0;
+    int64_t m_lastFlushUs = 0;
+    std::atomic<uint64_t> m_records{0};
+};
+
+// 读取端：一次性读入整个文件
+class WorkloadTraceReader
+{
+public:
+    // 失败时返回false并填写error；文件末尾不完整的记录被忽略（truncated置true）
+    static bool load(const std::string& path, std::vector<TraceRecord>& records, std::string* error = nullptr,
+                     bool* truncated = nullptr, uint64_t* startUnixMs = nullptr);
+};
+
+#endif // WORKLOADTRACE_H
@@ -0,0 +1,392 @@
+#include "ganttview.h"
+#include <QDateTime>
+#include <QPainter>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace {
+    // 调度策略配色，按SchedulePolicy顺序
+    const QColor POLICY_COLORS[] = {
+        QColor(60, 140, 220),   // FIFO
+        QColor(150, 80, 200),   // LIFO
+        QColor(60, 180, 60),    // SJF
+        QColor(230, 140, 30),   // LJF
+        QColor(220, 60, 60),    // PRIO
+        QColor(40, 170, 170),   // HRRN
+    };
+    // 坐标轴刻度间隔候选（毫秒），取相邻刻度不小于MIN_TICK_SPACING像素的最小值
+    const qint64 TICK_STEPS_MS[] = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500,
+        1000, 2000, 5000, 10000, 30000, 60000, 120000, 300000, 600000, 1800000, 3600000
+    };
+    const int MIN_TICK_SPACING = 90;
+    const QColor LANE_COLOR(245, 245, 245);
+}
+
+GanttView::GanttView(QWidget* parent)
+    : QAbstractScrollArea(parent)
+{
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setMinimumHeight(AXIS_HEIGHT + 4 * (LANE_HEIGHT + LANE_SPACING) + horizontalScrollBar()->sizeHint().height());
+    m_timer.setInterval(REFRESH_MS);
+    connect(&m_timer, &QTimer::timeout, this, &GanttView::refresh);
+}
+
+void GanttView::setTimeline(std::shared_ptr<PoolTimeline> timeline)
+{
+    m_timeline = std::move(timeline);
+    m_lanes.clear();
+    m_laneCursor.clear();
+    m_laneGeneration = 0;
+    m_follow = true;
+    invalidateCache();
+    if (m_timeline) {
+        m_timer.start();
+        refresh();
+    } else {
+        m_timer.stop();
+        updateScrollBars();
+    }
+}
+
+void GanttView::setColorMode(GanttColorMode mode)
+{
+    if (m_colorMode == mode) return;
+    m_colorMode = mode;
+    invalidateCache();
+}
+
+/// 坐标换算/////////
+
+qint64 GanttView::pixelOf(qint64 timeMs) const
+{
+    return qint64(std::floor((timeMs - originMs()) / m_msPerPixel));
+}
+
+qint64 GanttView::timeOfPixel(qint64 pixel) const
+{
+    return originMs() + qint64(std::floor(pixel * m_msPerPixel));
+}
+
+int GanttView::plotWidth() const
+{
+    return std::max(1, viewport()->width() - LABEL_WIDTH);
+}
+
+int GanttView::plotHeight() const
+{
+    return std::max(1, viewport()->height() - AXIS_HEIGHT);
+}
+
+int GanttView::laneTop(int lane) const
+{
+    return LANE_SPACING + lane * (LANE_HEIGHT + LANE_SPACING) - verticalScrollBar()->value();
+}
+
+QColor GanttView::colorOf(const TimelineInterval& interval) const
+{
+    if (m_colorMode == GanttColorMode::Policy) {
+        int index = qBound(0, int(interval.policy), int(std::size(POLICY_COLORS)) - 1);
+        return POLICY_COLORS[index];
+    }
+    // 优先级1~10：蓝(240°)渐变到红(0°)
+    int priority = qBound(1, interval.priority, 10);
+    return QColor::fromHsv(240 - (priority - 1) * 240 / 9, 170, 220);
+}
+
+/// 刷新/////////
+
+void GanttView::refresh()
+{
+    if (!m_timeline) return;
+    m_nowMs = QDateTime::currentMSecsSinceEpoch();
+    syncLanes();
+    updateScrollBars();
+    drawNewIntervals();
+    viewport()->update();
+}
+
+void GanttView::syncLanes()
+{
+    quint64 generation = m_timeline->laneGeneration();
+    if (generation == m_laneGeneration) return;
+    m_laneGeneration = generation;
+    m_lanes = m_timeline->lanes();
+    m_laneCursor.fill(0, m_lanes.size());
+    invalidateCache();
+}
+
+void GanttView::updateScrollBars()
+{
+    m_adjusting = true;
+    QScrollBar* hbar = horizontalScrollBar();
+    qint64 contentPx = m_timeline ? pixelOf(m_nowMs) + RIGHT_MARGIN : 0;
+    hbar->setPageStep(plotWidth());
+    hbar->setSingleStep(20);
+    hbar->setRange(0, int(std::max<qint64>(0, contentPx - plotWidth())));
+    if (m_follow) hbar->setValue(hbar->maximum());
+
+    QScrollBar* vbar = verticalScrollBar();
+    int lanesHeight = LANE_SPACING + m_lanes.size() * (LANE_HEIGHT + LANE_SPACING);
+    vbar->setPageStep(plotHeight());
+    vbar->setSingleStep(LANE_HEIGHT + LANE_SPACING);
+    vbar->setRange(0, std::max(0, lanesHeight - plotHeight()));
+    m_adjusting = false;
+}
+
+void GanttView::scrollContentsBy(int dx, int dy)
+{
+    QScrollBar* hbar = horizontalScrollBar();
+    if (!m_adjusting) m_follow = hbar->value() >= hbar->maximum();
+    if (dy != 0) {
+        invalidateCache();
+        return;
+    }
+    if (dx == 0 || !m_cacheValid) {
+        viewport()->update();
+        return;
+    }
+    int width = m_cache.width();
+    if (std::abs(dx) >= width) {
+        invalidateCache();
+        return;
+    }
+    // 内容右移dx像素：已画好的部分平移，只重画露出来的一条
+    m_cache.scroll(dx, 0, m_cache.rect());
+    m_cacheLeftPx = hbar->value();
+    if (dx < 0) renderColumns(width + dx, width);
+    else renderColumns(0, dx);
+    viewport()->update();
+}
+
+void GanttView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    invalidateCache();
+    updateScrollBars();
+}
+
+void GanttView::wheelEvent(QWheelEvent* event)
+{
+    if (!(event->modifiers() & Qt::ControlModifier)) {
+        QAbstractScrollArea::wheelEvent(event);
+        return;
+    }
+    event->accept();
+    // 放大：每像素代表的毫秒数变小
+    double factor = event->angleDelta().y() > 0 ? 1.0 / ZOOM_STEP : ZOOM_STEP;
+    double msPerPixel = qBound(MIN_MS_PER_PIXEL, m_msPerPixel * factor, MAX_MS_PER_PIXEL);
+    if (msPerPixel == m_msPerPixel) return;
+
+    // 缩放前后鼠标下的时刻保持不动
+    int anchorX = qBound(0, int(event->position().x()) - LABEL_WIDTH, plotWidth());
+    qint64 anchorMs = timeOfPixel(horizontalScrollBar()->value() + anchorX);
+    m_msPerPixel = msPerPixel;
+    invalidateCache();      // 先标记失效，下面调整滚动条时不再平移旧缓存
+    updateScrollBars();
+    if (!m_follow) {
+        m_adjusting = true;
+        horizontalScrollBar()->setValue(int(pixelOf(anchorMs) - anchorX));
+        m_adjusting = false;
+    }
+}
+
+/// 缓存绘制/////////
+
+void GanttView::invalidateCache()
+{
+    m_cacheValid = false;
+    viewport()->update();
+}
+
+void GanttView::ensureCache()
+{
+    if (m_cacheValid) return;
+    QSize size(plotWidth(), plotHeight());
+    if (m_cache.size() != size) m_cache = QPixmap(size);
+    m_cacheLeftPx = horizontalScrollBar()->value();
+    // 先记下序号再按范围读取：期间新结束的区间之后会再画一次，重复画不影响结果
+    for (int i = 0; i < m_lanes.size(); ++i) {
+        m_laneCursor[i] = m_lanes[i]->closedCount();
+    }
+    renderColumns(0, size.width());
+    m_cacheValid = true;
+}
+
+void GanttView::renderColumns(int x0, int x1)
+{
+    if (x1 <= x0 || m_cache.isNull()) return;
+    QPainter painter(&m_cache);
+    painter.setClipRect(x0, 0, x1 - x0, m_cache.height());
+    painter.fillRect(x0, 0, x1 - x0, m_cache.height(), Qt::white);
+    for (int i = 0; i < m_lanes.size(); ++i) {
+        painter.fillRect(x0, laneTop(i), x1 - x0, LANE_HEIGHT, LANE_COLOR);
+    }
+    if (!m_timeline) return;
+
+    qint64 fromMs = timeOfPixel(m_cacheLeftPx + x0);
+    qint64 toMs = timeOfPixel(m_cacheLeftPx + x1 + 1);
+    for (int i = 0; i < m_lanes.size(); ++i) {
+        int top = laneTop(i);
+        if (top + LANE_HEIGHT <= 0 || top >= m_cache.height()) continue;
+        m_buffer.clear();
+        m_lanes[i]->readRange(fromMs, toMs, m_buffer);
+        drawIntervals(painter, i, m_buffer);
+    }
+}
+
+void GanttView::drawNewIntervals()
+{
+    // 缓存无效时下一次paintEvent会整张重画
+    if (!m_cacheValid || m_cache.isNull()) return;
+    QPainter painter(&m_cache);
+    for (int i = 0; i < m_lanes.size(); ++i) {
+        m_buffer.clear();
+        m_laneCursor[i] = m_lanes[i]->readSince(m_laneCursor[i], m_buffer);
+        drawIntervals(painter, i, m_buffer);
+    }
+}
+
+void GanttView::drawIntervals(QPainter& painter, int lane, const QVector<TimelineInterval>& intervals)
+{
+    int top = laneTop(lane);
+    int width = m_cache.width();
+    if (intervals.isEmpty() || top + LANE_HEIGHT <= 0 || top >= m_cache.height()) return;
+
+    qint64 drawnUntil = std::numeric_limits<qint64>::min();
+    for (const auto& interval : intervals) {
+        qint64 x0 = pixelOf(interval.startMs) - m_cacheLeftPx;
+        qint64 x1 = std::max(x0 + 1, pixelOf(interval.endMs) - m_cacheLeftPx);
+        if (x1 <= 0 || x0 >= width) continue;
+        // 缩小时大量短任务落在同一像素，只画一次
+        if (x1 <= drawnUntil) continue;
+        drawnUntil = x1;
+
+        int left = int(std::max<qint64>(x0, -1));
+        int right = int(std::min<qint64>(x1, width + 1));
+        QRect rect(left, top, right - left, LANE_HEIGHT);
+        QColor color = colorOf(interval);
+        painter.fillRect(rect, color);
+        if (x1 - x0 >= 4) {
+            // 左边界加深，区分首尾相接的任务
+            painter.setPen(color.darker(150));
+            painter.drawLine(left, top, left, top + LANE_HEIGHT - 1);
+        }
+        // 文字锚定在区间真实起点，平移重画时位置不变
+        if (x1 - x0 >= 30 && x0 > -width) {
+            painter.setPen(Qt::white);
+            painter.drawText(QRect(int(x0) + 3, top, int(std::min<qint64>(x1 - x0, 2 * width)) - 3, LANE_HEIGHT),
+                             Qt::AlignLeft | Qt::AlignVCenter, QString::number(interval.taskId));
+        }
+    }
+}
+
+/// 每帧绘制/////////
+
+void GanttView::paintEvent(QPaintEvent*)
+{
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), Qt::white);
+    if (!m_timeline) {
+        painter.setPen(Qt::gray);
+        painter.drawText(viewport()->rect(), Qt::AlignCenter, "线程池未启动");
+        return;
+    }
+    ensureCache();
+    painter.drawPixmap(LABEL_WIDTH, AXIS_HEIGHT, m_cache);
+
+    painter.save();
+    painter.setClipRect(LABEL_WIDTH, AXIS_HEIGHT, plotWidth(), plotHeight());
+    drawRunning(painter);
+    painter.restore();
+
+    drawAxis(painter);
+    drawLabels(painter);
+}
+
+void GanttView::drawRunning(QPainter& painter)
+{
+    qint64 left = horizontalScrollBar()->value();
+    qint64 nowX = pixelOf(m_nowMs) - left;
+    TimelineInterval interval;
+    for (int i = 0; i < m_lanes.size(); ++i) {
+        int top = laneTop(i);
+        if (top + LANE_HEIGHT <= 0 || top >= plotHeight()) continue;
+        if (!m_lanes[i]->running(interval)) continue;
+        qint64 x0 = std::max<qint64>(pixelOf(interval.startMs) - left, -1);
+        qint64 x1 = std::max(x0 + 1, nowX);
+        if (x1 <= 0 || x0 >= plotWidth()) continue;
+        QRect rect(LABEL_WIDTH + int(x0), AXIS_HEIGHT + top, int(std::min<qint64>(x1, plotWidth() + 1) - x0), LANE_HEIGHT);
+        QColor color = colorOf(interval);
+        QColor fill = color;
+        fill.setAlpha(150);
+        painter.fillRect(rect, fill);
+        painter.setPen(QPen(color.darker(150), 1, Qt::DashLine));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(rect.adjusted(0, 0, -1, -1));
+        if (rect.width() >= 30) {
+            painter.setPen(Qt::black);
+            painter.drawText(rect.adjusted(3, 0, 0, 0), Qt::AlignLeft | Qt::AlignVCenter, QString::number(interval.taskId));
+        }
+    }
+    // 当前时刻
+    if (nowX >= 0 && nowX < plotWidth()) {
+        painter.setPen(QPen(QColor(220, 60, 60), 1));
+        painter.drawLine(LABEL_WIDTH + int(nowX), AXIS_HEIGHT, LABEL_WIDTH + int(nowX), AXIS_HEIGHT + plotHeight());
+    }
+}
+
+void GanttView::drawAxis(QPainter& painter)
+{
+    painter.fillRect(0, 0, viewport()->width(), AXIS_HEIGHT, QColor(235, 235, 235));
+    qint64 step = TICK_STEPS_MS[std::size(TICK_STEPS_MS) - 1];
+    for (qint64 candidate : TICK_STEPS_MS) {
+        if (candidate / m_msPerPixel >= MIN_TICK_SPACING) {
+            step = candidate;
+            break;
+        }
+    }
+    // 刻度对齐到整秒/整分的墙上时间
+    qint64 left = horizontalScrollBar()->value();
+    qint64 fromMs = timeOfPixel(left);
+    qint64 toMs = timeOfPixel(left + plotWidth());
+    const char* format = step < 1000 ? "hh:mm:ss.zzz" : "hh:mm:ss";
+
+    painter.save();
+    painter.setClipRect(LABEL_WIDTH, 0, plotWidth(), AXIS_HEIGHT);
+    painter.setPen(Qt::darkGray);
+    for (qint64 tick = (fromMs / step + 1) * step; tick <= toMs; tick += step) {
+        int x = LABEL_WIDTH + int(pixelOf(tick) - left);
+        painter.drawLine(x, AXIS_HEIGHT - 5, x, AXIS_HEIGHT - 1);
+        painter.drawText(QRect(x + 3, 0, MIN_TICK_SPACING, AXIS_HEIGHT - 2), Qt::AlignLeft | Qt::AlignVCenter,
+                         QDateTime::fromMSecsSinceEpoch(tick).toString(format));
+    }
+    painter.restore();
+
+    // 左上角：当前缩放比例
+    painter.setPen(Qt::black);
+    QString scale = m_msPerPixel >= 1000 ? QString("%1s/px").arg(m_msPerPixel / 1000.0, 0, 'f', 1)
+                                         : QString("%1ms/px").arg(m_msPerPixel, 0, 'f', 1);
+    painter.drawText(QRect(2, 0, LABEL_WIDTH - 4, AXIS_HEIGHT), Qt::AlignLeft | Qt::AlignVCenter, scale);
+}
+
+void GanttView::drawLabels(QPainter& painter)
+{
+    painter.fillRect(0, AXIS_HEIGHT, LABEL_WIDTH, plotHeight(), QColor(235, 235, 235));
+    painter.save();
+    painter.setClipRect(0, AXIS_HEIGHT, LABEL_WIDTH, plotHeight());
+    for (int i = 0; i < m_lanes.size(); ++i) {
+        int top = laneTop(i);
+        if (top + LANE_HEIGHT <= 0 || top >= plotHeight()) continue;
+        // 已退出的线程灰色显示
+        painter.setPen(m_lanes[i]->exited() ? Qt::gray : Qt::black);
+        painter.drawText(QRect(4, AXIS_HEIGHT + top, LABEL_WIDTH - 8, LANE_HEIGHT),
+                         Qt::AlignLeft | Qt::AlignVCenter, QString("线程%1").arg(m_lanes[i]->threadId()));
+    }
+    painter.restore();
+}
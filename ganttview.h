@@ -0,0 +1,103 @@
+#ifndef GANTTVIEW_H
+#define GANTTVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QPixmap>
+#include <QTimer>
+#include <QVector>
+#include <memory>
+#include "pooltimeline.h"
+
+// 甘特图着色方式
+enum class GanttColorMode
+{
+    Priority,   // 按任务优先级（低→高：蓝→红）
+    Policy      // 按调度该任务时的策略
+};
+
+/*
+ * 线程执行甘特图
+ * 1. 每个工作线程一条泳道，横轴为时间；已结束的区间实心填充，正在执行的区间画到当前时刻。
+ * 2. 增量绘制：已结束的区间画在一张与视口等大的缓存图上。
+ *    - 定时刷新时只从各线程时间线取上次之后新结束的区间补画；
+ *    - 横向滚动时把缓存平移，只重画新露出的一条；
+ *    - 只有缩放、纵向滚动、改变大小、切换着色时才整张重画（只读取可见时间范围内的区间）。
+ *    正在执行的区间和坐标轴每帧直接画在缓存之上。
+ * 3. Ctrl+滚轮以鼠标位置为中心缩放时间轴；滚动条拖到最右端时自动跟随当前时刻。
+ * 4. 持有PoolTimeline的shared_ptr，线程池析构后仍能查看历史。
+ */
+class GanttView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit GanttView(QWidget* parent = nullptr);
+
+    // 传入nullptr清空
+    void setTimeline(std::shared_ptr<PoolTimeline> timeline);
+    void setColorMode(GanttColorMode mode);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    // Ctrl+滚轮缩放时间轴
+    void wheelEvent(QWheelEvent* event) override;
+    // 横向滚动时平移缓存，只补画露出的部分
+    void scrollContentsBy(int dx, int dy) override;
+
+private slots:
+    void refresh();
+
+private:
+    // 时间与像素换算（像素为从时间线起点算起的绝对横坐标）
+    qint64 pixelOf(qint64 timeMs) const;
+    qint64 timeOfPixel(qint64 pixel) const;
+    int plotWidth() const;
+    int plotHeight() const;
+    qint64 originMs() const { return m_timeline ? m_timeline->originMs() : 0; }
+    int laneTop(int lane) const;     // 缓存图中的纵坐标
+    QColor colorOf(const TimelineInterval& interval) const;
+
+    void syncLanes();
+    void updateScrollBars();
+    void invalidateCache();
+    // 缓存无效时整张重画
+    void ensureCache();
+    // 在缓存图的[x0, x1)列上重画（整张重画时x0=0, x1=宽度）
+    void renderColumns(int x0, int x1);
+    // 补画上次之后新结束的区间
+    void drawNewIntervals();
+    // 画一批区间，drawnUntil用来合并落在同一像素的短区间
+    void drawIntervals(QPainter& painter, int lane, const QVector<TimelineInterval>& intervals);
+    void drawAxis(QPainter& painter);
+    void drawLabels(QPainter& painter);
+    void drawRunning(QPainter& painter);
+
+    static const int REFRESH_MS = 100;
+    static const int AXIS_HEIGHT = 20;
+    static const int LABEL_WIDTH = 56;
+    static const int LANE_HEIGHT = 16;
+    static const int LANE_SPACING = 4;
+    static const int RIGHT_MARGIN = 20;     // 跟随时右侧留白
+    static constexpr double ZOOM_STEP = 1.25;
+    static constexpr double MIN_MS_PER_PIXEL = 0.5;
+    static constexpr double MAX_MS_PER_PIXEL = 60000.0;
+
+    std::shared_ptr<PoolTimeline> m_timeline;
+    QList<std::shared_ptr<ThreadTimeline>> m_lanes;
+    QVector<quint64> m_laneCursor;      // 每条泳道已画到的区间序号
+    quint64 m_laneGeneration = 0;
+    QTimer m_timer;
+
+    GanttColorMode m_colorMode = GanttColorMode::Priority;
+    double m_msPerPixel = 20.0;
+    qint64 m_nowMs = 0;
+    bool m_follow = true;               // 跟随当前时刻
+    bool m_adjusting = false;           // 程序调整滚动条时不改变跟随状态
+
+    QPixmap m_cache;                    // 已结束区间的缓存图（绘图区大小）
+    bool m_cacheValid = false;
+    qint64 m_cacheLeftPx = 0;           // 缓存图x=0对应的绝对像素
+    QVector<TimelineInterval> m_buffer; // 读取区间的临时缓冲，复用避免反复分配
+};
+
+#endif // GANTTVIEW_H
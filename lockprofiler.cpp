@@ -0,0 +1,295 @@
+#include "lockprofiler.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+    // 第0桶只放0（不争用），第i桶放[2^(i-1), 2^i) ns
+    int bucketOf(qint64 ns)
+    {
+        int bucket = 0;
+        while (ns > 0 && bucket < LockSite::HISTOGRAM_BUCKETS - 1) {
+            ns >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    void updateMax(std::atomic<quint64>& target, quint64 value)
+    {
+        quint64 current = target.load(std::memory_order_relaxed);
+        while (value > current
+               && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // 直方图分位数，返回所在桶的上界
+    quint64 percentile(const QList<quint64>& histogram, double p)
+    {
+        quint64 total = 0;
+        for (quint64 count : histogram) total += count;
+        if (total == 0) return 0;
+        quint64 target = quint64(total * p);
+        quint64 seen = 0;
+        for (int i = 0; i < histogram.size(); ++i) {
+            seen += histogram[i];
+            if (seen > target) return i == 0 ? 0 : (quint64(1) << i);
+        }
+        return quint64(1) << (histogram.size() - 1);
+    }
+
+    QString formatNs(quint64 ns)
+    {
+        if (ns < 1000) return QString("%1ns").arg(ns);
+        if (ns < 1000000) return QString("%1us").arg(ns / 1000.0, 0, 'f', 1);
+        return QString("%1ms").arg(ns / 1000000.0, 0, 'f', 1);
+    }
+
+    // "void ThreadPool::onTaskFinished(int, const Task&, int64_t, int64_t)" -> "ThreadPool::onTaskFinished:行号"
+    QString siteName(const LockSite* site)
+    {
+        QString function = QString::fromLatin1(site->function);
+        int paren = function.indexOf('(');
+        if (paren >= 0) function.truncate(paren);
+        int space = function.lastIndexOf(' ');
+        if (space >= 0) function = function.mid(space + 1);
+        return QString("%1:%2").arg(function).arg(site->line);
+    }
+}
+
+LockSite::LockSite(const char* function, int line)
+    : function(function), line(line)
+{
+    LockProfiler::instance().registerSite(this);
+}
+
+LockInfo* LockSite::bind(QMutex* mutex)
+{
+    // 同一调用点几乎总是同一把锁，只有线程池重建后地址变了才重新查一次
+    LockInfo* current = info.load(std::memory_order_acquire);
+    if (current && current->mutex == mutex) return current;
+    current = LockProfiler::instance().lockInfo(mutex);
+    info.store(current, std::memory_order_release);
+    return current;
+}
+
+void LockSite::recordWait(qint64 waitNs, LockSite* holder)
+{
+    waitHistogram[bucketOf(waitNs)].fetch_add(1, std::memory_order_relaxed);
+    if (waitNs <= 0) return;
+    contended.fetch_add(1, std::memory_order_relaxed);
+    totalWaitNs.fetch_add(quint64(waitNs), std::memory_order_relaxed);
+    updateMax(maxWaitNs, quint64(waitNs));
+    if (!holder) return;
+    // 找到（或占用）持锁调用点对应的槽位，满了就不再归因
+    for (Blocker& blocker : blockers) {
+        LockSite* site = blocker.site.load(std::memory_order_relaxed);
+        if (!site) {
+            LockSite* expected = nullptr;
+            if (blocker.site.compare_exchange_strong(expected, holder, std::memory_order_relaxed)) {
+                site = holder;
+            } else {
+                site = expected;
+            }
+        }
+        if (site == holder) {
+            blocker.count.fetch_add(1, std::memory_order_relaxed);
+            blocker.waitNs.fetch_add(quint64(waitNs), std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void LockSite::recordHold(qint64 holdNs)
+{
+    if (holdNs < 0) holdNs = 0;
+    holdHistogram[bucketOf(holdNs)].fetch_add(1, std::memory_order_relaxed);
+    totalHoldNs.fetch_add(quint64(holdNs), std::memory_order_relaxed);
+    updateMax(maxHoldNs, quint64(holdNs));
+}
+
+LockProfiler& LockProfiler::instance()
+{
+    static LockProfiler profiler;
+    return profiler;
+}
+
+void LockProfiler::registerMutex(const QMutex* mutex, const char* name)
+{
+    if (!enabled()) return;
+    QMutexLocker locker(&m_mutex);
+    for (LockInfo* info : m_locks) {
+        if (info->mutex == mutex) {
+            info->name = name;
+            return;
+        }
+    }
+    auto* info = new LockInfo;
+    info->mutex = mutex;
+    info->name = name;
+    m_locks.append(info);
+}
+
+LockInfo* LockProfiler::lockInfo(QMutex* mutex)
+{
+    QMutexLocker locker(&m_mutex);
+    for (LockInfo* info : m_locks) {
+        if (info->mutex == mutex) return info;
+    }
+    auto* info = new LockInfo;
+    info->mutex = mutex;
+    info->name = "未命名锁";
+    m_locks.append(info);
+    return info;
+}
+
+void LockProfiler::registerSite(LockSite* site)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sites.append(site);
+}
+
+qint64 LockProfiler::lock(QMutex* mutex, LockSite* site)
+{
+    LockInfo* info = site->bind(mutex);
+    if (mutex->tryLock()) {
+        site->recordWait(0, nullptr);
+    } else {
+        // 争用：先记下此刻的持锁方，再阻塞等待
+        LockSite* holder = info->holder.load(std::memory_order_relaxed);
+        qint64 startNs = PoolTracer::nowNs();
+        mutex->lock();
+        qint64 waitNs = PoolTracer::nowNs() - startNs;
+        site->recordWait(waitNs, holder);
+        if (Q_UNLIKELY(PoolTracer::enabled()) && waitNs >= PoolMutexLocker::LOCK_WAIT_TRACE_MIN_NS) {
+            PoolTracer::instance().complete("lock_wait", startNs, waitNs);
+        }
+    }
+    site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    info->holder.store(site, std::memory_order_relaxed);
+    return PoolTracer::nowNs();
+}
+
+void LockProfiler::released(LockSite* site, qint64 holdStartNs)
+{
+    site->recordHold(PoolTracer::nowNs() - holdStartNs);
+    LockInfo* info = site->info.load(std::memory_order_relaxed);
+    if (info) info->holder.store(nullptr, std::memory_order_relaxed);
+}
+
+void LockProfiler::unlock(QMutex* mutex, LockSite* site, qint64 holdStartNs)
+{
+    released(site, holdStartNs);
+    mutex->unlock();
+}
+
+qint64 LockProfiler::relocked(QMutex* mutex, LockSite* site)
+{
+    // 条件变量唤醒后重新持锁：不算一次加锁，只重新开始持有计时
+    LockInfo* info = site->bind(mutex);
+    info->holder.store(site, std::memory_order_relaxed);
+    return PoolTracer::nowNs();
+}
+
+QList<LockSiteStats> LockProfiler::snapshot() const
+{
+    QList<LockSite*> sites;
+    {
+        QMutexLocker locker(&m_mutex);
+        sites = m_sites;
+    }
+    QList<LockSiteStats> result;
+    for (const LockSite* site : sites) {
+        LockSiteStats stats;
+        stats.acquisitions = site->acquisitions.load(std::memory_order_relaxed);
+        if (stats.acquisitions == 0) continue;
+        LockInfo* info = site->info.load(std::memory_order_acquire);
+        stats.lockName = QString::fromUtf8(info ? info->name : "未命名锁");
+        stats.site = siteName(site);
+        stats.contended = site->contended.load(std::memory_order_relaxed);
+        stats.totalWaitNs = site->totalWaitNs.load(std::memory_order_relaxed);
+        stats.totalHoldNs = site->totalHoldNs.load(std::memory_order_relaxed);
+        stats.maxWaitNs = site->maxWaitNs.load(std::memory_order_relaxed);
+        stats.maxHoldNs = site->maxHoldNs.load(std::memory_order_relaxed);
+        for (int i = 0; i < LockSite::HISTOGRAM_BUCKETS; ++i) {
+            stats.waitHistogram.append(site->waitHistogram[i].load(std::memory_order_relaxed));
+            stats.holdHistogram.append(site->holdHistogram[i].load(std::memory_order_relaxed));
+        }
+        for (const LockSite::Blocker& blocker : site->blockers) {
+            const LockSite* holder = blocker.site.load(std::memory_order_relaxed);
+            if (!holder) break;
+            LockSiteStats::Blocker entry;
+            entry.site = siteName(holder);
+            entry.count = blocker.count.load(std::memory_order_relaxed);
+            entry.waitNs = blocker.waitNs.load(std::memory_order_relaxed);
+            stats.blockers.append(entry);
+        }
+        std::sort(stats.blockers.begin(), stats.blockers.end(),
+                  [](const LockSiteStats::Blocker& a, const LockSiteStats::Blocker& b) {
+                      return a.waitNs > b.waitNs;
+                  });
+        result.append(stats);
+    }
+    std::sort(result.begin(), result.end(), [](const LockSiteStats& a, const LockSiteStats& b) {
+        return a.totalWaitNs > b.totalWaitNs;
+    });
+    return result;
+}
+
+void LockProfiler::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (LockSite* site : m_sites) {
+        site->acquisitions.store(0, std::memory_order_relaxed);
+        site->contended.store(0, std::memory_order_relaxed);
+        site->totalWaitNs.store(0, std::memory_order_relaxed);
+        site->totalHoldNs.store(0, std::memory_order_relaxed);
+        site->maxWaitNs.store(0, std::memory_order_relaxed);
+        site->maxHoldNs.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < LockSite::HISTOGRAM_BUCKETS; ++i) {
+            site->waitHistogram[i].store(0, std::memory_order_relaxed);
+            site->holdHistogram[i].store(0, std::memory_order_relaxed);
+        }
+        for (LockSite::Blocker& blocker : site->blockers) {
+            blocker.count.store(0, std::memory_order_relaxed);
+            blocker.waitNs.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+QStringList LockProfiler::report(int topSites) const
+{
+    QStringList lines;
+    if (!enabled()) {
+        lines << "锁争用统计未开启：在ThreadPool.pro中加入 DEFINES += POOL_LOCK_PROFILING 后重新编译";
+        return lines;
+    }
+    QList<LockSiteStats> stats = snapshot();
+    if (stats.isEmpty()) {
+        lines << "锁争用统计：尚无加锁记录";
+        return lines;
+    }
+    lines << QString("锁争用统计（按累计等待时间排序，前%1个调用点）：").arg(qMin(topSites, int(stats.size())));
+    for (int i = 0; i < stats.size() && i < topSites; ++i) {
+        const LockSiteStats& site = stats[i];
+        double contendedPercent = 100.0 * site.contended / site.acquisitions;
+        lines << QString("%1 @ %2：加锁%3次，争用%4次(%5%)")
+                     .arg(site.lockName, site.site)
+                     .arg(site.acquisitions).arg(site.contended)
+                     .arg(contendedPercent, 0, 'f', 1);
+        lines << QString("    等待 累计%1 p50<=%2 p99<=%3 最大%4；持有 累计%5 p50<=%6 p99<=%7 最大%8")
+                     .arg(formatNs(site.totalWaitNs),
+                          formatNs(percentile(site.waitHistogram, 0.5)),
+                          formatNs(percentile(site.waitHistogram, 0.99)),
+                          formatNs(site.maxWaitNs),
+                          formatNs(site.totalHoldNs),
+                          formatNs(percentile(site.holdHistogram, 0.5)),
+                          formatNs(percentile(site.holdHistogram, 0.99)),
+                          formatNs(site.maxHoldNs));
+        for (int b = 0; b < site.blockers.size() && b < 3; ++b) {
+            const LockSiteStats::Blocker& blocker = site.blockers[b];
+            lines << QString("    被 %1 阻塞%2次，累计%3")
+                         .arg(blocker.site).arg(blocker.count).arg(formatNs(blocker.waitNs));
+        }
+    }
+    return lines;
+}
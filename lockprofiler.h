@@ -0,0 +1,189 @@
+#ifndef LOCKPROFILER_H
+#define LOCKPROFILER_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QStringList>
+#include <atomic>
+#include "pooltrace.h"
+
+/*
+ * 锁争用分析（ThreadPool::m_lock；队列的锁在core/StdThreadPool里，是std::mutex，不在统计范围内）
+ * 1. 编译期开关：qmake里加 DEFINES += POOL_LOCK_PROFILING 才统计；关闭时POOL_MUTEX_LOCKER
+ *    就是普通加锁（追踪开启时多记一个lock_wait事件），没有任何额外开销。
+ * 2. 按加锁的调用点统计（每个POOL_MUTEX_LOCKER展开出一个函数内static的LockSite）：
+ *    加锁次数、争用次数（tryLock失败才计时，不争用时不取时间）、等待时间直方图、持有时间直方图。
+ * 3. 争用时记录当时持锁的调用点，报告里能看到“谁在等谁”，
+ *    例如executeTask的进度更新被UI线程的getThreadVisualInfo阻塞了多少次、多久。
+ * 4. 直方图按2的幂分桶（纳秒），计数都是relaxed原子操作，统计本身不再加锁。
+ * 5. 锁的名字通过registerMutex()按地址登记，没登记的锁报告里显示为“未命名锁”。
+ */
+
+class LockSite;
+
+// 一把被统计的锁
+struct LockInfo
+{
+    const QMutex* mutex = nullptr;
+    const char* name = nullptr;
+    std::atomic<LockSite*> holder{nullptr};     // 当前持锁的调用点（只用于归因，允许偶尔不准）
+};
+
+// 一个加锁调用点，由POOL_MUTEX_LOCKER在函数内定义为static
+class LockSite
+{
+public:
+    static const int HISTOGRAM_BUCKETS = 40;    // 第i桶：[2^(i-1), 2^i) ns，最后一桶含以上
+    static const int MAX_BLOCKERS = 8;          // 每个调用点最多归因的持锁调用点个数
+
+    LockSite(const char* function, int line);
+
+    LockInfo* bind(QMutex* mutex);
+    void recordWait(qint64 waitNs, LockSite* holder);
+    void recordHold(qint64 holdNs);
+
+    const char* const function;
+    const int line;
+
+    struct Blocker
+    {
+        std::atomic<LockSite*> site{nullptr};
+        std::atomic<quint64> count{0};
+        std::atomic<quint64> waitNs{0};
+    };
+
+    std::atomic<LockInfo*> info{nullptr};
+    std::atomic<quint64> acquisitions{0};
+    std::atomic<quint64> contended{0};
+    std::atomic<quint64> totalWaitNs{0};
+    std::atomic<quint64> totalHoldNs{0};
+    std::atomic<quint64> maxWaitNs{0};
+    std::atomic<quint64> maxHoldNs{0};
+    std::atomic<quint64> waitHistogram[HISTOGRAM_BUCKETS] = {};
+    std::atomic<quint64> holdHistogram[HISTOGRAM_BUCKETS] = {};
+    Blocker blockers[MAX_BLOCKERS];
+};
+
+// 报告用的调用点快照
+struct LockSiteStats
+{
+    QString lockName;
+    QString site;               // 函数名:行号
+    quint64 acquisitions = 0;
+    quint64 contended = 0;
+    quint64 totalWaitNs = 0;
+    quint64 totalHoldNs = 0;
+    quint64 maxWaitNs = 0;
+    quint64 maxHoldNs = 0;
+    QList<quint64> waitHistogram;
+    QList<quint64> holdHistogram;
+    struct Blocker { QString site; quint64 count = 0; quint64 waitNs = 0; };
+    QList<Blocker> blockers;    // 按等待时间降序
+};
+
+class LockProfiler
+{
+public:
+    static const int REPORT_TOP_SITES = 10;
+
+    static LockProfiler& instance();
+    static constexpr bool enabled()
+    {
+#ifdef POOL_LOCK_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // 按地址登记锁的名字（name必须是字符串字面量）；关闭统计时什么都不做
+    void registerMutex(const QMutex* mutex, const char* name);
+    // 所有调用点的快照，按累计等待时间降序
+    QList<LockSiteStats> snapshot() const;
+    // 清零所有计数（调用点和锁登记保留）
+    void reset();
+    // 文本报告：争用最多的调用点和“等待方 <- 持锁方”
+    QStringList report(int topSites = REPORT_TOP_SITES) const;
+
+    // 由PoolMutexLocker调用
+    static qint64 lock(QMutex* mutex, LockSite* site);
+    static void unlock(QMutex* mutex, LockSite* site, qint64 holdStartNs);
+    // 条件变量等待前后：只结束/重新开始持有计时，解锁加锁由条件变量完成
+    static void released(LockSite* site, qint64 holdStartNs);
+    static qint64 relocked(QMutex* mutex, LockSite* site);
+
+    void registerSite(LockSite* site);
+    LockInfo* lockInfo(QMutex* mutex);
+
+private:
+    LockProfiler() = default;
+
+    mutable QMutex m_mutex;                 // 保护下面两个列表（只在登记和出报告时加锁）
+    QList<LockSite*> m_sites;
+    QList<LockInfo*> m_locks;               // 不释放：调用点可能还指着它
+};
+
+// 替代QMutexLocker，用POOL_MUTEX_LOCKER宏定义
+class PoolMutexLocker
+{
+public:
+    PoolMutexLocker(QMutex* mutex, LockSite* site) : m_mutex(mutex)
+    {
+#ifdef POOL_LOCK_PROFILING
+        m_site = site;
+        m_holdStartNs = LockProfiler::lock(mutex, site);
+#else
+        Q_UNUSED(site);
+        if (Q_UNLIKELY(PoolTracer::enabled())) {
+            qint64 startNs = PoolTracer::nowNs();
+            m_mutex->lock();
+            qint64 waitNs = PoolTracer::nowNs() - startNs;
+            if (waitNs >= LOCK_WAIT_TRACE_MIN_NS) PoolTracer::instance().complete("lock_wait", startNs, waitNs);
+        } else {
+            m_mutex->lock();
+        }
+#endif
+    }
+    ~PoolMutexLocker()
+    {
+#ifdef POOL_LOCK_PROFILING
+        LockProfiler::unlock(m_mutex, m_site, m_holdStartNs);
+#else
+        m_mutex->unlock();
+#endif
+    }
+    PoolMutexLocker(const PoolMutexLocker&) = delete;
+    PoolMutexLocker& operator=(const PoolMutexLocker&) = delete;
+
+    // 在条件变量上等待（内部释放锁），等待期间不计入持有时间
+    void wait(QWaitCondition& condition)
+    {
+#ifdef POOL_LOCK_PROFILING
+        LockProfiler::released(m_site, m_holdStartNs);
+        condition.wait(m_mutex);
+        m_holdStartNs = LockProfiler::relocked(m_mutex, m_site);
+#else
+        condition.wait(m_mutex);
+#endif
+    }
+
+    static const qint64 LOCK_WAIT_TRACE_MIN_NS = 1000;  // 追踪时等锁超过1us才记录
+
+private:
+    QMutex* m_mutex;
+#ifdef POOL_LOCK_PROFILING
+    LockSite* m_site = nullptr;
+    qint64 m_holdStartNs = 0;
+#endif
+};
+
+#ifdef POOL_LOCK_PROFILING
+#define POOL_MUTEX_LOCKER(var, mutex) \
+    static LockSite var##_site(Q_FUNC_INFO, __LINE__); \
+    PoolMutexLocker var(mutex, &var##_site)
+#else
+#define POOL_MUTEX_LOCKER(var, mutex) PoolMutexLocker var(mutex, nullptr)
+#endif
+
+#endif // LOCKPROFILER_H
@@ -1,13 +1,37 @@
 #include "mainwindow.h"
+#include "poollog.h"
+#include "pooltrace.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainWindow w;
-    w.show();
-    return a.exec();
+    // 日志排空线程；设置环境变量THREADPOOL_LOG_FILE时同时写滚动日志文件
+    PoolLogger::instance().start();
+    QString logFile = qEnvironmentVariable("THREADPOOL_LOG_FILE");
+    if (!logFile.isEmpty()) {
+        PoolLogger::instance().setFileSink(logFile);
+    }
+    // 设置环境变量THREADPOOL_TRACE_FILE时从启动开始追踪，退出时导出Chrome Trace JSON
+    PoolTracer::setCurrentThreadName("UI线程");
+    QString traceFile = qEnvironmentVariable("THREADPOOL_TRACE_FILE");
+    if (!traceFile.isEmpty()) {
+        PoolTracer::instance().start();
+    }
+    int ret = 0;
+    {
+        MainWindow w;
+        w.show();
+        ret = a.exec();
+    }
+    // 线程池析构时的日志也要输出
+    PoolLogger::instance().stop();
+    if (!traceFile.isEmpty()) {
+        PoolTracer::instance().stop();
+        PoolTracer::instance().exportChromeJson(traceFile);
+    }
+    return ret;
 }
 // #include <QCoreApplication>
 // #include <QDebug>
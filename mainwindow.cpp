@@ -1,10 +1,19 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "scheduler.h"
+#include "lockprofiler.h"
+#include "communication/telemetrysink.h"
+#include "communication/sharedmemorycommunication.h"
+#include "communication/localsocketcommunication.h"
+#include "communication/prometheusendpoint.h"
 #include <QRandomGenerator>
 #include <QInputDialog>
 #include <QTime>
 #include <QTimer>
+#include <QScrollBar>
+#include <QTextCursor>
+#include <QDateTime>
+#include <QFileDialog>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -13,11 +22,32 @@ MainWindow::MainWindow(QWidget *parent)
 {
     ui->setupUi(this);
 
+    // 列表视图绑定数据模型，模型随PoolModel的变化按行更新
+    m_poolModel.setListener(&m_listModels);
+    ui->waitingTaskList->setModel(m_listModels.waitingTasks());
+    ui->runningTaskList->setModel(m_listModels.runningTasks());
+    ui->finishedTaskList->setModel(m_listModels.finishedTasks());
+    ui->workingThreadList->setModel(m_listModels.workingThreads());
+    ui->idleThreadList->setModel(m_listModels.idleThreads());
+
     // 初始化UI状态
     ui->stopButton->setEnabled(false);
     ui->addTaskToolButton->setEnabled(false);
     // 添加任务按钮菜单
     setAddTaskMenu();
+
+    // 日志：限制最大行数，按批追加
+    ui->logTextBrowser->document()->setMaximumBlockCount(MAX_LOG_LINES);
+    connect(&PoolLogger::instance(), &PoolLogger::linesReady, this, &MainWindow::onLogLines);
+
+    // 趋势图、CPU统计和HRRN的等待队列重排：与指标分桶同频刷新，不随帧做
+    m_chartTimer = new QTimer(this);
+    connect(m_chartTimer, &QTimer::timeout, this, &MainWindow::refreshCharts);
+    connect(m_chartTimer, &QTimer::timeout, this, &MainWindow::refreshCpuStats);
+    connect(m_chartTimer, &QTimer::timeout, this, [this]() {
+        m_poolModel.refreshDynamicOrder();
+        scheduleRefresh();
+    });
 }
 
 MainWindow::~MainWindow()
@@ -33,17 +63,50 @@ void MainWindow::on_startButton_clicked()
 
     // 创建线程池
     m_pool = std::make_unique<ThreadPool>(minThreads, maxThreads);
+    // 订阅增量事件，本地模型首次刷新时用快照同步
+    m_poolModel.clear();
+    m_subscription = m_pool->subscribeEvents();
 
 
-    // 日志输出
-    connect(m_pool.get(), &ThreadPool::logMessage, this, &MainWindow::onLogMessage);
     // 统一UI刷新
-    connect(m_pool.get(), &ThreadPool::taskListChanged, this, &MainWindow::refreshAllUI);
-    connect(m_pool.get(), &ThreadPool::threadStateChanged, this, &MainWindow::refreshAllUI);
+    // 大线程池每秒会发出成千上万个信号，按帧合并后再刷新
+    connect(m_pool.get(), &ThreadPool::taskListChanged, this, &MainWindow::scheduleRefresh);
+    connect(m_pool.get(), &ThreadPool::threadStateChanged, this, &MainWindow::scheduleRefresh);
+
+    // 设置环境变量THREADPOOL_TELEMETRY_FILE时追加写状态遥测（.jsonl为JSON行，其余为二进制），用telemetrydump解码
+    QString telemetryFile = qEnvironmentVariable("THREADPOOL_TELEMETRY_FILE");
+    if (!telemetryFile.isEmpty()) {
+        m_pool->addStatusSink(std::make_unique<TelemetrySink>(telemetryFile, TelemetryFile::formatForPath(telemetryFile)));
+    }
+    // 设置环境变量THREADPOOL_SHM_NAME（如/threadpool_status）时同时发布到共享内存段，用shmtop查看
+    QString shmName = qEnvironmentVariable("THREADPOOL_SHM_NAME");
+    if (!shmName.isEmpty()) {
+        m_pool->addStatusSink(std::make_unique<SharedMemoryCommunication>(shmName));
+    }
+    // 设置环境变量THREADPOOL_CONTROL_SOCKET（如threadpool-control）时开启本地套接字控制面，用loadgen压测
+    QString controlSocket = qEnvironmentVariable("THREADPOOL_CONTROL_SOCKET");
+    if (!controlSocket.isEmpty()) {
+        m_pool->addStatusSink(std::make_unique<LocalSocketCommunication>(m_pool.get(), controlSocket));
+    }
+    // 设置环境变量THREADPOOL_WORKLOAD_FILE时记录每次提交的任务，用poolcli --replay重放
+    QString workloadFile = qEnvironmentVariable("THREADPOOL_WORKLOAD_FILE");
+    if (!workloadFile.isEmpty()) {
+        m_pool->startWorkloadRecording(workloadFile);
+    }
+    // 设置环境变量THREADPOOL_METRICS_PORT（如9464）时在本机该端口提供Prometheus格式的/metrics
+    int metricsPort = qEnvironmentVariableIntValue("THREADPOOL_METRICS_PORT");
+    if (metricsPort > 0 && metricsPort <= 65535) {
+        m_pool->addStatusSink(std::make_unique<PrometheusEndpoint>(m_pool.get(), quint16(metricsPort)));
+    }
 
+    // 内存预算
+    m_pool->setMemoryBudget(ui->memBudgetSpinBox->value());
     // 调度策略选择
     m_pool->setSchedulePolicy(static_cast<SchedulePolicy>(ui->scheduleComboBox->currentIndex()));
     ui->poolGraphicsView->setCurrentPolicy(static_cast<SchedulePolicy>(ui->scheduleComboBox->currentIndex()));
+    m_chartTimer->start(PoolMetrics::BUCKET_MS);
+    // 甘特图自带定时器，从线程池的时间线增量读取
+    ui->ganttView->setTimeline(m_pool->getTimeline());
     // 更新UI状态
     ui->startButton->setEnabled(false);
     ui->stopButton->setEnabled(true);
@@ -59,7 +122,18 @@ void MainWindow::on_stopButton_clicked()
     if (m_pool) {
         disconnect(m_pool.get(), &ThreadPool::taskListChanged, this, nullptr); // 断开taskListChanged信号槽
         disconnect(m_pool.get(), &ThreadPool::threadStateChanged, this, nullptr); // 断开threadStateChanged信号槽
+        m_pool->unsubscribeEvents(m_subscription);
     }
+    // 编译时开启了锁争用统计：把本轮的报告输出到日志区，然后清零
+    if (LockProfiler::enabled()) {
+        onLogLines(LockProfiler::instance().report());
+        LockProfiler::instance().reset();
+    }
+    m_subscription = nullptr;
+    m_poolModel.clear();
+    m_chartTimer->stop();
+    ui->metricsChart->setSeries({}, 60 * 1000, 0);
+    ui->ganttView->setTimeline(nullptr);
 
     // 2. 禁用相关按钮
     ui->stopButton->setEnabled(false);
@@ -69,13 +143,7 @@ void MainWindow::on_stopButton_clicked()
     // 3. 启用“开始”按钮和调度策略选择框
     ui->startButton->setEnabled(true);
 
-    // 4. 清空UI显示
-    ui->waitingTaskList->clear();
-    ui->runningTaskList->clear();
-    ui->finishedTaskList->clear();
-
-    ui->workingThreadList->clear();
-    ui->idleThreadList->clear();
+    // 4. 清空UI显示（列表模型已随m_poolModel.clear()清空）
     ui->poolGraphicsView->clear();
 
     // 5. 清空统计栏
@@ -90,9 +158,9 @@ void MainWindow::on_stopButton_clicked()
     ui->avgResponseRatioLabel->setText("平均响应比: 0.00");
     ui->throughputLabel->setText("吞吐量: 0.00 任务/秒");
     ui->cpuUtilizationLabel->setText("CPU利用率: 0.0%");
+    ui->memReservedLabel->setText("已预留内存: 0B");
+    ui->memInUseLabel->setText("载荷内存: 0B");
 
-    // 重启线程池后任务ID归零
-    m_totalTasks = 0;
     // 清空map
     m_taskIdToTotalTimeMs.clear();
 }
@@ -155,7 +223,7 @@ void MainWindow::on_addTaskToolButton_triggered(QAction *action)
         });
     }
     
-    emit m_pool->logMessage(QString("[批量添加]开始添加 %1 个任务，间隔 %2ms").arg(count).arg(interval));
+    POOL_LOG_INFO("[批量添加]开始添加 %1 个任务，间隔 %2ms", count, interval);
 }
 
 void MainWindow::on_clearLogButton_clicked()
@@ -170,6 +238,25 @@ void MainWindow::on_clearLogButton_clicked()
     }
 }
 
+void MainWindow::on_traceButton_toggled(bool checked)
+{
+    PoolTracer& tracer = PoolTracer::instance();
+    if (checked) {
+        tracer.start();
+        ui->traceButton->setText("停止追踪");
+        POOL_LOG_INFO("[追踪]开始记录");
+        return;
+    }
+    tracer.stop();
+    ui->traceButton->setText("开始追踪");
+    QString path = QFileDialog::getSaveFileName(this, "导出追踪", "threadpool_trace.json", "Chrome Trace (*.json)");
+    if (path.isEmpty()) return;
+    if (!tracer.exportChromeJson(path)) {
+        QMessageBox::warning(this, "导出失败", QString("无法写入文件：%1").arg(path));
+        return;
+    }
+    POOL_LOG_INFO("[追踪]已导出，缓冲区满丢弃 %1 个事件", tracer.droppedCount());
+}
 
 void MainWindow::on_minThreadSpinBox_valueChanged(int arg1)
 {
@@ -178,6 +265,8 @@ void MainWindow::on_minThreadSpinBox_valueChanged(int arg1)
     if (ui->maxThreadSpinBox->value() < arg1) {
         ui->maxThreadSpinBox->setValue(arg1);
     }
+    // 运行中修改立即生效
+    if (m_pool) m_pool->setThreadRange(arg1, ui->maxThreadSpinBox->value());
 }
 
 
@@ -188,6 +277,17 @@ void MainWindow::on_maxThreadSpinBox_valueChanged(int arg1)
     if (ui->minThreadSpinBox->value() > arg1) {
         ui->minThreadSpinBox->setValue(arg1);
     }
+    if (m_pool) m_pool->setThreadRange(ui->minThreadSpinBox->value(), arg1);
+}
+
+void MainWindow::scheduleRefresh()
+{
+    if (m_refreshPending) return;
+    m_refreshPending = true;
+    QTimer::singleShot(FRAME_INTERVAL_MS, this, [this]() {
+        m_refreshPending = false;
+        refreshAllUI();
+    });
 }
 
 void MainWindow::refreshAllUI() {
@@ -196,51 +296,16 @@ void MainWindow::refreshAllUI() {
     // 0. 更新map, 用于绘制进度条
     ui->poolGraphicsView->setTaskIdToTotalTimeMs(m_taskIdToTotalTimeMs);
 
-    // 1. 刷新任务列表
-    // 1.1. waitingTaskList
-    ui->waitingTaskList->clear();
-    for (const auto& waitingTask : m_pool->getWaitingTaskVisualInfo()) {
-        ui->waitingTaskList->addItem(
-            QString("任务%1 (%2s,★%3)")
-                .arg(waitingTask.taskId)
-                .arg(waitingTask.totalTimeMs / 1000.0, 0, 'f', 1)
-                .arg(waitingTask.priority)
-        );
-    }
-
-    // 1.2. runningTaskList
-    ui->runningTaskList->clear();
-    for (const auto& threadInfo : m_pool->getThreadVisualInfo()) {
-        if (threadInfo.state == 1 && threadInfo.curTaskId != -1) { // 1=忙碌
-            ui->runningTaskList->addItem(
-                QString("任务%1 (T:%2)").arg(threadInfo.curTaskId).arg(threadInfo.threadId));
-        }
-    }
-
-    // 1.3. finishedTaskList    
-    ui->finishedTaskList->clear();
-    for (const auto& finishedTask : m_pool->getFinishedTaskVisualInfo()) {
-        ui->finishedTaskList->addItem(
-            QString("任务%1 (T:%2)").arg(finishedTask.taskId).arg(finishedTask.curThreadId));
+    // 1. 应用增量事件到本地模型（首次或丢事件时自动用快照重新同步）
+    if (m_subscription) {
+        m_poolModel.sync(*m_subscription, [this]() { return m_pool->getSnapshot(); });
     }
+    QList<ThreadVisualInfo> threadInfos = m_poolModel.threadInfos();
+    // 等待/已完成列表由模型增量维护，这里和视图都只拿引用，不拷贝
+    const QList<TaskVisualInfo>& waitingTasks = m_poolModel.waitingTasks();
+    const QList<TaskVisualInfo>& finishedTasks = m_poolModel.finishedTasks();
 
-    // 2. 刷新线程列表
-    // 2.1. idleThreadList
-    ui->idleThreadList->clear();
-
-
-    // 2.2. workingThreadList
-    ui->workingThreadList->clear();
-
-    for (const auto& threadInfo : m_pool->getThreadVisualInfo()) {
-        if (threadInfo.state == 1) {    // 1=忙碌
-            ui->workingThreadList->addItem(
-                QString("线程%1 (#%2)").arg(threadInfo.threadId).arg(threadInfo.curTaskId));
-        } else if (threadInfo.state == 0) { // 0=空闲
-            ui->idleThreadList->addItem(
-                QString("线程%1").arg(threadInfo.threadId));
-        }
-    }
+    // 2. 任务列表和线程列表由m_listModels在sync()中按行更新，这里不用再重建
 
     // 3. 更新统计栏
     // 3.1. 从线程池获取真实数据
@@ -264,7 +329,6 @@ void MainWindow::refreshAllUI() {
     double avgWaitingTimeS = 0.0;  // 直接使用秒为单位
     double avgResponseRatio = 0.0;
     double throughput = 0.0;
-    double cpuUtilization = 0.0;
 
     // 3.2.1. 平均等待时间 和 平均响应比
     double totalWaitingTimeMs = m_pool->getTotalWaitingTimeMs();
@@ -277,27 +341,42 @@ void MainWindow::refreshAllUI() {
     double totalTimeMs = m_pool->getTotalTimeMs();
     throughput = totalTimeMs > 0 ? poolFinishedTasks / (totalTimeMs / 1000.0) : 0.0;
 
-    // 3.2.3. CPU利用率计算（独立于已完成任务）
-    cpuUtilization = poolTotalThreads > 0 ? (poolBusyThreads / (double)poolTotalThreads) * 100.0 : 0.0;
-
-    // 更新UI显示
+    // 更新UI显示（CPU利用率按指标分桶更新，见refreshCpuStats）
     ui->avgWaitTimeLabel->setText(QString("平均等待时间: %1s").arg(avgWaitingTimeS, 0, 'f', 2));
     ui->avgResponseRatioLabel->setText(QString("平均响应比: %1").arg(avgResponseRatio, 0, 'f', 2));
     ui->throughputLabel->setText(QString("吞吐量: %1 任务/秒").arg(throughput, 0, 'f', 2));
-    ui->cpuUtilizationLabel->setText(QString("CPU利用率: %1%").arg(cpuUtilization, 0, 'f', 1));
+
+    // 3.3. 内存预算
+    size_t memBudget = m_pool->getMemoryBudget();
+    QString budgetText = memBudget > 0 ? QString("%1B").arg(memBudget) : QString("不限");
+    ui->memReservedLabel->setText(QString("已预留内存: %1B / %2").arg(m_pool->getMemoryReserved()).arg(budgetText));
+    ui->memInUseLabel->setText(QString("载荷内存: %1B").arg(m_pool->getMemoryInUse()));
 
 
     // 4. 更新可视化UI
-    QList<ThreadVisualInfo> threadInfos = m_pool->getThreadVisualInfo();
-    QList<TaskVisualInfo> waitingTasks = m_pool->getWaitingTaskVisualInfo();
-    QList<TaskVisualInfo> finishedTasks = m_pool->getFinishedTaskVisualInfo();
     ui->poolGraphicsView->visualizeAll(threadInfos, waitingTasks, finishedTasks);
+    // 帧耗时显示在状态栏
+    const PoolViewFrameStats& frameStats = ui->poolGraphicsView->frameStats();
+    ui->statusbar->showMessage(QString("刷新: %1ms (平均 %2ms, 最大 %3ms)  绘制: %4ms  图元: %5  %6")
+        .arg(frameStats.lastUpdateMs, 0, 'f', 2)
+        .arg(frameStats.avgUpdateMs, 0, 'f', 2)
+        .arg(frameStats.maxUpdateMs, 0, 'f', 2)
+        .arg(frameStats.avgPaintMs, 0, 'f', 2)
+        .arg(frameStats.liveItems)
+        .arg(frameStats.aggregate ? "聚合显示" : "详细显示(Ctrl+滚轮缩放)"));
 }
 
 
-void MainWindow::onLogMessage(const QString& msg)
+void MainWindow::onLogLines(const QStringList& lines)
 {
-    ui->logTextBrowser->append(msg);
+    // 日志线程成批送来，一次插入；超过MAX_LOG_LINES的旧行由document自动删除
+    QScrollBar* scrollBar = ui->logTextBrowser->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+    QTextCursor cursor(ui->logTextBrowser->document());
+    cursor.movePosition(QTextCursor::End);
+    if (!ui->logTextBrowser->document()->isEmpty()) cursor.insertBlock();
+    cursor.insertText(lines.join('\n'));
+    if (atBottom) scrollBar->setValue(scrollBar->maximum());
 }
 
 
@@ -317,15 +396,23 @@ void MainWindow::on_scheduleComboBox_currentIndexChanged(int index)
     refreshAllUI();
 }
 
+void MainWindow::on_memBudgetSpinBox_valueChanged(int arg1)
+{
+    if (!m_pool) return;
+    m_pool->setMemoryBudget(arg1);
+    refreshAllUI();
+}
+
 
 void MainWindow::addSingleTask()
 {
     // 生成任务参数
-    int taskId = ++m_totalTasks;
+    int taskId = m_pool->allocateTaskIds(1);
     int totalTimeMs = QRandomGenerator::global()->bounded(1000, 10001);
     int priority = QRandomGenerator::global()->bounded(1, 11);
     size_t memSize = QRandomGenerator::global()->bounded(1,65);    // 1~64B
-    void* memPtr = nullptr;
+    // 载荷从线程池的slab分配器申请，任务完成后由工作线程自动释放
+    void* memPtr = m_pool->allocatePayload(memSize);
     // 维护map
     m_taskIdToTotalTimeMs[taskId] = totalTimeMs;
 
@@ -339,8 +426,60 @@ void MainWindow::addSingleTask()
     task.memSize = memSize;
     task.memPtr = memPtr;
     task.arrivalTimestampMs = QTime::currentTime().msecsSinceStartOfDay();
-    m_pool->addTask(task);
+    m_pool->addTask(std::move(task));
+}
+
+void MainWindow::on_chartWindowComboBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    refreshCharts();
 }
 
+void MainWindow::on_ganttColorComboBox_currentIndexChanged(int index)
+{
+    ui->ganttView->setColorMode(static_cast<GanttColorMode>(index));
+}
 
+void MainWindow::refreshCpuStats()
+{
+    if (!m_pool) return;
+    // CPU利用率：工作线程实际占用的CPU时间（最近一个指标桶，相对全部CPU核）
+    // 任务阻塞在sleep/IO上时不计入；平台不支持线程CPU时间时退回忙线程占比
+    // 每个指标桶只刷新一次：getCpuStats()和逐线程的getThreadVisualInfo()都要拿m_lock，不能每帧调用
+    PoolCpuStats cpuStats = m_pool->getCpuStats();
+    double cpuUtilization = 0.0;
+    if (cpuStats.supported) {
+        cpuUtilization = cpuStats.cpuPercent;
+        ui->cpuUtilizationLabel->setText(QString("CPU利用率: %1% (任务CPU效率 %2%)")
+            .arg(cpuUtilization, 0, 'f', 1).arg(cpuStats.efficiency * 100.0, 0, 'f', 1));
+    } else {
+        int aliveThreads = m_pool->getAliveNumber();
+        cpuUtilization = aliveThreads > 0 ? (m_pool->getBusyNumber() / (double)aliveThreads) * 100.0 : 0.0;
+        ui->cpuUtilizationLabel->setText(QString("忙线程占比: %1%").arg(cpuUtilization, 0, 'f', 1));
+    }
+    // 各工作线程的CPU时间和上下文切换放在提示里
+    QStringList cpuLines;
+    cpuLines.append(QString("累计CPU时间: %1ms，主动切换: %2，被动切换: %3")
+        .arg(cpuStats.cpuTimeMs).arg(cpuStats.voluntarySwitches).arg(cpuStats.involuntarySwitches));
+    for (const auto& thread : m_pool->getThreadVisualInfo()) {
+        cpuLines.append(QString("线程%1: CPU %2ms / 忙 %3ms，主动切换 %4，被动切换 %5")
+            .arg(thread.threadId).arg(thread.cpuTimeMs).arg(thread.busyTimeMs)
+            .arg(thread.voluntarySwitches).arg(thread.involuntarySwitches));
+    }
+    ui->cpuUtilizationLabel->setToolTip(cpuLines.join('\n'));
+}
 
+void MainWindow::refreshCharts()
+{
+    if (!m_pool) return;
+    static const int WINDOW_MINUTES[] = {1, 5, 15, 60};
+    int index = qBound(0, ui->chartWindowComboBox->currentIndex(), 3);
+    qint64 windowMs = WINDOW_MINUTES[index] * 60 * 1000LL;
+    int maxPoints = ui->metricsChart->plotWidth();
+
+    QList<QList<MetricsPoint>> series;
+    for (int metric = 0; metric < int(PoolMetric::Count); ++metric) {
+        series.append(m_pool->getMetricsSeries(PoolMetric(metric), windowMs, maxPoints));
+    }
+    ui->metricsChart->setSeries(series, windowMs, QDateTime::currentMSecsSinceEpoch());
+}
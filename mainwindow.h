@@ -7,6 +7,8 @@
 #include <memory>
 #include "threadpool.h"
 #include "poolview.h"
+#include "poolmodel.h"
+#include "poollistmodels.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -33,10 +35,14 @@ private slots:
     void on_addTaskToolButton_triggered(QAction *action);
 
     void on_clearLogButton_clicked();
-    // 日志输出
-    void onLogMessage(const QString& msg);
+
+    void on_traceButton_toggled(bool checked);
+    // 日志输出（PoolLogger排空线程成批送来）
+    void onLogLines(const QStringList& lines);
     // 刷新所有UI
     void refreshAllUI();
+    // 合并同一帧内的多次刷新请求，最多每FRAME_INTERVAL_MS刷新一次
+    void scheduleRefresh();
 
     // 线程数量spinBox控制
     void on_minThreadSpinBox_valueChanged(int arg1);
@@ -44,6 +50,16 @@ private slots:
     void on_maxThreadSpinBox_valueChanged(int arg1);
 
     void on_scheduleComboBox_currentIndexChanged(int index);
+
+    void on_memBudgetSpinBox_valueChanged(int arg1);
+
+    void on_chartWindowComboBox_currentIndexChanged(int index);
+
+    void on_ganttColorComboBox_currentIndexChanged(int index);
+    // 刷新趋势图（定时器驱动，线程池空闲时也会前进）
+    void refreshCharts();
+    // 刷新CPU利用率和逐线程CPU提示（同样由指标定时器驱动，不随帧刷新）
+    void refreshCpuStats();
 private:
     void setAddTaskMenu();
     void addSingleTask();
@@ -57,7 +73,17 @@ private:
     std::unique_ptr<ThreadPool> m_pool;
     // ui中，把poolGraphicsView提升为PoolView后,不再需要PoolView* m_poolView这个成员变量
 
-    int m_totalTasks = 0;
+    static const int FRAME_INTERVAL_MS = 16;   // 约60fps
+    static const int MAX_LOG_LINES = 5000;     // 日志窗口最多保留的行数
+    bool m_refreshPending = false;
+    QTimer* m_chartTimer = nullptr;
+
     QMap<int, int> m_taskIdToTotalTimeMs;  // 任务ID到总耗时的映射
+
+    // 事件订阅与本地模型：刷新时只应用增量事件，不再每次拷贝整个线程池状态
+    std::shared_ptr<PoolEventSubscription> m_subscription;
+    PoolModel m_poolModel;
+    // 五个列表视图的数据模型，由m_poolModel按行通知更新
+    PoolListModels m_listModels{m_poolModel};
 };
 #endif // MAINWINDOW_H
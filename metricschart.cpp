@@ -0,0 +1,100 @@
+#include "metricschart.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+
+namespace {
+    const QColor LINE_COLORS[] = {
+        QColor(60, 140, 220),   // 吞吐量
+        QColor(220, 60, 60),    // 队列长度
+        QColor(60, 180, 60),    // 存活线程
+        QColor(230, 140, 30),   // 忙线程
+        QColor(150, 80, 200),   // p99等待
+        QColor(40, 170, 170),   // CPU占用
+    };
+}
+
+MetricsChart::MetricsChart(QWidget* parent) : QWidget(parent)
+{
+    setMinimumHeight(int(PoolMetric::Count) * 36);
+}
+
+void MetricsChart::setSeries(const QList<QList<MetricsPoint>>& series, qint64 windowMs, qint64 nowMs)
+{
+    m_series = series;
+    m_windowMs = windowMs;
+    m_nowMs = nowMs;
+    update();
+}
+
+int MetricsChart::plotWidth() const
+{
+    return std::max(1, width() - LABEL_WIDTH - 4);
+}
+
+void MetricsChart::paintEvent(QPaintEvent*)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    const int rowCount = int(PoolMetric::Count);
+    const double rowHeight = height() / double(rowCount);
+    const double plotLeft = LABEL_WIDTH;
+    const double plotWidth = this->plotWidth();
+
+    for (int row = 0; row < rowCount; ++row) {
+        QRectF rowRect(0, row * rowHeight, width(), rowHeight);
+        QRectF plot(plotLeft, rowRect.top() + 3, plotWidth, rowHeight - 6);
+        const QList<MetricsPoint> points = row < m_series.size() ? m_series[row] : QList<MetricsPoint>();
+        const QColor color = LINE_COLORS[row];
+
+        // 纵轴从0到窗口内最大值
+        double maxValue = 0.0;
+        for (const auto& point : points) maxValue = std::max(maxValue, point.max);
+        double top = maxValue > 0 ? maxValue * 1.1 : 1.0;
+
+        // 左侧：指标名、当前值、纵轴上限
+        painter.setPen(Qt::black);
+        QString current = points.isEmpty() ? QString("-") : QString::number(points.last().max, 'f', 1);
+        painter.drawText(QRectF(4, rowRect.top(), LABEL_WIDTH - 8, rowHeight / 2),
+                         Qt::AlignLeft | Qt::AlignVCenter, PoolMetrics::metricName(PoolMetric(row)));
+        painter.setPen(color);
+        painter.drawText(QRectF(4, rowRect.top() + rowHeight / 2, LABEL_WIDTH - 8, rowHeight / 2),
+                         Qt::AlignLeft | Qt::AlignVCenter, QString("%1  (max %2)").arg(current).arg(maxValue, 0, 'f', 1));
+        painter.setPen(QColor(220, 220, 220));
+        painter.drawRect(plot);
+        if (points.isEmpty()) continue;
+
+        auto xOf = [&](qint64 timestampMs) {
+            return plot.right() - (m_nowMs - timestampMs) / double(m_windowMs) * plot.width();
+        };
+        auto yOf = [&](double value) {
+            return plot.bottom() - value / top * plot.height();
+        };
+
+        // min/max波动范围
+        QColor bandColor = color;
+        bandColor.setAlpha(70);
+        painter.setPen(QPen(bandColor, 1));
+        for (const auto& point : points) {
+            if (point.max > point.min) {
+                double x = xOf(point.timestampMs);
+                painter.drawLine(QPointF(x, yOf(point.min)), QPointF(x, yOf(point.max)));
+            }
+        }
+        // 最大值折线
+        QPainterPath path;
+        path.moveTo(xOf(points.first().timestampMs), yOf(points.first().max));
+        for (int i = 1; i < points.size(); ++i) {
+            path.lineTo(xOf(points[i].timestampMs), yOf(points[i].max));
+        }
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setPen(QPen(color, 1.5));
+        painter.setBrush(Qt::NoBrush);
+        painter.save();
+        painter.setClipRect(plot);
+        painter.drawPath(path);
+        painter.restore();
+        painter.setRenderHint(QPainter::Antialiasing, false);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef METRICSCHART_H
+#define METRICSCHART_H
+
+#include <QWidget>
+#include <QList>
+#include "poolmetrics.h"
+
+/*
+ * 指标趋势图
+ * 1. 每项指标一条横向小图，从上到下排列，共用时间轴（最近windowMs）。
+ * 2. 每个点是一组桶的min/max：浅色竖条画出波动范围，深色折线连接各组最大值。
+ * 3. 点数由调用方按控件宽度取（PoolMetrics::series的maxPoints），绘制开销与窗口长度无关。
+ */
+class MetricsChart : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit MetricsChart(QWidget* parent = nullptr);
+
+    // series按PoolMetric顺序，每项一条
+    void setSeries(const QList<QList<MetricsPoint>>& series, qint64 windowMs, qint64 nowMs);
+    // 调用方据此决定maxPoints
+    int plotWidth() const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    static const int LABEL_WIDTH = 130;     // 左侧指标名和当前值
+
+    QList<QList<MetricsPoint>> m_series;
+    qint64 m_windowMs = 60 * 1000;
+    qint64 m_nowMs = 0;
+};
+
+#endif // METRICSCHART_H
@@ -0,0 +1,202 @@
+#include "payloadallocator.h"
+#include <new>
+
+namespace {
+    // 当前线程绑定的缓存（每个工作线程启动时绑定自己的缓存）
+    thread_local PayloadAllocator::ThreadCache* t_threadCache = nullptr;
+}
+
+int PayloadAllocator::sizeClassOf(size_t size)
+{
+    int cls = 0;
+    size_t blockSize = MIN_BLOCK_SIZE;
+    while (blockSize < size) {
+        blockSize <<= 1;
+        cls++;
+    }
+    return cls;
+}
+
+PayloadAllocator::ThreadCache* PayloadAllocator::currentCache() const
+{
+    ThreadCache* cache = t_threadCache;
+    return (cache && cache->m_owner == this) ? cache : nullptr;
+}
+
+void PayloadAllocator::bindThreadCache(ThreadCache* cache)
+{
+    t_threadCache = cache;
+}
+
+void PayloadAllocator::growLocked(int cls)
+{
+    // 小块等级按SLAB_SIZE切分，大块等级至少切出MIN_BLOCKS_PER_SLAB块
+    size_t blockSize = blockSizeOf(cls);
+    size_t blockCount = SLAB_SIZE / blockSize;
+    if (blockCount < MIN_BLOCKS_PER_SLAB) blockCount = MIN_BLOCKS_PER_SLAB;
+
+    SizeClass& sc = m_classes[cls];
+    std::unique_ptr<char[]> slab(new char[blockSize * blockCount]);
+    char* base = slab.get();
+    for (size_t i = blockCount; i > 0; --i) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(base + (i - 1) * blockSize);
+        block->next = sc.freeList;
+        sc.freeList = block;
+    }
+    sc.slabs.emplace_back(std::move(slab));
+    sc.totalBlocks += blockCount;
+}
+
+int PayloadAllocator::takeBatch(int cls, FreeBlock*& head, int count)
+{
+    SizeClass& sc = m_classes[cls];
+    QMutexLocker locker(&sc.mutex);
+    int taken = 0;
+    while (taken < count) {
+        if (!sc.freeList) growLocked(cls);
+        FreeBlock* block = sc.freeList;
+        sc.freeList = block->next;
+        block->next = head;
+        head = block;
+        taken++;
+    }
+    return taken;
+}
+
+void PayloadAllocator::returnBatch(int cls, FreeBlock* head, FreeBlock* tail, int count)
+{
+    if (count == 0) return;
+    SizeClass& sc = m_classes[cls];
+    QMutexLocker locker(&sc.mutex);
+    tail->next = sc.freeList;
+    sc.freeList = head;
+}
+
+void* PayloadAllocator::allocate(size_t size)
+{
+    if (size == 0) return nullptr;
+    m_requestedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    // 超过最大等级，直接系统分配
+    if (size > MAX_BLOCK_SIZE) {
+        m_largeBytes.fetch_add(size, std::memory_order_relaxed);
+        m_largeCount.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    int cls = sizeClassOf(size);
+    SizeClass& sc = m_classes[cls];
+    sc.inUseBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    ThreadCache* cache = currentCache();
+    if (!cache) {
+        // 未绑定缓存的线程：加锁取一个块
+        FreeBlock* block = nullptr;
+        takeBatch(cls, block, 1);
+        return block;
+    }
+
+    // 缓存为空时，从中心链表成批补充
+    if (!cache->m_heads[cls]) {
+        int taken = takeBatch(cls, cache->m_heads[cls], CACHE_BATCH);
+        cache->m_counts[cls] += taken;
+        sc.cachedBlocks.fetch_add(taken, std::memory_order_relaxed);
+    }
+    FreeBlock* block = cache->m_heads[cls];
+    cache->m_heads[cls] = block->next;
+    cache->m_counts[cls]--;
+    sc.cachedBlocks.fetch_sub(1, std::memory_order_relaxed);
+    return block;
+}
+
+void PayloadAllocator::deallocate(void* ptr, size_t size)
+{
+    if (!ptr) return;
+    m_requestedBytes.fetch_sub(size, std::memory_order_relaxed);
+
+    if (size > MAX_BLOCK_SIZE) {
+        m_largeBytes.fetch_sub(size, std::memory_order_relaxed);
+        m_largeCount.fetch_sub(1, std::memory_order_relaxed);
+        ::operator delete(ptr);
+        return;
+    }
+
+    int cls = sizeClassOf(size);
+    SizeClass& sc = m_classes[cls];
+    sc.inUseBlocks.fetch_sub(1, std::memory_order_relaxed);
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+
+    ThreadCache* cache = currentCache();
+    if (!cache) {
+        returnBatch(cls, block, block, 1);
+        return;
+    }
+
+    // 先进本线程缓存；超过两倍批量时，成批归还CACHE_BATCH个块
+    block->next = cache->m_heads[cls];
+    cache->m_heads[cls] = block;
+    cache->m_counts[cls]++;
+    sc.cachedBlocks.fetch_add(1, std::memory_order_relaxed);
+    if (cache->m_counts[cls] > 2 * CACHE_BATCH) {
+        FreeBlock* head = cache->m_heads[cls];
+        FreeBlock* tail = head;
+        for (int i = 1; i < CACHE_BATCH; ++i) tail = tail->next;
+        cache->m_heads[cls] = tail->next;
+        cache->m_counts[cls] -= CACHE_BATCH;
+        sc.cachedBlocks.fetch_sub(CACHE_BATCH, std::memory_order_relaxed);
+        returnBatch(cls, head, tail, CACHE_BATCH);
+    }
+}
+
+void PayloadAllocator::ThreadCache::flush()
+{
+    if (!m_owner) return;
+    for (int cls = 0; cls < SIZE_CLASS_COUNT; ++cls) {
+        int count = m_counts[cls];
+        if (count == 0) continue;
+        FreeBlock* head = m_heads[cls];
+        FreeBlock* tail = head;
+        while (tail->next) tail = tail->next;
+        m_owner->returnBatch(cls, head, tail, count);
+        m_owner->m_classes[cls].cachedBlocks.fetch_sub(count, std::memory_order_relaxed);
+        m_heads[cls] = nullptr;
+        m_counts[cls] = 0;
+    }
+}
+
+PayloadAllocatorStats PayloadAllocator::stats() const
+{
+    PayloadAllocatorStats result;
+    for (int cls = 0; cls < SIZE_CLASS_COUNT; ++cls) {
+        const SizeClass& sc = m_classes[cls];
+        PayloadSizeClassStats classStats;
+        classStats.blockSize = blockSizeOf(cls);
+        {
+            QMutexLocker locker(&sc.mutex);
+            classStats.slabCount = sc.slabs.size();
+            classStats.totalBlocks = sc.totalBlocks;
+        }
+        if (classStats.slabCount == 0) continue;
+        classStats.inUseBlocks = sc.inUseBlocks.load(std::memory_order_relaxed);
+        classStats.cachedBlocks = sc.cachedBlocks.load(std::memory_order_relaxed);
+
+        result.slabBytes += classStats.totalBlocks * classStats.blockSize;
+        result.inUseBytes += classStats.inUseBlocks * classStats.blockSize;
+        result.cachedBytes += classStats.cachedBlocks * classStats.blockSize;
+        result.classes.append(classStats);
+    }
+    result.largeBytes = m_largeBytes.load(std::memory_order_relaxed);
+    result.largeCount = m_largeCount.load(std::memory_order_relaxed);
+    // requestedBytes包含large部分，计算碎片率时只算slab部分
+    quint64 requested = m_requestedBytes.load(std::memory_order_relaxed);
+    result.requestedBytes = requested;
+    quint64 slabRequested = requested > result.largeBytes ? requested - result.largeBytes : 0;
+
+    if (result.slabBytes > 0) {
+        result.occupancy = result.inUseBytes / (double)result.slabBytes;
+    }
+    if (result.inUseBytes > 0) {
+        result.internalFragmentation = 1.0 - slabRequested / (double)result.inUseBytes;
+    }
+    return result;
+}
@@ -0,0 +1,117 @@
+#ifndef PAYLOADALLOCATOR_H
+#define PAYLOADALLOCATOR_H
+
+#include <QMutex>
+#include <QList>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/*
+ * 任务载荷(Task::memPtr)的分级slab分配器
+ * 1. 按2的幂分成若干尺寸等级(16B~64KB)，每级从整块slab中切分固定大小的块，超过最大等级的直接走系统分配。
+ * 2. 每个工作线程持有一个ThreadCache（见ThreadPool::WorkerRecord），本线程的分配/释放先走缓存，不加锁。
+ * 3. 载荷通常在生产线程分配、在工作线程释放：释放的块先进工作线程缓存，超过水位后成批(CACHE_BATCH个)归还中心空闲链表，一次加锁。
+ * 4. 没有绑定缓存的线程（如UI线程）直接加锁访问中心空闲链表。
+ */
+
+// 单个尺寸等级的统计
+struct PayloadSizeClassStats
+{
+    size_t blockSize = 0;
+    quint64 slabCount = 0;      // 已申请的slab个数
+    quint64 totalBlocks = 0;    // slab切出的块总数
+    quint64 inUseBlocks = 0;    // 正在被任务使用的块
+    quint64 cachedBlocks = 0;   // 躺在各线程缓存里的空闲块
+};
+
+// 分配器整体统计，供autoReportStatus()上报
+struct PayloadAllocatorStats
+{
+    quint64 slabBytes = 0;      // slab占用的总字节
+    quint64 inUseBytes = 0;     // 已分配块的字节（按块大小计）
+    quint64 requestedBytes = 0; // 任务实际申请的字节
+    quint64 cachedBytes = 0;    // 线程缓存中的空闲字节
+    quint64 largeBytes = 0;     // 超过最大等级、直接系统分配的字节
+    quint64 largeCount = 0;
+    double occupancy = 0.0;             // inUseBytes / slabBytes
+    double internalFragmentation = 0.0; // 1 - requestedBytes / inUseBytes
+    QList<PayloadSizeClassStats> classes;
+};
+
+class PayloadAllocator
+{
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+public:
+    static const int SIZE_CLASS_COUNT = 13;             // 16B, 32B, ... , 64KB
+    static const size_t MIN_BLOCK_SIZE = 16;
+    static const size_t MAX_BLOCK_SIZE = MIN_BLOCK_SIZE << (SIZE_CLASS_COUNT - 1);
+    static const size_t SLAB_SIZE = 64 * 1024;          // 小块等级每个slab的字节数
+    static const int MIN_BLOCKS_PER_SLAB = 8;           // 大块等级每个slab至少切出的块数
+    static const int CACHE_BATCH = 32;                  // 线程缓存与中心链表之间一次搬运的块数
+
+    // 线程本地缓存，由工作线程的记录持有，只在所属线程上使用
+    class ThreadCache
+    {
+    public:
+        explicit ThreadCache(PayloadAllocator* owner) : m_owner(owner) {}
+        ~ThreadCache() { flush(); }
+        ThreadCache(const ThreadCache&) = delete;
+        ThreadCache& operator=(const ThreadCache&) = delete;
+        // 把缓存中的块全部还给中心链表（线程退出时调用）
+        void flush();
+
+    private:
+        friend class PayloadAllocator;
+        PayloadAllocator* m_owner;
+        FreeBlock* m_heads[SIZE_CLASS_COUNT] = {};
+        int m_counts[SIZE_CLASS_COUNT] = {};
+    };
+
+    PayloadAllocator() = default;
+    ~PayloadAllocator() = default;
+    PayloadAllocator(const PayloadAllocator&) = delete;
+    PayloadAllocator& operator=(const PayloadAllocator&) = delete;
+
+    // size为0时返回nullptr；释放时必须传回相同的size
+    void* allocate(size_t size);
+    void deallocate(void* ptr, size_t size);
+
+    // 让当前线程使用cache（nullptr解绑），工作线程启动/退出时（ThreadPool::onThreadSpawned/onThreadExited）调用
+    void bindThreadCache(ThreadCache* cache);
+
+    PayloadAllocatorStats stats() const;
+    // 当前任务申请的总字节（无锁读取）
+    quint64 requestedBytes() const { return m_requestedBytes.load(std::memory_order_relaxed); }
+
+private:
+    struct SizeClass
+    {
+        mutable QMutex mutex;   // 保护freeList/slabs
+        FreeBlock* freeList = nullptr;
+        std::vector<std::unique_ptr<char[]>> slabs;
+        quint64 totalBlocks = 0;
+        std::atomic<quint64> inUseBlocks{0};
+        std::atomic<quint64> cachedBlocks{0};
+    };
+
+    static int sizeClassOf(size_t size);
+    static size_t blockSizeOf(int cls) { return MIN_BLOCK_SIZE << cls; }
+    ThreadCache* currentCache() const;
+
+    // 调用方需持有SizeClass::mutex
+    void growLocked(int cls);
+    // 从中心链表取最多count个块，挂到链表头；返回实际取到的个数
+    int takeBatch(int cls, FreeBlock*& head, int count);
+    // 把count个块组成的链表还给中心链表
+    void returnBatch(int cls, FreeBlock* head, FreeBlock* tail, int count);
+
+    SizeClass m_classes[SIZE_CLASS_COUNT];
+    std::atomic<quint64> m_requestedBytes{0};
+    std::atomic<quint64> m_largeBytes{0};
+    std::atomic<quint64> m_largeCount{0};
+};
+
+#endif // PAYLOADALLOCATOR_H
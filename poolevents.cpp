@@ -0,0 +1,31 @@
+#include "poolevents.h"
+#include <algorithm>
+
+std::shared_ptr<PoolEventSubscription> PoolEventBus::subscribe(size_t capacity)
+{
+    auto subscription = std::make_shared<PoolEventSubscription>(capacity);
+    QMutexLocker locker(&m_mutex);
+    m_subscribers.push_back(subscription);
+    return subscription;
+}
+
+void PoolEventBus::unsubscribe(const std::shared_ptr<PoolEventSubscription>& subscription)
+{
+    QMutexLocker locker(&m_mutex);
+    m_subscribers.erase(std::remove(m_subscribers.begin(), m_subscribers.end(), subscription),
+                        m_subscribers.end());
+}
+
+quint64 PoolEventBus::publish(PoolEvent event)
+{
+    QMutexLocker locker(&m_mutex);
+    event.seq = m_seq.load(std::memory_order_relaxed) + 1;
+    for (const auto& subscriber : m_subscribers) {
+        // 队列满：丢弃，订阅者之后通过快照重新同步
+        if (!subscriber->m_queue.push(event)) {
+            subscriber->m_overflowed.store(true, std::memory_order_release);
+        }
+    }
+    m_seq.store(event.seq, std::memory_order_release);
+    return event.seq;
+}
@@ -0,0 +1,96 @@
+#ifndef POOLEVENTS_H
+#define POOLEVENTS_H
+
+#include <QMutex>
+#include <QList>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "spscqueue.h"
+#include "visualinfo.h"
+#include "scheduler.h"
+
+/*
+ * 线程池增量事件流
+ * 1. 线程池每次状态变化发布一个PoolEvent，带全局递增的序号seq。
+ * 2. 每个订阅者一条SPSC无锁环形队列：发布端在PoolEventBus::m_mutex下串行写入（单生产者），订阅者线程无锁读出（单消费者）。
+ * 3. 队列满时丢弃事件并置overflowed，订阅者发现序号不连续或溢出后，用快照PoolSnapshot重新同步。
+ */
+
+enum class PoolEventType : quint8
+{
+    TaskEnqueued,       // 任务入队
+    TaskDispatched,     // 任务被线程取走
+    TaskProgress,       // 任务进度更新
+    TaskFinished,       // 任务完成
+    ThreadSpawned,      // 线程创建
+    ThreadExited,       // 线程退出
+    PolicyChanged       // 调度策略切换（等待队列需要按新策略重排）
+};
+
+struct PoolEvent
+{
+    quint64 seq = 0;
+    PoolEventType type = PoolEventType::TaskEnqueued;
+    int threadId = -1;
+    int taskId = -1;
+    int curTimeMs = 0;              // TaskProgress
+    int totalTimeMs = 0;            // TaskEnqueued / TaskFinished
+    int priority = 0;               // TaskEnqueued / TaskFinished
+    int arrivalTimestampMs = 0;     // TaskEnqueued / TaskFinished
+    int finishTimestampMs = 0;      // TaskFinished
+    int wallTimeUs = 0;             // TaskFinished
+    int cpuTimeUs = 0;              // TaskFinished
+    SchedulePolicy policy = SchedulePolicy::FIFO;   // PolicyChanged
+};
+
+// 全量快照，用于首次同步和丢事件后的重新同步
+struct PoolSnapshot
+{
+    // 线程池和PoolModel只保留最近这么多个已完成任务（界面展示用），累计统计另外维护
+    static const int FINISHED_HISTORY = 1000;
+
+    quint64 seq = 0;    // 快照对应的事件序号，序号<=seq的事件已包含在快照中
+    SchedulePolicy policy = SchedulePolicy::FIFO;
+    QList<ThreadVisualInfo> threads;
+    QList<TaskVisualInfo> waitingTasks;     // 按队列顺序
+    QList<TaskVisualInfo> finishedTasks;    // 最近FINISHED_HISTORY个，按完成顺序
+};
+
+// 单个订阅者的事件队列
+class PoolEventSubscription
+{
+public:
+    explicit PoolEventSubscription(size_t capacity) : m_queue(capacity) {}
+
+    // 订阅者线程调用
+    bool pop(PoolEvent& event) { return m_queue.pop(event); }
+    // 取出并清除溢出标记
+    bool takeOverflowed() { return m_overflowed.exchange(false, std::memory_order_acq_rel); }
+
+private:
+    friend class PoolEventBus;
+    SpscQueue<PoolEvent> m_queue;
+    std::atomic<bool> m_overflowed{false};
+};
+
+class PoolEventBus
+{
+public:
+    static const int DEFAULT_CAPACITY = 8192;
+
+    std::shared_ptr<PoolEventSubscription> subscribe(size_t capacity = DEFAULT_CAPACITY);
+    void unsubscribe(const std::shared_ptr<PoolEventSubscription>& subscription);
+
+    // 分配序号并投递给所有订阅者，返回序号
+    quint64 publish(PoolEvent event);
+    // 最近一次发布的序号
+    quint64 lastSeq() const { return m_seq.load(std::memory_order_acquire); }
+
+private:
+    QMutex m_mutex;     // 串行化发布端，保证每条SPSC队列只有一个生产者
+    std::vector<std::shared_ptr<PoolEventSubscription>> m_subscribers;
+    std::atomic<quint64> m_seq{0};
+};
+
+#endif // POOLEVENTS_H
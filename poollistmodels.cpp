@@ -0,0 +1,179 @@
+#include "poollistmodels.h"
+#include <algorithm>
+
+PoolListModel::PoolListModel(bool sortedByKey, QObject* parent)
+    : QAbstractListModel(parent), m_sortedByKey(sortedByKey)
+{
+}
+
+int PoolListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant PoolListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) return QVariant();
+    if (role == Qt::DisplayRole) return m_rows[index.row()].text;
+    return QVariant();
+}
+
+void PoolListModel::insertAt(int row, int key, const QString& text)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    m_rows.insert(row, Row{key, text});
+    endInsertRows();
+}
+
+void PoolListModel::removeAt(int row)
+{
+    if (row < 0 || row >= m_rows.size()) return;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rows.removeAt(row);
+    endRemoveRows();
+}
+
+void PoolListModel::upsert(int key, const QString& text)
+{
+    int row = lowerBound(key);
+    if (row < m_rows.size() && m_rows[row].key == key) {
+        if (m_rows[row].text != text) {
+            m_rows[row].text = text;
+            QModelIndex changed = index(row);
+            emit dataChanged(changed, changed, {Qt::DisplayRole});
+        }
+        return;
+    }
+    insertAt(row, key, text);
+}
+
+bool PoolListModel::removeKey(int key)
+{
+    int row = indexOf(key);
+    if (row < 0) return false;
+    removeAt(row);
+    return true;
+}
+
+void PoolListModel::resetRows(const QList<Row>& rows)
+{
+    beginResetModel();
+    m_rows = rows;
+    endResetModel();
+}
+
+int PoolListModel::indexOf(int key) const
+{
+    if (m_sortedByKey) {
+        int row = lowerBound(key);
+        return (row < m_rows.size() && m_rows[row].key == key) ? row : -1;
+    }
+    for (int row = 0; row < m_rows.size(); ++row) {
+        if (m_rows[row].key == key) return row;
+    }
+    return -1;
+}
+
+int PoolListModel::lowerBound(int key) const
+{
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), key,
+                               [](const Row& row, int value) { return row.key < value; });
+    return int(it - m_rows.begin());
+}
+
+PoolListModels::PoolListModels(const PoolModel& model)
+    : m_model(model)
+{
+}
+
+QString PoolListModels::waitingText(const TaskVisualInfo& info)
+{
+    return QString("任务%1 (%2s,★%3)")
+        .arg(info.taskId)
+        .arg(info.totalTimeMs / 1000.0, 0, 'f', 1)
+        .arg(info.priority);
+}
+
+QString PoolListModels::finishedText(const TaskVisualInfo& info)
+{
+    // 附带CPU效率：CPU时间/墙钟时间，sleep/IO型任务接近0%
+    double efficiency = info.wallTimeUs > 0 ? info.cpuTimeUs * 100.0 / info.wallTimeUs : 0.0;
+    return QString("任务%1 (T:%2,CPU %3%)").arg(info.taskId).arg(info.curThreadId).arg(efficiency, 0, 'f', 0);
+}
+
+void PoolListModels::waitingInserted(int row, const TaskVisualInfo& info)
+{
+    m_waiting.insertAt(row, info.taskId, waitingText(info));
+}
+
+void PoolListModels::waitingRemoved(int row)
+{
+    m_waiting.removeAt(row);
+}
+
+void PoolListModels::waitingReordered()
+{
+    QList<PoolListModel::Row> rows;
+    rows.reserve(m_model.waitingTaskNumber());
+    m_model.forEachWaiting([&rows](const TaskVisualInfo& info) {
+        rows.append({info.taskId, waitingText(info)});
+    });
+    m_waiting.resetRows(rows);
+}
+
+void PoolListModels::threadChanged(const ThreadVisualInfo& info)
+{
+    if (info.state == THREAD_BUSY) {
+        m_idle.removeKey(info.threadId);
+        m_working.upsert(info.threadId, QString("线程%1 (#%2)").arg(info.threadId).arg(info.curTaskId));
+        if (info.curTaskId != -1) {
+            m_running.upsert(info.threadId, QString("任务%1 (T:%2)").arg(info.curTaskId).arg(info.threadId));
+        } else {
+            m_running.removeKey(info.threadId);
+        }
+    } else {
+        m_working.removeKey(info.threadId);
+        m_running.removeKey(info.threadId);
+        if (info.state == THREAD_IDLE) {
+            m_idle.upsert(info.threadId, QString("线程%1").arg(info.threadId));
+        } else {
+            m_idle.removeKey(info.threadId);
+        }
+    }
+}
+
+void PoolListModels::threadRemoved(int threadId)
+{
+    m_working.removeKey(threadId);
+    m_running.removeKey(threadId);
+    m_idle.removeKey(threadId);
+}
+
+void PoolListModels::finishedAppended(const TaskVisualInfo& info)
+{
+    m_finished.append(info.taskId, finishedText(info));
+}
+
+void PoolListModels::finishedRemovedFirst()
+{
+    m_finished.removeAt(0);
+}
+
+void PoolListModels::modelReset()
+{
+    m_running.clear();
+    m_working.clear();
+    m_idle.clear();
+    for (const auto& info : m_model.threadInfos()) {
+        threadChanged(info);
+    }
+
+    QList<PoolListModel::Row> rows;
+    rows.reserve(m_model.finishedTasks().size());
+    for (const auto& info : m_model.finishedTasks()) {
+        rows.append({info.taskId, finishedText(info)});
+    }
+    m_finished.resetRows(rows);
+
+    waitingReordered();
+}
@@ -0,0 +1,86 @@
+#ifndef POOLLISTMODELS_H
+#define POOLLISTMODELS_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QString>
+#include "poolmodel.h"
+
+/*
+ * 任务/线程列表的数据模型（替代QListWidget）
+ * 1. 每行只保存一个key（任务ID或线程ID）和显示文字。
+ * 2. 插入、删除、修改都按行发出beginInsertRows/beginRemoveRows/dataChanged，视图只重绘变化的行。
+ * 3. sortedByKey为true时按key升序排列（线程列表），查找用二分；否则保持插入位置（任务列表），从前往后找。
+ */
+class PoolListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    struct Row
+    {
+        int key = 0;
+        QString text;
+    };
+
+    explicit PoolListModel(bool sortedByKey, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void insertAt(int row, int key, const QString& text);
+    void append(int key, const QString& text) { insertAt(m_rows.size(), key, text); }
+    void removeAt(int row);
+    // 按key插入或更新（有序模型用）
+    void upsert(int key, const QString& text);
+    bool removeKey(int key);
+    void resetRows(const QList<Row>& rows);
+    void clear() { resetRows({}); }
+
+private:
+    int indexOf(int key) const;
+    // 有序模型中第一个key不小于给定key的行
+    int lowerBound(int key) const;
+
+    bool m_sortedByKey;
+    QList<Row> m_rows;
+};
+
+/*
+监听PoolModel的变化，维护主界面上的五个列表：
+- 等待任务：与等待队列同序，按行插入/删除，策略切换时整体重建
+- 正在执行 / 忙碌线程 / 空闲线程：按线程ID排序，线程状态变化时在列表之间移动一行
+- 已完成任务：在末尾追加，超出保留个数时删掉第一行
+*/
+class PoolListModels : public PoolModelListener
+{
+public:
+    explicit PoolListModels(const PoolModel& model);
+
+    PoolListModel* waitingTasks() { return &m_waiting; }
+    PoolListModel* runningTasks() { return &m_running; }
+    PoolListModel* finishedTasks() { return &m_finished; }
+    PoolListModel* workingThreads() { return &m_working; }
+    PoolListModel* idleThreads() { return &m_idle; }
+
+    void waitingInserted(int row, const TaskVisualInfo& info) override;
+    void waitingRemoved(int row) override;
+    void waitingReordered() override;
+    void threadChanged(const ThreadVisualInfo& info) override;
+    void threadRemoved(int threadId) override;
+    void finishedAppended(const TaskVisualInfo& info) override;
+    void finishedRemovedFirst() override;
+    void modelReset() override;
+
+private:
+    static QString waitingText(const TaskVisualInfo& info);
+    static QString finishedText(const TaskVisualInfo& info);
+
+    const PoolModel& m_model;
+    PoolListModel m_waiting{false};
+    PoolListModel m_running{true};
+    PoolListModel m_finished{false};
+    PoolListModel m_working{true};
+    PoolListModel m_idle{true};
+};
+
+#endif // POOLLISTMODELS_H
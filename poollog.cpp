@@ -0,0 +1,220 @@
+#include "poollog.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    qint64 steadyNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    const char* levelName(LogLevel level)
+    {
+        switch (level) {
+            case LogLevel::Debug:   return "D";
+            case LogLevel::Info:    return "I";
+            case LogLevel::Warning: return "W";
+            case LogLevel::Error:   return "E";
+        }
+        return "?";
+    }
+
+    // 线程退出时把自己的队列标记为orphaned，剩余日志仍由排空线程读出
+    struct RingHolder
+    {
+        std::shared_ptr<void> ring;
+        std::atomic<bool>* orphaned = nullptr;
+        ~RingHolder()
+        {
+            if (orphaned) orphaned->store(true, std::memory_order_release);
+        }
+    };
+    thread_local RingHolder t_ringHolder;
+}
+
+/// RotatingFileSink /////////
+
+RotatingFileSink::RotatingFileSink(const QString& path, qint64 maxBytes, int maxFiles)
+    : m_path(path), m_maxBytes(maxBytes), m_maxFiles(maxFiles), m_file(path)
+{
+    m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+}
+
+void RotatingFileSink::rotate()
+{
+    m_file.close();
+    // 从最旧的开始往后挪：path.(n-1) -> path.n, ..., path -> path.1
+    QFile::remove(QString("%1.%2").arg(m_path).arg(m_maxFiles));
+    for (int i = m_maxFiles - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(m_path).arg(i), QString("%1.%2").arg(m_path).arg(i + 1));
+    }
+    if (m_maxFiles > 0) {
+        QFile::rename(m_path, m_path + ".1");
+    } else {
+        QFile::remove(m_path);
+    }
+    m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+}
+
+void RotatingFileSink::write(const QStringList& lines)
+{
+    if (!m_file.isOpen()) return;
+    QByteArray data = lines.join('\n').toUtf8();
+    data.append('\n');
+    if (m_file.size() > 0 && m_file.size() + data.size() > m_maxBytes) {
+        rotate();
+        if (!m_file.isOpen()) return;
+    }
+    m_file.write(data);
+    m_file.flush();
+}
+
+/// PoolLogger /////////
+
+PoolLogger& PoolLogger::instance()
+{
+    static PoolLogger logger;
+    return logger;
+}
+
+PoolLogger::~PoolLogger()
+{
+    stop();
+}
+
+void PoolLogger::start()
+{
+    QMutexLocker locker(&m_drainMutex);
+    if (m_drainThread) return;
+    m_stopping = false;
+    m_drainThread = std::make_unique<DrainThread>(this);
+    m_drainThread->start();
+}
+
+void PoolLogger::stop()
+{
+    {
+        QMutexLocker locker(&m_drainMutex);
+        if (!m_drainThread) return;
+        m_stopping = true;
+        m_drainWake.wakeAll();
+    }
+    m_drainThread->wait();
+    m_drainThread.reset();
+}
+
+bool PoolLogger::setFileSink(const QString& path, qint64 maxBytes, int maxFiles)
+{
+    QMutexLocker locker(&m_sinkMutex);
+    m_fileSink.reset();
+    if (path.isEmpty()) return true;
+    m_fileSink = std::make_unique<RotatingFileSink>(path, maxBytes, maxFiles);
+    if (!m_fileSink->isOpen()) {
+        m_fileSink.reset();
+        return false;
+    }
+    return true;
+}
+
+PoolLogger::ThreadRing* PoolLogger::currentRing()
+{
+    if (t_ringHolder.ring) return static_cast<ThreadRing*>(t_ringHolder.ring.get());
+    // 本线程第一次写日志：创建队列并登记，之后不再加锁
+    auto ring = std::make_shared<ThreadRing>();
+    {
+        QMutexLocker locker(&m_ringsMutex);
+        m_rings.append(ring);
+    }
+    t_ringHolder.ring = ring;
+    t_ringHolder.orphaned = &ring->orphaned;
+    return ring.get();
+}
+
+void PoolLogger::push(LogRecord& record)
+{
+    record.timestampNs = steadyNowNs();
+    if (!currentRing()->queue.push(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+QString PoolLogger::formatRecord(const LogRecord& record, qint64 wallOffsetMs)
+{
+    QString message = QString::fromUtf8(record.format);
+    for (int i = 0; i < record.argCount; ++i) {
+        const LogArg& arg = record.args[i];
+        switch (arg.kind) {
+            case LogArg::Int:    message = message.arg(arg.i); break;
+            case LogArg::UInt:   message = message.arg(arg.u); break;
+            case LogArg::Double: message = message.arg(arg.d, 0, 'f', 1); break;
+            case LogArg::Str:    message = message.arg(QString::fromUtf8(arg.s)); break;
+        }
+    }
+    QDateTime time = QDateTime::fromMSecsSinceEpoch(record.timestampNs / 1000000 + wallOffsetMs);
+    return QString("%1 %2 %3").arg(time.toString("hh:mm:ss.zzz"), levelName(record.level), message);
+}
+
+int PoolLogger::drain()
+{
+    QList<std::shared_ptr<ThreadRing>> rings;
+    {
+        QMutexLocker locker(&m_ringsMutex);
+        rings = m_rings;
+    }
+
+    m_batch.clear();
+    LogRecord record;
+    for (const auto& ring : rings) {
+        // 先读orphaned再读队列：标记之后不会再有新日志，读空即可回收
+        bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+        while (ring->queue.pop(record)) m_batch.push_back(record);
+        if (orphaned) {
+            QMutexLocker locker(&m_ringsMutex);
+            m_rings.removeOne(ring);
+        }
+    }
+
+    quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+    if (m_batch.empty() && dropped == m_reportedDropped) return 0;
+
+    // 各线程的日志按时间合并
+    std::stable_sort(m_batch.begin(), m_batch.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestampNs < b.timestampNs;
+    });
+    qint64 wallOffsetMs = QDateTime::currentMSecsSinceEpoch() - steadyNowNs() / 1000000;
+    QStringList lines;
+    lines.reserve(int(m_batch.size()) + 1);
+    for (const auto& r : m_batch) {
+        lines.append(formatRecord(r, wallOffsetMs));
+    }
+    if (dropped != m_reportedDropped) {
+        lines.append(QString("[日志]队列已满，丢弃 %1 条日志").arg(dropped - m_reportedDropped));
+        m_reportedDropped = dropped;
+    }
+
+    {
+        QMutexLocker locker(&m_sinkMutex);
+        if (m_fileSink) m_fileSink->write(lines);
+    }
+    emit linesReady(lines);
+    return lines.size();
+}
+
+void PoolLogger::DrainThread::run()
+{
+    while (true) {
+        {
+            QMutexLocker locker(&m_logger->m_drainMutex);
+            if (m_logger->m_stopping) break;
+            m_logger->m_drainWake.wait(&m_logger->m_drainMutex, DRAIN_INTERVAL_MS);
+            if (m_logger->m_stopping) break;
+        }
+        m_logger->drain();
+    }
+    // 退出前把剩余日志全部输出
+    m_logger->drain();
+}
@@ -0,0 +1,192 @@
+#ifndef POOLLOG_H
+#define POOLLOG_H
+
+#include <QObject>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QFile>
+#include <QList>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include "spscqueue.h"
+
+/*
+ * 异步批量日志
+ * 1. 级别可在编译期裁掉：POOL_LOG_MIN_LEVEL以下的POOL_LOG_XXX宏展开为空语句，参数也不会求值。
+ * 2. 每个写日志的线程一条SPSC无锁环形队列（第一次写日志时创建），写日志只拷贝格式串指针和数值参数，不格式化、不加锁。
+ * 3. 后台排空线程每DRAIN_INTERVAL_MS读空所有队列，按时间排序后统一格式化，成批交给UI（linesReady信号）和可选的滚动文件。
+ * 4. 队列满时丢弃并计数，内存有上限：每线程RING_CAPACITY条记录。
+ * 格式串用QString::arg的%1、%2...占位，必须是字符串字面量（排空线程延后读取）；字符串参数同理。
+ */
+
+enum class LogLevel : quint8
+{
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3
+};
+
+// 编译期最低级别，例如 DEFINES += POOL_LOG_MIN_LEVEL=1 去掉所有Debug日志
+#ifndef POOL_LOG_MIN_LEVEL
+#define POOL_LOG_MIN_LEVEL 0
+#endif
+
+// 延后格式化的参数：只存数值或静态字符串指针
+struct LogArg
+{
+    enum Kind : quint8 { Int, UInt, Double, Str };
+
+    LogArg() : kind(Int), i(0) {}
+    LogArg(int v) : kind(Int), i(v) {}
+    LogArg(long v) : kind(Int), i(v) {}
+    LogArg(long long v) : kind(Int), i(v) {}
+    LogArg(unsigned int v) : kind(UInt), u(v) {}
+    LogArg(unsigned long v) : kind(UInt), u(v) {}
+    LogArg(unsigned long long v) : kind(UInt), u(v) {}
+    LogArg(double v) : kind(Double), d(v) {}
+    LogArg(const char* v) : kind(Str), s(v) {}
+
+    Kind kind;
+    union {
+        qint64 i;
+        quint64 u;
+        double d;
+        const char* s;
+    };
+};
+
+struct LogRecord
+{
+    static const int MAX_ARGS = 4;
+
+    qint64 timestampNs = 0;     // steady clock
+    const char* format = nullptr;
+    LogLevel level = LogLevel::Info;
+    quint8 argCount = 0;
+    LogArg args[MAX_ARGS];
+};
+
+// 滚动文件：超过maxBytes时 path -> path.1 -> path.2 ...，最多保留maxFiles个旧文件
+class RotatingFileSink
+{
+public:
+    RotatingFileSink(const QString& path, qint64 maxBytes, int maxFiles);
+    bool isOpen() const { return m_file.isOpen(); }
+    void write(const QStringList& lines);
+
+private:
+    void rotate();
+
+    QString m_path;
+    qint64 m_maxBytes;
+    int m_maxFiles;
+    QFile m_file;
+};
+
+class PoolLogger : public QObject
+{
+    Q_OBJECT
+public:
+    static const int RING_CAPACITY = 256;       // 每线程环形队列的记录数
+    static const int DRAIN_INTERVAL_MS = 20;    // 排空周期，也是UI批量追加的最短间隔
+
+    static PoolLogger& instance();
+
+    // 启动/停止排空线程；stop()会先把剩余日志全部输出
+    void start();
+    void stop();
+
+    // 运行期级别过滤（编译期裁剪之外的第二道过滤）
+    void setMinLevel(LogLevel level) { m_minLevel.store(level, std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= m_minLevel.load(std::memory_order_relaxed); }
+
+    // 打开滚动文件输出，path为空时关闭
+    bool setFileSink(const QString& path, qint64 maxBytes = 4 * 1024 * 1024, int maxFiles = 3);
+
+    // 因队列满丢弃的日志条数
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    template<typename... Args>
+    void log(LogLevel level, const char* format, Args... args)
+    {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "too many log arguments");
+        if (!isEnabled(level)) return;
+        LogRecord record;
+        record.level = level;
+        record.format = format;
+        record.argCount = sizeof...(Args);
+        int idx = 0;
+        ((record.args[idx++] = LogArg(args)), ...);
+        push(record);
+    }
+
+signals:
+    // 在排空线程发出，跨线程自动排队到UI线程
+    void linesReady(const QStringList& lines);
+
+private:
+    // 一个写日志线程的队列；线程结束后标记orphaned，读空后由排空线程回收
+    struct ThreadRing
+    {
+        ThreadRing() : queue(RING_CAPACITY) {}
+        SpscQueue<LogRecord> queue;
+        std::atomic<bool> orphaned{false};
+    };
+
+    class DrainThread : public QThread
+    {
+    public:
+        explicit DrainThread(PoolLogger* logger) : m_logger(logger) {}
+    protected:
+        void run() override;
+    private:
+        PoolLogger* m_logger;
+    };
+
+    PoolLogger() = default;
+    ~PoolLogger();
+
+    void push(LogRecord& record);
+    ThreadRing* currentRing();
+    // 读空所有队列并输出，返回输出的行数
+    int drain();
+    static QString formatRecord(const LogRecord& record, qint64 wallOffsetMs);
+
+    std::atomic<LogLevel> m_minLevel{LogLevel::Debug};
+    std::atomic<quint64> m_dropped{0};
+    quint64 m_reportedDropped = 0;      // 只在排空线程访问
+
+    QMutex m_ringsMutex;                // 保护m_rings（只在线程第一次写日志和排空时加锁）
+    QList<std::shared_ptr<ThreadRing>> m_rings;
+
+    QMutex m_sinkMutex;                 // 保护m_fileSink
+    std::unique_ptr<RotatingFileSink> m_fileSink;
+
+    QMutex m_drainMutex;
+    QWaitCondition m_drainWake;
+    bool m_stopping = false;
+    std::unique_ptr<DrainThread> m_drainThread;
+    std::vector<LogRecord> m_batch;     // 排空缓冲区，只在排空线程访问
+};
+
+#if POOL_LOG_MIN_LEVEL <= 0
+#define POOL_LOG_DEBUG(...) PoolLogger::instance().log(LogLevel::Debug, __VA_ARGS__)
+#else
+#define POOL_LOG_DEBUG(...) do {} while (0)
+#endif
+#if POOL_LOG_MIN_LEVEL <= 1
+#define POOL_LOG_INFO(...) PoolLogger::instance().log(LogLevel::Info, __VA_ARGS__)
+#else
+#define POOL_LOG_INFO(...) do {} while (0)
+#endif
+#if POOL_LOG_MIN_LEVEL <= 2
+#define POOL_LOG_WARNING(...) PoolLogger::instance().log(LogLevel::Warning, __VA_ARGS__)
+#else
+#define POOL_LOG_WARNING(...) do {} while (0)
+#endif
+#define POOL_LOG_ERROR(...) PoolLogger::instance().log(LogLevel::Error, __VA_ARGS__)
+
+#endif // POOLLOG_H
@@ -0,0 +1,128 @@
+#include "poolmetrics.h"
+#include <QMutexLocker>
+#include <QThread>
+#include <QtAlgorithms>
+#include <algorithm>
+
+PoolMetrics::PoolMetrics()
+    : m_cpuCount(std::max(1, QThread::idealThreadCount())), m_ring(CAPACITY)
+{
+    for (auto& cell : m_waitHistogram) cell.store(0, std::memory_order_relaxed);
+}
+
+int PoolMetrics::waitBucketOf(int waitMs)
+{
+    if (waitMs < 0) waitMs = 0;
+    if (waitMs < LINEAR_BUCKETS) return waitMs;
+    int msb = 31 - qCountLeadingZeroBits(quint32(waitMs));     // >= 6
+    int sub = (waitMs >> (msb - 3)) & (SUB_BUCKETS - 1);
+    int bucket = LINEAR_BUCKETS + (msb - 6) * SUB_BUCKETS + sub;
+    return std::min(bucket, WAIT_BUCKETS - 1);
+}
+
+int PoolMetrics::waitBucketUpperMs(int bucket)
+{
+    if (bucket < LINEAR_BUCKETS) return bucket;
+    int msb = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 6;
+    int sub = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+    // 该格覆盖 [(8+sub) << (msb-3), (9+sub) << (msb-3))
+    return ((SUB_BUCKETS + sub + 1) << (msb - 3)) - 1;
+}
+
+void PoolMetrics::recordDispatch(int waitMs)
+{
+    m_waitHistogram[waitBucketOf(waitMs)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PoolMetrics::closeBucket(qint64 nowMs, int queueDepth, int aliveThreads, int busyThreads)
+{
+    // 取走本桶的计数；与工作线程并发时，少量样本会落到下一个桶，不影响趋势
+    quint32 finished = m_finished.exchange(0, std::memory_order_relaxed);
+    qint64 cpuNs = m_cpuNs.exchange(0, std::memory_order_relaxed);
+    quint32 histogram[WAIT_BUCKETS];
+    quint64 dispatched = 0;
+    for (int i = 0; i < WAIT_BUCKETS; ++i) {
+        histogram[i] = m_waitHistogram[i].exchange(0, std::memory_order_relaxed);
+        dispatched += histogram[i];
+    }
+    int p99 = 0;
+    if (dispatched > 0) {
+        quint64 target = (dispatched * 99 + 99) / 100;
+        quint64 seen = 0;
+        for (int i = 0; i < WAIT_BUCKETS; ++i) {
+            seen += histogram[i];
+            if (seen >= target) {
+                p99 = waitBucketUpperMs(i);
+                break;
+            }
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    qint64 elapsedMs = m_lastCloseMs > 0 ? nowMs - m_lastCloseMs : BUCKET_MS;
+    if (elapsedMs <= 0) elapsedMs = BUCKET_MS;
+    m_lastCloseMs = nowMs;
+
+    MetricsSample& sample = m_ring[m_head];
+    sample.timestampMs = nowMs;
+    sample.values[int(PoolMetric::Throughput)] = finished * 1000.0 / elapsedMs;
+    sample.values[int(PoolMetric::QueueDepth)] = queueDepth;
+    sample.values[int(PoolMetric::AliveThreads)] = aliveThreads;
+    sample.values[int(PoolMetric::BusyThreads)] = busyThreads;
+    sample.values[int(PoolMetric::P99WaitMs)] = p99;
+    sample.values[int(PoolMetric::CpuPercent)] = cpuNs / (elapsedMs * 1e6 * m_cpuCount) * 100.0;
+    m_head = (m_head + 1) % CAPACITY;
+    if (m_count < CAPACITY) m_count++;
+}
+
+QList<MetricsPoint> PoolMetrics::series(PoolMetric metric, qint64 windowMs, int maxPoints) const
+{
+    QList<MetricsPoint> points;
+    QMutexLocker locker(&m_mutex);
+    int wanted = int(std::min<qint64>(m_count, windowMs / BUCKET_MS));
+    if (wanted <= 0 || maxPoints <= 0) return points;
+    int group = (wanted + maxPoints - 1) / maxPoints;
+    points.reserve(wanted / group + 1);
+
+    int first = (m_head - wanted + CAPACITY) % CAPACITY;
+    for (int start = 0; start < wanted; start += group) {
+        MetricsPoint point;
+        const MetricsSample& head = m_ring[(first + start) % CAPACITY];
+        point.timestampMs = head.timestampMs;
+        point.min = point.max = head.values[int(metric)];
+        int end = std::min(wanted, start + group);
+        for (int i = start + 1; i < end; ++i) {
+            double value = m_ring[(first + i) % CAPACITY].values[int(metric)];
+            point.min = std::min(point.min, value);
+            point.max = std::max(point.max, value);
+        }
+        points.append(point);
+    }
+    return points;
+}
+
+int PoolMetrics::sampleCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_count;
+}
+
+double PoolMetrics::latest(PoolMetric metric) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_count == 0) return 0.0;
+    return m_ring[(m_head - 1 + CAPACITY) % CAPACITY].values[int(metric)];
+}
+
+const char* PoolMetrics::metricName(PoolMetric metric)
+{
+    switch (metric) {
+        case PoolMetric::Throughput:   return "吞吐量(任务/秒)";
+        case PoolMetric::QueueDepth:   return "队列长度";
+        case PoolMetric::AliveThreads: return "存活线程";
+        case PoolMetric::BusyThreads:  return "忙线程";
+        case PoolMetric::P99WaitMs:    return "p99等待(ms)";
+        case PoolMetric::CpuPercent:   return "CPU占用(%)";
+        default:                       return "";
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef POOLMETRICS_H
+#define POOLMETRICS_H
+
+#include <QMutex>
+#include <QList>
+#include <atomic>
+#include <vector>
+
+/*
+ * 线程池时间序列指标
+ * 1. 按固定间隔(BUCKET_MS)分桶，最近CAPACITY个桶存在环形缓冲区里（默认1小时）。
+ * 2. 工作线程只做原子自增：完成数+1、等待时间直方图对应格子+1、CPU时间累加，不加锁。
+ * 3. 线程池的定时器每个间隔调用一次closeBucket()：取走计数、读取队列长度/线程数，算出吞吐量和p99等待时间，写入环形缓冲区。
+ * 4. 读取长时间窗口时按组取min/max降采样，点数不超过图表宽度，也不会丢掉尖峰。
+ */
+
+enum class PoolMetric : int
+{
+    Throughput = 0,     // 任务/秒
+    QueueDepth,         // 等待队列长度
+    AliveThreads,
+    BusyThreads,
+    P99WaitMs,          // 桶内被调度任务的排队等待时间p99
+    CpuPercent,         // 工作线程实际CPU时间 / (桶长度 × CPU核数)
+    Count
+};
+
+struct MetricsSample
+{
+    qint64 timestampMs = 0;
+    double values[int(PoolMetric::Count)] = {};
+};
+
+// 降采样后的一个点：组内最小/最大值
+struct MetricsPoint
+{
+    qint64 timestampMs = 0;
+    double min = 0.0;
+    double max = 0.0;
+};
+
+class PoolMetrics
+{
+public:
+    static const int BUCKET_MS = 1000;
+    static const int CAPACITY = 3600;
+
+    PoolMetrics();
+    PoolMetrics(const PoolMetrics&) = delete;
+    PoolMetrics& operator=(const PoolMetrics&) = delete;
+
+    // 工作线程调用（无锁）
+    void recordDispatch(int waitMs);
+    void recordFinish() { m_finished.fetch_add(1, std::memory_order_relaxed); }
+    void recordCpu(qint64 cpuNs) { m_cpuNs.fetch_add(cpuNs, std::memory_order_relaxed); }
+
+    // 定时器调用：结束当前桶
+    void closeBucket(qint64 nowMs, int queueDepth, int aliveThreads, int busyThreads);
+
+    // 最近windowMs内的序列，超过maxPoints个桶时按组取min/max
+    QList<MetricsPoint> series(PoolMetric metric, qint64 windowMs, int maxPoints) const;
+    int sampleCount() const;
+    // 最近一个桶的值，没有数据时返回0
+    double latest(PoolMetric metric) const;
+    static const char* metricName(PoolMetric metric);
+
+private:
+    // 等待时间直方图：0~63ms每毫秒一格，之后每个2的幂区间分8格（相对误差约12%）
+    static const int LINEAR_BUCKETS = 64;
+    static const int SUB_BUCKETS = 8;
+    static const int WAIT_BUCKETS = LINEAR_BUCKETS + SUB_BUCKETS * 26;
+    static int waitBucketOf(int waitMs);
+    static int waitBucketUpperMs(int bucket);
+
+    std::atomic<quint32> m_finished{0};
+    std::atomic<qint64> m_cpuNs{0};
+    const int m_cpuCount;       // 计算CPU占比的分母
+    std::atomic<quint32> m_waitHistogram[WAIT_BUCKETS];
+
+    mutable QMutex m_mutex;     // 保护环形缓冲区（只有采样定时器写，UI读）
+    std::vector<MetricsSample> m_ring;
+    int m_head = 0;             // 下一个写入位置
+    int m_count = 0;
+    qint64 m_lastCloseMs = 0;
+};
+
+#endif // POOLMETRICS_H
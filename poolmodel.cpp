@@ -0,0 +1,259 @@
+#include "poolmodel.h"
+
+PoolModel::PoolModel()
+{
+    setPolicy(SchedulePolicy::FIFO);
+}
+
+PoolModel::~PoolModel()
+{
+    m_listener = nullptr;
+    clear();
+}
+
+void PoolModel::clear()
+{
+    while (TaskNode* node = m_waiting.takeFirst()) {
+        m_nodePool.release(node);
+    }
+    m_waitingById.clear();
+    m_waitingInfos.clear();
+    m_slotBase = 0;
+    m_threads.clear();
+    m_finishedTasks.clear();
+    m_lastSeq = 0;
+    m_synced = false;
+    if (m_listener) m_listener->modelReset();
+}
+
+void PoolModel::setPolicy(SchedulePolicy policy)
+{
+    m_policy = policy;
+    m_scheduler.reset(createScheduler(policy));
+    m_scheduler->sortQueue(m_waiting);
+    rebuildRows();
+    if (m_listener && !m_waiting.isEmpty()) m_listener->waitingReordered();
+}
+
+void PoolModel::refreshDynamicOrder()
+{
+    if (!m_scheduler->needDynamicSort() || m_waiting.size() < 2) return;
+    m_scheduler->sortQueue(m_waiting);
+    // 顺序没变就不通知，避免列表视图无谓地整体重置
+    int row = 0;
+    const TaskNode* node = m_waiting.head();
+    while (node && node->task.id == m_waitingInfos[row].taskId) {
+        node = node->next;
+        row++;
+    }
+    if (!node) return;
+    rebuildRows();
+    if (m_listener) m_listener->waitingReordered();
+}
+
+int PoolModel::sync(PoolEventSubscription& subscription, const std::function<PoolSnapshot()>& snapshotProvider)
+{
+    bool needResync = !m_synced || subscription.takeOverflowed();
+    int applied = 0;
+    PoolEvent event;
+    while (subscription.pop(event)) {
+        if (needResync) continue;   // 反正要重新同步，先把队列读空
+        if (!apply(event)) needResync = true;
+        else applied++;
+    }
+    if (needResync) {
+        resync(snapshotProvider());
+        // 快照期间到达的事件，序号<=快照序号的会被apply跳过
+        while (subscription.pop(event)) {
+            if (!apply(event)) {
+                // 极端情况下又丢了事件，留到下次同步
+                m_synced = false;
+                break;
+            }
+            applied++;
+        }
+    }
+    return applied;
+}
+
+bool PoolModel::apply(const PoolEvent& event)
+{
+    // 快照已包含的旧事件直接跳过
+    if (event.seq <= m_lastSeq) return true;
+    if (event.seq != m_lastSeq + 1) return false;
+    m_lastSeq = event.seq;
+
+    switch (event.type) {
+    case PoolEventType::TaskEnqueued:
+        addWaiting(event.taskId, event.totalTimeMs, event.priority, event.arrivalTimestampMs, true);
+        break;
+    case PoolEventType::TaskDispatched: {
+        removeWaiting(event.taskId);
+        ThreadVisualInfo& info = m_threads[event.threadId];
+        info.threadId = event.threadId;
+        info.state = THREAD_BUSY;
+        info.curTaskId = event.taskId;
+        info.curTimeMs = 0;
+        if (m_listener) m_listener->threadChanged(info);
+        break;
+    }
+    case PoolEventType::TaskProgress: {
+        auto it = m_threads.find(event.threadId);
+        if (it != m_threads.end()) it->curTimeMs = event.curTimeMs;
+        break;
+    }
+    case PoolEventType::TaskFinished: {
+        auto it = m_threads.find(event.threadId);
+        if (it != m_threads.end()) {
+            it->state = THREAD_IDLE;
+            it->curTaskId = -1;
+            it->curTimeMs = 0;
+            if (m_listener) m_listener->threadChanged(*it);
+        }
+        TaskVisualInfo info;
+        info.taskId = event.taskId;
+        info.state = TASK_FINISHED;
+        info.curThreadId = event.threadId;
+        info.totalTimeMs = event.totalTimeMs;
+        info.priority = event.priority;
+        info.arrivalTimestampMs = event.arrivalTimestampMs;
+        info.finishTimestampMs = event.finishTimestampMs;
+        info.wallTimeUs = event.wallTimeUs;
+        info.cpuTimeUs = event.cpuTimeUs;
+        m_finishedTasks.append(info);
+        if (m_listener) m_listener->finishedAppended(info);
+        if (m_finishedTasks.size() > PoolSnapshot::FINISHED_HISTORY) {
+            m_finishedTasks.removeFirst();
+            if (m_listener) m_listener->finishedRemovedFirst();
+        }
+        break;
+    }
+    case PoolEventType::ThreadSpawned: {
+        ThreadVisualInfo info;
+        info.threadId = event.threadId;
+        info.state = THREAD_IDLE;
+        m_threads[event.threadId] = info;
+        if (m_listener) m_listener->threadChanged(info);
+        break;
+    }
+    case PoolEventType::ThreadExited:
+        m_threads.remove(event.threadId);
+        if (m_listener) m_listener->threadRemoved(event.threadId);
+        break;
+    case PoolEventType::PolicyChanged:
+        setPolicy(event.policy);
+        break;
+    }
+    return true;
+}
+
+void PoolModel::resync(const PoolSnapshot& snapshot)
+{
+    // 重建期间不逐行通知，最后统一通知一次
+    PoolModelListener* listener = std::exchange(m_listener, nullptr);
+    clear();
+    setPolicy(snapshot.policy);
+    for (const auto& info : snapshot.threads) {
+        m_threads[info.threadId] = info;
+    }
+    // 快照已经是队列顺序，直接追加
+    for (const auto& info : snapshot.waitingTasks) {
+        addWaiting(info.taskId, info.totalTimeMs, info.priority, info.arrivalTimestampMs, false);
+    }
+    m_finishedTasks = snapshot.finishedTasks;
+    m_lastSeq = snapshot.seq;
+    m_synced = true;
+    m_listener = listener;
+    if (m_listener) m_listener->modelReset();
+}
+
+void PoolModel::addWaiting(int taskId, int totalTimeMs, int priority, int arrivalTimestampMs, bool byPolicy)
+{
+    Task task;
+    task.id = taskId;
+    task.totalTimeMs = totalTimeMs;
+    task.priority = priority;
+    task.arrivalTimestampMs = arrivalTimestampMs;
+    TaskNode* node = m_nodePool.acquire(std::move(task));
+    // HRRN的insertByPolicy每次都整体重排，这里只放到队尾，重排留给refreshDynamicOrder()
+    if (byPolicy && !m_scheduler->needDynamicSort()) m_scheduler->insertByPolicy(m_waiting, node);
+    else m_waiting.pushBack(node);
+
+    int row = node->prev ? int(m_waitingById.value(node->prev->task.id).slot - m_slotBase) + 1 : 0;
+    if (row < m_waiting.size() - 1 - row) {
+        // 前面的行少：前面各行slot和基准一起-1，行号不变，后面各行随基准整体+1
+        shiftSlots(m_waiting.head(), node, -1);
+        m_slotBase--;
+    } else {
+        shiftSlots(node->next, nullptr, 1);
+    }
+    m_waitingById.insert(taskId, WaitingEntry{node, m_slotBase + row});
+    TaskVisualInfo info = toVisualInfo(node->task);
+    m_waitingInfos.insert(row, info);
+    if (m_listener) m_listener->waitingInserted(row, info);
+}
+
+void PoolModel::removeWaiting(int taskId)
+{
+    auto it = m_waitingById.find(taskId);
+    if (it == m_waitingById.end()) return;
+    TaskNode* node = it->node;
+    int row = int(it->slot - m_slotBase);
+    m_waitingById.erase(it);
+    if (row < m_waiting.size() - 1 - row) {
+        // 通常是队头附近的任务被取走：前面各行slot和基准一起+1，后面各行随基准整体-1
+        shiftSlots(m_waiting.head(), node, 1);
+        m_slotBase++;
+    } else {
+        shiftSlots(node->next, nullptr, -1);
+    }
+    m_waiting.remove(node);
+    m_nodePool.release(node);
+    m_waitingInfos.removeAt(row);
+    if (m_listener) m_listener->waitingRemoved(row);
+}
+
+void PoolModel::shiftSlots(TaskNode* from, TaskNode* stop, qint64 delta)
+{
+    for (TaskNode* node = from; node != stop; node = node->next) {
+        auto it = m_waitingById.find(node->task.id);
+        if (it != m_waitingById.end()) it->slot += delta;
+    }
+}
+
+void PoolModel::rebuildRows()
+{
+    m_slotBase = 0;
+    m_waitingInfos.clear();
+    m_waitingInfos.reserve(m_waiting.size());
+    qint64 slot = 0;
+    for (TaskNode* node = m_waiting.head(); node; node = node->next) {
+        auto it = m_waitingById.find(node->task.id);
+        if (it != m_waitingById.end()) it->slot = slot;
+        slot++;
+        m_waitingInfos.append(toVisualInfo(node->task));
+    }
+}
+
+TaskVisualInfo PoolModel::toVisualInfo(const Task& task)
+{
+    TaskVisualInfo info;
+    info.taskId = task.id;
+    info.state = TASK_WAITING;
+    info.curThreadId = -1;
+    info.totalTimeMs = task.totalTimeMs;
+    info.priority = task.priority;
+    info.arrivalTimestampMs = task.arrivalTimestampMs;
+    info.finishTimestampMs = 0;
+    return info;
+}
+
+QList<ThreadVisualInfo> PoolModel::threadInfos() const
+{
+    QList<ThreadVisualInfo> infos;
+    infos.reserve(m_threads.size());
+    for (const auto& info : m_threads) {
+        infos.append(info);
+    }
+    return infos;
+}
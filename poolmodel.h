@@ -0,0 +1,114 @@
+#ifndef POOLMODEL_H
+#define POOLMODEL_H
+
+#include <QList>
+#include <QMap>
+#include <QHash>
+#include <functional>
+#include <memory>
+#include "poolevents.h"
+#include "tasklist.h"
+#include "scheduler.h"
+
+/*
+ * 观察者侧的线程池模型
+ * 1. 由PoolEvent增量更新，不再每次刷新都从线程池拷贝整份快照。
+ * 2. 等待队列复用TaskList+调度器维护顺序，与线程池内的队列顺序一致。
+ * 3. 序号不连续或订阅队列溢出时，用快照重新同步。
+ * 4. 每次变化按行通知PoolModelListener（如列表视图的模型），监听者只处理变化的部分。
+ * 5. 行号索引：每个等待任务记一个slot，行号 = slot - m_slotBase。在第row行插入/删除时，
+ *    前面的行少就把前面各行的slot和m_slotBase一起挪（前面的行号不变、后面的整体±1），否则挪后面各行，
+ *    代价为min(row, 队列长度-row)；FIFO的队尾入队、队头出队都是O(1)。
+ * 6. 等待任务另存一份按行排列的QList<TaskVisualInfo>，随插入/删除增量维护，视图直接按下标读可见范围，不再每帧拷贝。
+ * 7. HRRN的顺序随时间变化：新任务先放在队尾，整体重排只在refreshDynamicOrder()里做，由调用者按指标节拍调用。
+ * 8. 已完成任务只保留最近PoolSnapshot::FINISHED_HISTORY个，超出时从头部移除，累计统计从线程池读。
+ */
+
+// 模型变化的监听接口，行号均为变化发生时的位置
+class PoolModelListener
+{
+public:
+    virtual ~PoolModelListener() = default;
+    virtual void waitingInserted(int row, const TaskVisualInfo& info) = 0;
+    virtual void waitingRemoved(int row) = 0;
+    // 等待队列整体重排（切换策略、refreshDynamicOrder()）
+    virtual void waitingReordered() = 0;
+    // 线程新建或状态变化（进度变化不通知）
+    virtual void threadChanged(const ThreadVisualInfo& info) = 0;
+    virtual void threadRemoved(int threadId) = 0;
+    virtual void finishedAppended(const TaskVisualInfo& info) = 0;
+    // 已完成任务超出保留个数，移除最早的一个（第0行）
+    virtual void finishedRemovedFirst() = 0;
+    // 清空或快照重新同步后，监听者应按模型当前内容重建
+    virtual void modelReset() = 0;
+};
+
+class PoolModel
+{
+public:
+    PoolModel();
+    ~PoolModel();
+    PoolModel(const PoolModel&) = delete;
+    PoolModel& operator=(const PoolModel&) = delete;
+
+    // 读完订阅队列里的所有事件，必要时调用snapshotProvider重新同步；返回应用的事件数
+    int sync(PoolEventSubscription& subscription, const std::function<PoolSnapshot()>& snapshotProvider);
+    // 应用单个事件，序号不连续时返回false
+    bool apply(const PoolEvent& event);
+    void resync(const PoolSnapshot& snapshot);
+    void clear();
+
+    // 监听者不归模型所有，nullptr表示取消监听
+    void setListener(PoolModelListener* listener) { m_listener = listener; }
+
+    quint64 lastSeq() const { return m_lastSeq; }
+    SchedulePolicy policy() const { return m_policy; }
+
+    // 按线程ID升序
+    QList<ThreadVisualInfo> threadInfos() const;
+    // 按队列顺序（HRRN为上次refreshDynamicOrder()时的顺序，之后到达的在队尾），增量维护，不拷贝
+    const QList<TaskVisualInfo>& waitingTasks() const { return m_waitingInfos; }
+    // 最近PoolSnapshot::FINISHED_HISTORY个，按完成顺序
+    const QList<TaskVisualInfo>& finishedTasks() const { return m_finishedTasks; }
+    int waitingTaskNumber() const { return m_waiting.size(); }
+    // 按当前队列顺序遍历等待任务（不重排）
+    template<typename F>
+    void forEachWaiting(F&& f) const
+    {
+        for (const TaskVisualInfo& info : m_waitingInfos) f(info);
+    }
+    // 动态策略（HRRN）按当前时刻重排，有变化时整体通知一次waitingReordered()；其他策略什么都不做
+    void refreshDynamicOrder();
+
+private:
+    void setPolicy(SchedulePolicy policy);
+    void addWaiting(int taskId, int totalTimeMs, int priority, int arrivalTimestampMs, bool byPolicy);
+    void removeWaiting(int taskId);
+    // [from, stop)内各节点的slot加delta，stop为nullptr表示到队尾
+    void shiftSlots(TaskNode* from, TaskNode* stop, qint64 delta);
+    // 按链表顺序重新编号并重建m_waitingInfos（重排、切换策略后）
+    void rebuildRows();
+    static TaskVisualInfo toVisualInfo(const Task& task);
+
+    struct WaitingEntry
+    {
+        TaskNode* node = nullptr;
+        qint64 slot = 0;        // 行号 = slot - m_slotBase
+    };
+
+    quint64 m_lastSeq = 0;
+    bool m_synced = false;
+    SchedulePolicy m_policy = SchedulePolicy::FIFO;
+    std::unique_ptr<TaskScheduler> m_scheduler;
+
+    QMap<int, ThreadVisualInfo> m_threads;
+    TaskList m_waiting;
+    TaskNodePool m_nodePool;
+    QHash<int, WaitingEntry> m_waitingById;
+    qint64 m_slotBase = 0;
+    QList<TaskVisualInfo> m_waitingInfos;       // 与m_waiting同序
+    QList<TaskVisualInfo> m_finishedTasks;
+    PoolModelListener* m_listener = nullptr;
+};
+
+#endif // POOLMODEL_H
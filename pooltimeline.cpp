@@ -0,0 +1,122 @@
+#include "pooltimeline.h"
+#include <QDateTime>
+#include <QMutexLocker>
+#include <algorithm>
+
+/// ThreadTimeline /////////
+
+ThreadTimeline::ThreadTimeline(int threadId)
+    : m_threadId(threadId), m_ring(CAPACITY)
+{
+}
+
+void ThreadTimeline::begin(int taskId, int priority, SchedulePolicy policy, qint64 startMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_open.taskId = taskId;
+    m_open.priority = priority;
+    m_open.policy = policy;
+    m_open.startMs = startMs;
+    m_open.endMs = 0;
+    m_hasOpen = true;
+}
+
+void ThreadTimeline::end(qint64 endMs)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_hasOpen) return;
+    m_open.endMs = std::max(endMs, m_open.startMs);
+    m_ring[m_closed % CAPACITY] = m_open;
+    m_closed++;
+    m_hasOpen = false;
+}
+
+void ThreadTimeline::markExited(qint64 exitMs)
+{
+    // 线程退出时不会有正在执行的任务；万一有，按退出时刻结束
+    end(exitMs);
+    m_exited.store(true, std::memory_order_release);
+}
+
+quint64 ThreadTimeline::closedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_closed;
+}
+
+quint64 ThreadTimeline::readSince(quint64 fromSeq, QVector<TimelineInterval>& out) const
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 oldest = m_closed > quint64(CAPACITY) ? m_closed - CAPACITY : 0;
+    for (quint64 seq = std::max(fromSeq, oldest); seq < m_closed; ++seq) {
+        out.append(m_ring[seq % CAPACITY]);
+    }
+    return m_closed;
+}
+
+void ThreadTimeline::readRange(qint64 fromMs, qint64 toMs, QVector<TimelineInterval>& out) const
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 oldest = m_closed > quint64(CAPACITY) ? m_closed - CAPACITY : 0;
+    // 二分查找第一个结束时间晚于fromMs的区间
+    quint64 lo = oldest, hi = m_closed;
+    while (lo < hi) {
+        quint64 mid = lo + (hi - lo) / 2;
+        if (m_ring[mid % CAPACITY].endMs <= fromMs) lo = mid + 1;
+        else hi = mid;
+    }
+    for (quint64 seq = lo; seq < m_closed; ++seq) {
+        const TimelineInterval& interval = m_ring[seq % CAPACITY];
+        if (interval.startMs >= toMs) break;
+        out.append(interval);
+    }
+}
+
+bool ThreadTimeline::running(TimelineInterval& out) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_hasOpen) return false;
+    out = m_open;
+    return true;
+}
+
+/// PoolTimeline /////////
+
+PoolTimeline::PoolTimeline()
+    : m_originMs(QDateTime::currentMSecsSinceEpoch())
+{
+}
+
+std::shared_ptr<ThreadTimeline> PoolTimeline::addLane(int threadId)
+{
+    auto lane = std::make_shared<ThreadTimeline>(threadId);
+    QMutexLocker locker(&m_mutex);
+    // 已退出线程太多时丢弃最早的（线程ID递增，列表前面的就是最早的）
+    int exitedCount = 0;
+    for (const auto& existing : m_lanes) {
+        if (existing->exited()) exitedCount++;
+    }
+    for (int i = 0; i < m_lanes.size() && exitedCount > MAX_EXITED_LANES; ) {
+        if (m_lanes[i]->exited()) {
+            m_lanes.removeAt(i);
+            exitedCount--;
+        } else {
+            ++i;
+        }
+    }
+    m_lanes.append(lane);
+    m_generation++;
+    return lane;
+}
+
+QList<std::shared_ptr<ThreadTimeline>> PoolTimeline::lanes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lanes;
+}
+
+quint64 PoolTimeline::laneGeneration() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_generation;
+}
@@ -0,0 +1,94 @@
+#ifndef POOLTIMELINE_H
+#define POOLTIMELINE_H
+
+#include <QMutex>
+#include <QList>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "scheduler.h"
+
+/*
+ * 线程执行时间线（甘特图数据）
+ * 1. 每个工作线程一条ThreadTimeline：环形缓冲区保存最近CAPACITY个已结束的执行区间(任务ID、开始、结束)，
+ *    另记一个正在执行的区间。写入方只有该线程自己，锁只会和UI读取竞争。
+ * 2. 同一线程的任务是串行执行的，区间按开始/结束时间都有序：
+ *    按时间范围读取时二分查找，按序号读取时只取上次之后新结束的区间（视图据此增量绘制）。
+ * 3. 线程退出后时间线仍然保留，便于查看历史；已退出的线程超过MAX_EXITED_LANES条时丢弃最早的。
+ * 4. 时间统一用QDateTime::currentMSecsSinceEpoch()，与时间序列指标一致。
+ */
+
+struct TimelineInterval
+{
+    int taskId = -1;
+    int priority = 0;
+    SchedulePolicy policy = SchedulePolicy::FIFO;   // 调度该任务时的策略
+    qint64 startMs = 0;
+    qint64 endMs = 0;       // 正在执行的区间为0
+};
+
+class ThreadTimeline
+{
+public:
+    static const int CAPACITY = 8192;
+
+    explicit ThreadTimeline(int threadId);
+    ThreadTimeline(const ThreadTimeline&) = delete;
+    ThreadTimeline& operator=(const ThreadTimeline&) = delete;
+
+    int threadId() const { return m_threadId; }
+
+    /// 工作线程调用/////////
+    void begin(int taskId, int priority, SchedulePolicy policy, qint64 startMs);
+    void end(qint64 endMs);
+    void markExited(qint64 exitMs);
+
+    /// 读取/////////
+    bool exited() const { return m_exited.load(std::memory_order_acquire); }
+    // 累计已结束的区间数（即下一个区间的序号）
+    quint64 closedCount() const;
+    // 序号>=fromSeq的已结束区间（已被覆盖的跳过），返回下一次读取的起始序号
+    quint64 readSince(quint64 fromSeq, QVector<TimelineInterval>& out) const;
+    // 与[fromMs, toMs)相交的已结束区间，按时间顺序
+    void readRange(qint64 fromMs, qint64 toMs, QVector<TimelineInterval>& out) const;
+    // 正在执行的区间，没有时返回false
+    bool running(TimelineInterval& out) const;
+
+private:
+    const int m_threadId;
+    mutable QMutex m_mutex;
+    std::vector<TimelineInterval> m_ring;
+    quint64 m_closed = 0;       // 序号seq的区间存放在m_ring[seq % CAPACITY]
+    TimelineInterval m_open;
+    bool m_hasOpen = false;
+    std::atomic<bool> m_exited{false};
+};
+
+class PoolTimeline
+{
+public:
+    static const int MAX_EXITED_LANES = 32;
+
+    PoolTimeline();
+    PoolTimeline(const PoolTimeline&) = delete;
+    PoolTimeline& operator=(const PoolTimeline&) = delete;
+
+    // 时间线起点（线程池创建时刻）
+    qint64 originMs() const { return m_originMs; }
+
+    // 新线程登记一条时间线，由该线程持有并写入
+    std::shared_ptr<ThreadTimeline> addLane(int threadId);
+    // 所有时间线，按线程ID升序
+    QList<std::shared_ptr<ThreadTimeline>> lanes() const;
+    // 增删时间线时+1，视图据此重新取lanes()
+    quint64 laneGeneration() const;
+
+private:
+    const qint64 m_originMs;
+    mutable QMutex m_mutex;
+    QList<std::shared_ptr<ThreadTimeline>> m_lanes;
+    quint64 m_generation = 0;
+};
+
+#endif // POOLTIMELINE_H
@@ -0,0 +1,191 @@
+#include "pooltrace.h"
+#include <QFile>
+#include <QMutexLocker>
+#include <chrono>
+
+std::atomic<bool> PoolTracer::s_enabled{false};
+
+namespace {
+    thread_local std::shared_ptr<void> t_buffer;    // 实际类型为PoolTracer::Buffer
+    thread_local QString t_threadName;
+
+    // JSON字符串转义（名字都来自本程序，只处理引号、反斜杠和控制字符）
+    QByteArray jsonString(const QByteArray& text)
+    {
+        QByteArray out;
+        out.reserve(text.size() + 2);
+        out.append('"');
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                out.append('\\');
+                out.append(c);
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out.append(' ');
+            } else {
+                out.append(c);
+            }
+        }
+        out.append('"');
+        return out;
+    }
+
+    // 纳秒 -> 微秒字符串，保留3位小数
+    QByteArray micros(qint64 ns)
+    {
+        return QByteArray::number(ns / 1000.0, 'f', 3);
+    }
+}
+
+PoolTracer::Buffer::Buffer(int track, const QString& name, quint64 generation)
+    : events(new TraceEvent[BUFFER_CAPACITY]), track(track), name(name), generation(generation)
+{
+}
+
+PoolTracer& PoolTracer::instance()
+{
+    static PoolTracer tracer;
+    return tracer;
+}
+
+qint64 PoolTracer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PoolTracer::setCurrentThreadName(const QString& name)
+{
+    t_threadName = name;
+}
+
+void PoolTracer::start()
+{
+    QMutexLocker locker(&m_mutex);
+    // 旧缓冲区由仍持有它的线程在下一次记录时丢弃
+    m_buffers.clear();
+    m_generation.fetch_add(1, std::memory_order_release);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_startNs = nowNs();
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void PoolTracer::stop()
+{
+    s_enabled.store(false, std::memory_order_release);
+}
+
+PoolTracer::Buffer* PoolTracer::currentBuffer()
+{
+    quint64 generation = m_generation.load(std::memory_order_acquire);
+    auto* buffer = static_cast<Buffer*>(t_buffer.get());
+    if (buffer && buffer->generation == generation) return buffer;
+    // 本线程第一次记录（或重新start()之后）：创建缓冲区并登记为新轨道
+    QMutexLocker locker(&m_mutex);
+    int track = m_buffers.size() + 1;
+    QString name = t_threadName.isEmpty() ? QString("线程%1").arg(track) : t_threadName;
+    auto created = std::make_shared<Buffer>(track, name, generation);
+    m_buffers.append(created);
+    t_buffer = created;
+    return created.get();
+}
+
+void PoolTracer::append(const TraceEvent& event)
+{
+    Buffer* buffer = currentBuffer();
+    int count = buffer->count.load(std::memory_order_relaxed);
+    if (count >= BUFFER_CAPACITY) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[count] = event;
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+void PoolTracer::record(char phase, const char* name, TraceArg a, TraceArg b)
+{
+    TraceEvent event;
+    event.timestampNs = nowNs();
+    event.name = name;
+    event.phase = phase;
+    event.args[0] = a;
+    event.args[1] = b;
+    append(event);
+}
+
+void PoolTracer::complete(const char* name, qint64 startNs, qint64 durationNs, TraceArg a)
+{
+    TraceEvent event;
+    event.timestampNs = startNs;
+    event.durationNs = durationNs;
+    event.name = name;
+    event.phase = 'X';
+    event.args[0] = a;
+    append(event);
+}
+
+bool PoolTracer::exportChromeJson(const QString& path) const
+{
+    QList<std::shared_ptr<Buffer>> buffers;
+    qint64 startNs = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        buffers = m_buffers;
+        startNs = m_startNs;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    // 逐条拼接写出，不在内存中构造整个JSON文档
+    QByteArray chunk;
+    chunk.reserve(64 * 1024);
+    bool first = true;
+    auto beginEvent = [&]() {
+        if (!first) chunk.append(",\n");
+        first = false;
+        if (chunk.size() > 60 * 1024) {
+            file.write(chunk);
+            chunk.clear();
+        }
+    };
+
+    chunk.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    beginEvent();
+    chunk.append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ThreadPool\"}}");
+    for (const auto& buffer : buffers) {
+        // 轨道名和排序
+        beginEvent();
+        chunk.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":")
+             .append(QByteArray::number(buffer->track))
+             .append(",\"args\":{\"name\":").append(jsonString(buffer->name.toUtf8())).append("}}");
+        beginEvent();
+        chunk.append("{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":")
+             .append(QByteArray::number(buffer->track))
+             .append(",\"args\":{\"sort_index\":").append(QByteArray::number(buffer->track)).append("}}");
+
+        int count = buffer->count.load(std::memory_order_acquire);
+        for (int i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[i];
+            beginEvent();
+            chunk.append("{\"name\":").append(jsonString(event.name))
+                 .append(",\"ph\":\"").append(event.phase)
+                 .append("\",\"ts\":").append(micros(event.timestampNs - startNs))
+                 .append(",\"pid\":1,\"tid\":").append(QByteArray::number(buffer->track));
+            if (event.phase == 'X') chunk.append(",\"dur\":").append(micros(event.durationNs));
+            if (event.phase == 'i') chunk.append(",\"s\":\"t\"");
+            if (event.args[0].name) {
+                chunk.append(",\"args\":{");
+                for (int a = 0; a < 2 && event.args[a].name; ++a) {
+                    if (a > 0) chunk.append(',');
+                    chunk.append(jsonString(event.args[a].name)).append(':')
+                         .append(QByteArray::number(event.args[a].value));
+                }
+                chunk.append('}');
+            }
+            chunk.append('}');
+        }
+    }
+    chunk.append("\n]}\n");
+    file.write(chunk);
+    return file.error() == QFileDevice::NoError;
+}
@@ -0,0 +1,93 @@
+#ifndef POOLTRACE_H
+#define POOLTRACE_H
+
+#include <QMutex>
+#include <QList>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+/*
+ * 任务生命周期追踪（导出为Chrome Trace Event JSON，可直接用chrome://tracing或ui.perfetto.dev打开）
+ * 1. 关闭时每个追踪点只有一次分支：POOL_TRACE_XXX宏先读一个全局原子标志，参数不求值、不取时间。
+ * 2. 每个产生事件的线程一块固定大小的缓冲区（第一次记录时创建），只追加不回绕：
+ *    写入方只有该线程自己，写完元素后release发布计数，导出时acquire读到的前缀都是完整的，无锁。
+ *    写满后丢弃并计数，内存有上限：每线程BUFFER_CAPACITY个事件。
+ * 3. 时间戳用steady clock，导出时换算成相对start()的微秒。
+ * 4. 每块缓冲区就是一条轨道(tid)，轨道名取线程启动时setCurrentThreadName()设置的名字，
+ *    这样管理者线程的扩缩容和每个工作线程的任务执行各自显示为一条轨道。
+ * 事件名、参数名必须是字符串字面量（导出时才读取）。等锁事件lock_wait由POOL_MUTEX_LOCKER记录（见lockprofiler.h）。
+ */
+
+struct TraceArg
+{
+    const char* name = nullptr;
+    qint64 value = 0;
+};
+
+struct TraceEvent
+{
+    qint64 timestampNs = 0;
+    qint64 durationNs = 0;      // 只用于Complete
+    const char* name = nullptr;
+    char phase = 'i';           // B/E=开始/结束 i=瞬时 X=带时长 C=计数器
+    TraceArg args[2];
+};
+
+class PoolTracer
+{
+public:
+    static const int BUFFER_CAPACITY = 16384;   // 每线程事件数上限
+
+    static PoolTracer& instance();
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static qint64 nowNs();
+    // 设置当前线程的轨道名，在线程启动时调用（追踪未开启时也可以调用）
+    static void setCurrentThreadName(const QString& name);
+
+    // 清空之前的数据并开始记录 / 停止记录（数据保留到下一次start()）
+    void start();
+    void stop();
+    // 导出为Chrome Trace Event JSON，记录中途也可以导出
+    bool exportChromeJson(const QString& path) const;
+    // 因缓冲区满丢弃的事件数
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // 由POOL_TRACE_XXX宏调用，调用前已判断enabled()
+    void record(char phase, const char* name, TraceArg a = TraceArg(), TraceArg b = TraceArg());
+    void complete(const char* name, qint64 startNs, qint64 durationNs, TraceArg a = TraceArg());
+
+private:
+    PoolTracer() = default;
+
+    // 一个线程的事件缓冲区（一条轨道）
+    struct Buffer
+    {
+        Buffer(int track, const QString& name, quint64 generation);
+        std::unique_ptr<TraceEvent[]> events;
+        std::atomic<int> count{0};
+        const int track;
+        const QString name;
+        const quint64 generation;
+    };
+    Buffer* currentBuffer();
+    void append(const TraceEvent& event);
+
+    static std::atomic<bool> s_enabled;
+
+    mutable QMutex m_mutex;                 // 保护缓冲区列表（只在线程第一次记录、start、导出时加锁）
+    QList<std::shared_ptr<Buffer>> m_buffers;
+    std::atomic<quint64> m_generation{0};   // 每次start()+1，旧缓冲区作废
+    qint64 m_startNs = 0;
+    std::atomic<quint64> m_dropped{0};
+};
+
+// 关闭时只有一次分支，参数不求值
+#define POOL_TRACE_EVENT(phase, name, ...) \
+    do { if (Q_UNLIKELY(PoolTracer::enabled())) PoolTracer::instance().record(phase, name, ##__VA_ARGS__); } while (0)
+#define POOL_TRACE_BEGIN(name, ...)   POOL_TRACE_EVENT('B', name, ##__VA_ARGS__)
+#define POOL_TRACE_END(name, ...)     POOL_TRACE_EVENT('E', name, ##__VA_ARGS__)
+#define POOL_TRACE_INSTANT(name, ...) POOL_TRACE_EVENT('i', name, ##__VA_ARGS__)
+#define POOL_TRACE_COUNTER(name, ...) POOL_TRACE_EVENT('C', name, ##__VA_ARGS__)
+
+#endif // POOLTRACE_H
@@ -4,148 +4,402 @@
 #include <QBrush>
 #include <QScrollBar>
 #include <QTime>
+#include <QElapsedTimer>
+#include <QPainterPath>
+#include <QPainter>
+#include <QImage>
+#include <QWheelEvent>
+#include <QVector>
+#include <cmath>
+
 namespace {
-    // 通用网格节点绘制
-    void drawGrid(
-        QGraphicsScene* scene,
-        int itemCount,
-        int itemWidth,
-        int itemHeight,
-        int spacing,
-        int rowSpacing,
-        int topSpacing,
-        int baseY,
-        std::function<void(int x, int y, int col, int idx)> drawNode
-    ) {
-        int viewWidth = scene->views().isEmpty() ? 800 : scene->views().first()->viewport()->width();
-        int maxPerRow = (viewWidth + spacing) / (itemWidth + spacing);
-        if (maxPerRow < 1) maxPerRow = 1;
-        int leftMargin = (viewWidth - maxPerRow * itemWidth - (maxPerRow - 1) * spacing) / 2;
-        if (leftMargin < 0) leftMargin = 0;
-
-        for (int i = 0; i < itemCount; ++i) {
-            int col = i % maxPerRow;
-            int x = leftMargin + col * (itemWidth + spacing);
-            int row = i / maxPerRow;
-            int y = baseY + topSpacing + row * (itemHeight + rowSpacing);
-            drawNode(x, y, col, i);
-        }
+    // 各分区的节点尺寸和间距
+    struct GridStyle
+    {
+        int itemWidth;
+        int itemHeight;
+        int spacing;
+        int rowSpacing;
+        int topSpacing;
+    };
+    const GridStyle WAITING_STYLE  = {45, 30, 15, 5, 5};
+    const GridStyle THREAD_STYLE   = {40, 40, 10, 10, 0};
+    const GridStyle FINISHED_STYLE = {45, 30, 8, 8, 5};
+    const int TASK_RADIUS = 10;
+    const int ARROW_SIZE = 5;
+    const double FRAME_STATS_ALPHA = 0.1;   // 帧耗时滑动平均系数
+    const double ZOOM_STEP = 1.25;          // 每格滚轮的缩放倍数
+
+    // 聚合显示的尺寸（屏幕像素，不随缩放变化）
+    const int AGGREGATE_MARGIN_PX = 10;
+    const int AGGREGATE_TITLE_PX = 18;
+    const int HEATMAP_CELL_PX = 8;          // 热力图中每个线程占的像素
+    const int BARS_HEIGHT_PX = 100;
+    const int BAR_MAX_WIDTH_PX = 60;
+
+    // 按耗时分桶的上界（毫秒），最后一个桶是">=最后上界"
+    const int DURATION_BUCKETS_MS[] = {250, 500, 1000, 2000, 4000, 8000};
+
+    int rowCountOf(int itemCount, int maxPerRow)
+    {
+        return (itemCount + maxPerRow - 1) / maxPerRow;
+    }
+
+    // 分区内第idx个节点的左上角坐标（相对分区容器）
+    QPointF gridPos(int idx, int maxPerRow, int leftMargin, const GridStyle& style)
+    {
+        int col = idx % maxPerRow;
+        int row = idx / maxPerRow;
+        return QPointF(leftMargin + col * (style.itemWidth + style.spacing),
+                       style.topSpacing + row * (style.itemHeight + style.rowSpacing));
+    }
+
+    // 把文字居中到父节点
+    void centerLabel(QGraphicsSimpleTextItem* label, int w, int h)
+    {
+        QRectF r = label->boundingRect();
+        label->setPos((w - r.width()) / 2, (h - r.height()) / 2);
+    }
+
+    QGraphicsRectItem* createLayer(QGraphicsScene* scene)
+    {
+        auto* layer = new QGraphicsRectItem();
+        layer->setPen(Qt::NoPen);
+        layer->setFlag(QGraphicsItem::ItemHasNoContents);
+        scene->addItem(layer);
+        return layer;
     }
 }
 
+/*
+聚合显示用的两个图元：
+- 都设置ItemIgnoresTransformations，尺寸按屏幕像素计算，缩得再小也看得清
+- 一个图元画完整个分区，数据变化时只update()，不增减图元
+*/
+class PoolHeatmapItem : public QGraphicsItem
+{
+public:
+    explicit PoolHeatmapItem(QGraphicsItem* parent) : QGraphicsItem(parent)
+    {
+        setFlag(QGraphicsItem::ItemIgnoresTransformations);
+    }
+
+    // image的每个像素对应一个线程，绘制时按HEATMAP_CELL_PX放大
+    void setHeatmap(const QString& title, const QImage& image)
+    {
+        if (image.size() != m_image.size()) prepareGeometryChange();
+        m_title = title;
+        m_image = image;
+        update();
+    }
+
+    QRectF boundingRect() const override
+    {
+        return QRectF(0, 0, m_image.width() * HEATMAP_CELL_PX,
+                      AGGREGATE_TITLE_PX + m_image.height() * HEATMAP_CELL_PX);
+    }
+
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) override
+    {
+        painter->setPen(Qt::black);
+        painter->drawText(QRectF(0, 0, boundingRect().width(), AGGREGATE_TITLE_PX),
+                          Qt::AlignLeft | Qt::AlignVCenter, m_title);
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+        painter->drawImage(QRectF(0, AGGREGATE_TITLE_PX, m_image.width() * HEATMAP_CELL_PX,
+                                  m_image.height() * HEATMAP_CELL_PX), m_image);
+    }
+
+private:
+    QString m_title;
+    QImage m_image;
+};
+
+class PoolBarsItem : public QGraphicsItem
+{
+public:
+    struct Bar
+    {
+        QString label;
+        int count = 0;
+    };
+
+    explicit PoolBarsItem(QGraphicsItem* parent) : QGraphicsItem(parent)
+    {
+        setFlag(QGraphicsItem::ItemIgnoresTransformations);
+    }
+
+    void setBars(const QString& title, const QVector<Bar>& bars, const QColor& color, int width)
+    {
+        if (width != m_width) prepareGeometryChange();
+        m_title = title;
+        m_bars = bars;
+        m_color = color;
+        m_width = width;
+        update();
+    }
+
+    QRectF boundingRect() const override { return QRectF(0, 0, m_width, BARS_HEIGHT_PX); }
+
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*) override
+    {
+        painter->setPen(Qt::black);
+        painter->drawText(QRectF(0, 0, m_width, AGGREGATE_TITLE_PX),
+                          Qt::AlignLeft | Qt::AlignVCenter, m_title);
+        if (m_bars.isEmpty()) return;
+
+        int maxCount = 1;
+        for (const auto& bar : m_bars) maxCount = qMax(maxCount, bar.count);
+        // 柱子区域：上面留一行写数量，下面留一行写分桶名
+        const double top = AGGREGATE_TITLE_PX * 2;
+        const double bottom = BARS_HEIGHT_PX - AGGREGATE_TITLE_PX;
+        const double slot = qMin<double>(BAR_MAX_WIDTH_PX, m_width / (double)m_bars.size());
+        for (int i = 0; i < m_bars.size(); ++i) {
+            const auto& bar = m_bars[i];
+            double x = i * slot;
+            double h = (bottom - top) * bar.count / maxCount;
+            painter->setPen(m_color.darker(130));
+            painter->setBrush(m_color);
+            painter->drawRect(QRectF(x + 2, bottom - h, slot - 4, h));
+            painter->setPen(Qt::black);
+            painter->drawText(QRectF(x, bottom - h - AGGREGATE_TITLE_PX, slot, AGGREGATE_TITLE_PX),
+                              Qt::AlignCenter, QString::number(bar.count));
+            painter->drawText(QRectF(x, bottom, slot, AGGREGATE_TITLE_PX),
+                              Qt::AlignCenter, bar.label);
+        }
+    }
+
+private:
+    QString m_title;
+    QVector<Bar> m_bars;
+    QColor m_color;
+    int m_width = 0;
+};
+
 PoolView::PoolView(QWidget* parent) : QGraphicsView(parent) {
     m_scene = new QGraphicsScene(this); // 设置场景, 场景是绘图的容器, 会自动析构
+    // 图元位置频繁变化，不维护BSP索引
+    m_scene->setItemIndexMethod(QGraphicsScene::NoIndex);
     setScene(m_scene);
     setRenderHint(QPainter::Antialiasing);
     setAlignment(Qt::AlignTop | Qt::AlignLeft); // 左上角对齐
+    resetItems();
 }
 
 PoolView::~PoolView() {}
 
 /*
-布局：让每个 drawXxx 函数都接收一个起始 y 坐标，绘制完后返回“下一个可用的 y 坐标”。
-这样每一栏都能自适应高度，互不重叠。
+布局：让每个 updateXxx 函数都接收一个起始 y 坐标，更新完后返回“下一个可用的 y 坐标”。
+这样每一栏都能自适应高度，互不重叠；分区整体移动时只移动分区容器。
  */
 
 
 void PoolView::visualizeAll(const QList<ThreadVisualInfo>& threadInfos,
                             const QList<TaskVisualInfo>& waitingTasks,
                             const QList<TaskVisualInfo>& finishedTasks) {
+    QElapsedTimer timer;
+    timer.start();
+    m_updating = true;
+
     m_lastThreadInfos = threadInfos;
-    m_lastWaitingTasks = waitingTasks;
-    m_lastFinishedTasks = finishedTasks;
-    scene()->clear();
+    m_lastWaitingTasks = &waitingTasks;
+    m_lastFinishedTasks = &finishedTasks;
+    m_generation++;
+
+    // 细节层次：缩小到一定比例后改为聚合显示
+    bool aggregate = m_scale < AGGREGATE_SCALE;
+    if (aggregate != m_aggregate) {
+        if (aggregate) removeDetailItems();
+        else removeAggregateItems();
+        m_aggregate = aggregate;
+        m_layoutChanged = true;
+    }
+    if (m_layoutWidth != int(viewport()->width() / m_scale)) {
+        updateLayoutMetrics();
+    }
 
     int baseY = 0;
-    baseY = drawWaitingTasks(waitingTasks, baseY);
+    if (m_aggregate) {
+        bool byPriority = m_currentPolicy == SchedulePolicy::PRIO;
+        baseY = updateTaskBars(m_waitingBars, m_waitingLayer, QString("等待任务 %1").arg(waitingTasks.size()),
+                               waitingTasks, byPriority, QColor(220, 60, 60), baseY);
+        baseY = updateThreadHeatmap(threadInfos, baseY);
+        baseY = updateTaskBars(m_finishedBars, m_finishedLayer, QString("已完成任务 %1").arg(finishedTasks.size()),
+                               finishedTasks, false, QColor(60, 180, 60), baseY);
+    } else {
+        baseY = updateWaitingTasks(waitingTasks, baseY);
+
+        baseY = updateThreads(threadInfos, baseY);
+
+        baseY = updateFinishedTasks(finishedTasks, baseY);
+    }
 
-    baseY = drawThreads(threadInfos, baseY);
+    scene()->setSceneRect(0, 0, m_layoutWidth, baseY);
+    m_layoutChanged = false;
+    m_updating = false;
 
-    baseY = drawFinishedTasks(finishedTasks, baseY);
+    // 帧耗时统计
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+    m_frameStats.frames++;
+    m_frameStats.aggregate = m_aggregate;
+    m_frameStats.lastUpdateMs = elapsedMs;
+    m_frameStats.avgUpdateMs = m_frameStats.frames == 1
+        ? elapsedMs
+        : m_frameStats.avgUpdateMs + FRAME_STATS_ALPHA * (elapsedMs - m_frameStats.avgUpdateMs);
+    m_frameStats.maxUpdateMs = qMax(m_frameStats.maxUpdateMs, elapsedMs);
+}
 
-    scene()->setSceneRect(0, 0, viewport()->width(), baseY);
+void PoolView::updateLayoutMetrics()
+{
+    // 布局宽度按场景坐标计算：缩小视图时一行能放下更多图元
+    int viewWidth = int(viewport()->width() / m_scale);
+    auto metricsOf = [viewWidth](const GridStyle& style) {
+        GridMetrics metrics;
+        metrics.maxPerRow = (viewWidth + style.spacing) / (style.itemWidth + style.spacing);
+        if (metrics.maxPerRow < 1) metrics.maxPerRow = 1;
+        metrics.leftMargin = (viewWidth - metrics.maxPerRow * style.itemWidth - (metrics.maxPerRow - 1) * style.spacing) / 2;
+        if (metrics.leftMargin < 0) metrics.leftMargin = 0;
+        return metrics;
+    };
+    m_waitingGrid = metricsOf(WAITING_STYLE);
+    m_threadGrid = metricsOf(THREAD_STYLE);
+    m_finishedGrid = metricsOf(FINISHED_STYLE);
+    m_layoutWidth = viewWidth;
+    m_layoutChanged = true;
+}
 
+/*
+视口裁剪：
+- 分区从baseY开始按行排列，用视口对应的场景矩形算出可见的行，上下各多留一行
+- 只有可见范围内的下标会创建图元，其余的在generation检查中被删除
+*/
+PoolView::VisibleRange PoolView::visibleRange(int baseY, int itemHeight, int rowSpacing, int topSpacing,
+                                              const GridMetrics& metrics, int count) const
+{
+    VisibleRange range;
+    if (count == 0) return range;
+    QRectF visible = mapToScene(viewport()->rect()).boundingRect();
+    double rowPitch = itemHeight + rowSpacing;
+    int rowCount = rowCountOf(count, metrics.maxPerRow);
+    int firstRow = int(std::floor((visible.top() - baseY - topSpacing) / rowPitch)) - 1;
+    int lastRow = int(std::floor((visible.bottom() - baseY - topSpacing) / rowPitch)) + 1;
+    firstRow = qBound(0, firstRow, rowCount);
+    lastRow = qBound(-1, lastRow, rowCount - 1);
+    if (firstRow > lastRow) return range;
+    range.first = firstRow * metrics.maxPerRow;
+    range.last = qMin(count, (lastRow + 1) * metrics.maxPerRow);
+    return range;
 }
 
 /*
 第一栏 waitingTaskQueue区域：
 - 圆角矩形
 - 颜色: 红色边，淡红底
-- 按照队列的实际情况用箭头连接
+- 按照队列的实际情况用箭头连接（连线和箭头挂在后一个任务上，行首任务隐藏）
 - 任务ID: 显示在圆角矩形上
  */
-int PoolView::drawWaitingTasks(const QList<TaskVisualInfo>& waitingTasks, int baseY) {
-    const int w = 45, h = 30, spacing = 15, rowSpacing = 5, topSpacing = 5, radius = 10;
-    auto scenePtr = scene();
-    drawGrid(scenePtr, waitingTasks.size(), w, h, spacing, rowSpacing, topSpacing, baseY,
-        [&](int x, int y, int col, int idx) {
-            QPainterPath path;
-            path.addRoundedRect(x, y, w, h, radius, radius);
-            // 画圆角矩形，红色边，淡红底
-            scenePtr->addPath(path, QPen(QColor(220, 60, 60), 2), QBrush(QColor(255, 220, 220)));
-            // auto* text = scenePtr->addSimpleText(QString::number(waitingTasks[idx].taskId));
-            // 显示任务ID和总耗时s
-            int totalTimeMs = waitingTasks[idx].totalTimeMs;
-            double seconds = totalTimeMs / 1000.0;
-            QString label;
-            switch (m_currentPolicy) {
-                case SchedulePolicy::FIFO:
-                case SchedulePolicy::LIFO:
-                    label = QString::number(waitingTasks[idx].taskId);
-                    break;
-                case SchedulePolicy::SJF:
-                case SchedulePolicy::LJF:
-                    label = QString("%1(%2s)").arg(waitingTasks[idx].taskId).arg(seconds, 0, 'f', 1);
-                    break;
-                case SchedulePolicy::PRIO:
-                    label = QString("%1(★%2)").arg(waitingTasks[idx].taskId).arg(waitingTasks[idx].priority);
-                    break;
-                case SchedulePolicy::HRRN: {
-                    // 计算响应比
-                    int currentTime = QTime::currentTime().msecsSinceStartOfDay();
-                    int waitTime = currentTime - waitingTasks[idx].arrivalTimestampMs;
-                    double responseRatio = (waitTime + waitingTasks[idx].totalTimeMs) / (double)waitingTasks[idx].totalTimeMs;
-
-                    label = QString("%1(hr%2)").arg(waitingTasks[idx].taskId).arg(responseRatio, 0, 'f', 1);
-                    break;
-                }
-                default:
-                    label = QString::number(waitingTasks[idx].taskId);
-            }
-            auto* text = scenePtr->addSimpleText(label);
+PoolView::WaitingItem PoolView::createWaitingItem()
+{
+    const GridStyle& style = WAITING_STYLE;
+    const int w = style.itemWidth, h = style.itemHeight;
+    WaitingItem item;
+
+    QPainterPath path;
+    path.addRoundedRect(0, 0, w, h, TASK_RADIUS, TASK_RADIUS);
+    item.box = new QGraphicsPathItem(path, m_waitingLayer);
+    item.box->setPen(QPen(QColor(220, 60, 60), 2));
+    item.box->setBrush(QBrush(QColor(255, 220, 220)));
+
+    item.label = new QGraphicsSimpleTextItem(item.box);
+    item.label->setBrush(Qt::black);
+
+    // 与前一个任务之间的连线：前一个的右中点 -> 当前的左中点
+    QPointF prevCenterRight(-style.spacing, h / 2);
+    QPointF curCenterLeft(0, h / 2);
+    item.link = new QGraphicsLineItem(QLineF(prevCenterRight, curCenterLeft), item.box);
+    item.link->setPen(QPen(Qt::gray, 2));
+    QPolygonF arrowHead;
+    arrowHead << curCenterLeft
+              << (curCenterLeft + QPointF(-ARROW_SIZE, ARROW_SIZE / 2))
+              << (curCenterLeft + QPointF(-ARROW_SIZE, -(ARROW_SIZE / 2)));
+    item.arrow = new QGraphicsPolygonItem(arrowHead, item.box);
+    item.arrow->setPen(QPen(Qt::gray));
+    item.arrow->setBrush(QBrush(Qt::gray));
 
-            text->setBrush(Qt::black);
-            QRectF r = text->boundingRect();
-            text->setPos(x + (w - r.width()) / 2, y + (h - r.height()) / 2);
+    m_frameStats.itemsCreated += 4;
+    m_frameStats.liveItems += 4;
+    return item;
+}
+
+QString PoolView::waitingLabel(const TaskVisualInfo& task, int currentTime) const
+{
+    double seconds = task.totalTimeMs / 1000.0;
+    switch (m_currentPolicy) {
+        case SchedulePolicy::FIFO:
+        case SchedulePolicy::LIFO:
+            return QString::number(task.taskId);
+        case SchedulePolicy::SJF:
+        case SchedulePolicy::LJF:
+            return QString("%1(%2s)").arg(task.taskId).arg(seconds, 0, 'f', 1);
+        case SchedulePolicy::PRIO:
+            return QString("%1(★%2)").arg(task.taskId).arg(task.priority);
+        case SchedulePolicy::HRRN: {
+            // 计算响应比
+            int waitTime = currentTime - task.arrivalTimestampMs;
+            double responseRatio = (waitTime + task.totalTimeMs) / (double)task.totalTimeMs;
+            return QString("%1(hr%2)").arg(task.taskId).arg(responseRatio, 0, 'f', 1);
+        }
+        default:
+            return QString::number(task.taskId);
+    }
+}
+
+int PoolView::updateWaitingTasks(const QList<TaskVisualInfo>& waitingTasks, int baseY) {
+    const GridStyle& style = WAITING_STYLE;
+    m_waitingLayer->setPos(0, baseY);
+    int currentTime = QTime::currentTime().msecsSinceStartOfDay();
+
+    VisibleRange range = visibleRange(baseY, style.itemHeight, style.rowSpacing, style.topSpacing,
+                                      m_waitingGrid, waitingTasks.size());
+    for (int idx = range.first; idx < range.last; ++idx) {
+        const auto& task = waitingTasks[idx];
+        auto it = m_waitingItems.find(task.taskId);
+        if (it == m_waitingItems.end()) {
+            it = m_waitingItems.insert(task.taskId, createWaitingItem());
+        }
+        WaitingItem& item = it.value();
+        item.generation = m_generation;
 
+        // 只在队列位置或布局变化时移动
+        if (item.index != idx || m_layoutChanged) {
+            item.index = idx;
+            item.box->setPos(gridPos(idx, m_waitingGrid.maxPerRow, m_waitingGrid.leftMargin, style));
             // 只在同一行画连线和箭头
-            if (col > 0) {
-                int prevX = x - (w + spacing);
-                int prevY = y;
-                QPointF prevCenterRight(prevX + w, prevY + h / 2);
-                QPointF curCenterLeft(x, y + h / 2);
-                scenePtr->addLine(QLineF(prevCenterRight, curCenterLeft), QPen(Qt::gray, 2));
-                // 箭头
-                int arrowSize = 5;
-                QPointF dir = curCenterLeft - prevCenterRight;
-                double len = std::hypot(dir.x(), dir.y());
-                if (len > 0) {
-                    dir /= len;
-                    QPointF ortho(-dir.y(), dir.x());
-                    QPolygonF arrowHead;
-                    arrowHead << curCenterLeft
-                              << (curCenterLeft - dir * arrowSize + ortho * (arrowSize / 2))
-                              << (curCenterLeft - dir * arrowSize - ortho * (arrowSize / 2));
-                    scenePtr->addPolygon(arrowHead, QPen(Qt::gray), QBrush(Qt::gray));
-                }
-            }
+            bool hasPrev = idx % m_waitingGrid.maxPerRow > 0;
+            item.link->setVisible(hasPrev);
+            item.arrow->setVisible(hasPrev);
+        }
+        // 文字有变化才更新（HRRN的响应比随时间变化）
+        QString label = waitingLabel(task, currentTime);
+        if (item.label->text() != label) {
+            item.label->setText(label);
+            centerLabel(item.label, style.itemWidth, style.itemHeight);
+        }
+    }
+
+    // 删除已经离开队列或滚出视口的任务
+    for (auto it = m_waitingItems.begin(); it != m_waitingItems.end(); ) {
+        if (it.value().generation != m_generation) {
+            delete it.value().box;  // 子图元随父图元一起删除
+            m_frameStats.itemsRemoved += 4;
+            m_frameStats.liveItems -= 4;
+            it = m_waitingItems.erase(it);
+        } else {
+            ++it;
         }
-    );
-    int viewWidth = scenePtr->views().isEmpty() ? 800 : scenePtr->views().first()->viewport()->width();
-    int maxPerRow = (viewWidth + spacing) / (w + spacing);
-    if (maxPerRow < 1) maxPerRow = 1;
-    int rowCount = (waitingTasks.size() + maxPerRow - 1) / maxPerRow;
-    return baseY + rowCount * (h + rowSpacing) + topSpacing;
+    }
+
+    int rowCount = rowCountOf(waitingTasks.size(), m_waitingGrid.maxPerRow);
+    return baseY + rowCount * (style.itemHeight + style.rowSpacing) + style.topSpacing;
 }
 /*
 第二栏 poolView区域：
@@ -159,111 +413,360 @@ int PoolView::drawWaitingTasks(const QList<TaskVisualInfo>& waitingTasks, int ba
     6. 空闲线程：矩形全绿。
 
 */
-int PoolView::drawThreads(const QList<ThreadVisualInfo>& threadInfos, int baseY) {
-    const int w = 40, h = 40, spacing = 10, rowSpacing = 10, topSpacing = 0;
-    auto scenePtr = scene();
+PoolView::ThreadItem PoolView::createThreadItem()
+{
+    const int w = THREAD_STYLE.itemWidth, h = THREAD_STYLE.itemHeight;
+    ThreadItem item;
+    item.frame = new QGraphicsRectItem(0, 0, w, h, m_threadLayer);
+    item.frame->setPen(QPen(Qt::white, 2));
+    // 进度条两段画在边框下面
+    item.done = new QGraphicsRectItem(0, 0, 0, h, item.frame);
+    item.done->setPen(Qt::NoPen);
+    item.done->setBrush(QBrush(Qt::green));
+    item.done->setFlag(QGraphicsItem::ItemStacksBehindParent);
+    item.todo = new QGraphicsRectItem(0, 0, w, h, item.frame);
+    item.todo->setPen(Qt::NoPen);
+    item.todo->setBrush(QBrush(Qt::red));
+    item.todo->setFlag(QGraphicsItem::ItemStacksBehindParent);
+    item.label = new QGraphicsSimpleTextItem(item.frame);
+    item.label->setBrush(Qt::black);
+
+    m_frameStats.itemsCreated += 4;
+    m_frameStats.liveItems += 4;
+    return item;
+}
+
+int PoolView::updateThreads(const QList<ThreadVisualInfo>& threadInfos, int baseY) {
+    const GridStyle& style = THREAD_STYLE;
+    const int w = style.itemWidth, h = style.itemHeight;
+    m_threadLayer->setPos(0, baseY);
 
-    drawGrid(scenePtr, threadInfos.size(), w, h, spacing, rowSpacing, topSpacing, baseY,
-        [&](int x, int y, int /*col*/, int idx) {
-            const auto& info = threadInfos[idx];
-            if (info.state == THREAD_EXIT) return;
+    QColor idleColor = Qt::green;
 
-            QColor idleColor = Qt::green;
-            QColor busyDoneColor = Qt::green;
-            QColor busyTodoColor = Qt::red;
+    VisibleRange range = visibleRange(baseY, h, style.rowSpacing, style.topSpacing,
+                                      m_threadGrid, threadInfos.size());
+    for (int idx = range.first; idx < range.last; ++idx) {
+        const auto& info = threadInfos[idx];
+        auto it = m_threadItems.find(info.threadId);
+        if (it == m_threadItems.end()) {
+            it = m_threadItems.insert(info.threadId, createThreadItem());
+        }
+        ThreadItem& item = it.value();
+        item.generation = m_generation;
+
+        if (item.index != idx || m_layoutChanged) {
+            item.index = idx;
+            item.frame->setPos(gridPos(idx, m_threadGrid.maxPerRow, m_threadGrid.leftMargin, style));
+        }
 
+        bool busy = info.state == THREAD_BUSY && info.curTaskId != -1;
+        int doneWidth = 0;
+        if (busy) {
+            // 用map获取totalTimeMs, 用于绘制进度条
+            int totalTimeMs = m_taskIdToTotalTimeMs.value(info.curTaskId);
+            double percent = totalTimeMs > 0 ? qBound(0.0, double(info.curTimeMs) / totalTimeMs, 1.0) : 0.0;
+            doneWidth = int(w * percent);
+        }
+
+        // 状态或当前任务变化：重新设置颜色和文字
+        if (item.state != info.state || item.curTaskId != info.curTaskId) {
+            item.state = info.state;
+            item.curTaskId = info.curTaskId;
+            item.frame->setVisible(info.state != THREAD_EXIT);
             if (info.state == THREAD_IDLE) {
                 // 空闲线程，全部绿色
-                scenePtr->addRect(x, y, w, h, QPen(Qt::white, 2), QBrush(idleColor));
-            } else if (info.state == THREAD_BUSY && info.curTaskId != -1) {
-                // 用map获取totalTimeMs, 用于绘制进度条
-                int totalTimeMs = m_taskIdToTotalTimeMs.value(info.curTaskId);
-                // 忙碌线程，左侧绿色（已完成），右侧红色（未完成）
-                double percent = qBound(0.0, double(info.curTimeMs) / totalTimeMs, 1.0);
-                int doneWidth = int(w * percent);
-                int todoWidth = w - doneWidth;
-                // 先画已完成部分（绿色）
-                if (doneWidth > 0) {
-                    scenePtr->addRect(x, y, doneWidth, h, QPen(Qt::NoPen), QBrush(busyDoneColor));
-                }
-                // 再画未完成部分（红色）
-                if (todoWidth > 0) {
-                    scenePtr->addRect(x + doneWidth, y, todoWidth, h, QPen(Qt::NoPen), QBrush(busyTodoColor));
-                }
-                // 画边框
-                scenePtr->addRect(x, y, w, h, QPen(Qt::white, 2));
+                item.frame->setBrush(QBrush(idleColor));
+            } else if (busy) {
+                // 忙碌线程，左侧绿色（已完成），右侧红色（未完成），由两段子矩形绘制
+                item.frame->setBrush(Qt::NoBrush);
             } else {
                 // 其他情况（如异常），用灰色
-                scenePtr->addRect(x, y, w, h, QPen(Qt::white, 2), QBrush(Qt::gray));
+                item.frame->setBrush(QBrush(Qt::gray));
             }
+            item.done->setVisible(busy);
+            item.todo->setVisible(busy);
+            item.doneWidth = -1;
 
-            // 画文字
             QString label = QString("T%1").arg(info.threadId);
-            if (info.state == THREAD_BUSY && info.curTaskId != -1)
+            if (busy)
                 label += QString(" #%1").arg(info.curTaskId);
-            auto* text = scenePtr->addSimpleText(label);
-            text->setBrush(Qt::black);
-            QRectF r = text->boundingRect();
-            text->setPos(x + (w - r.width()) / 2, y + (h - r.height()) / 2);
+            item.label->setText(label);
+            centerLabel(item.label, w, h);
         }
-    );
-    int viewWidth = scenePtr->views().isEmpty() ? 800 : scenePtr->views().first()->viewport()->width();
-    int maxPerRow = (viewWidth + spacing) / (w + spacing);
-    if (maxPerRow < 1) maxPerRow = 1;
-    int rowCount = (threadInfos.size() + maxPerRow - 1) / maxPerRow;
-    return baseY + rowCount * (h + rowSpacing) + topSpacing;
+        // 进度变化：只改两段矩形的宽度
+        if (busy && item.doneWidth != doneWidth) {
+            item.doneWidth = doneWidth;
+            item.done->setRect(0, 0, doneWidth, h);
+            item.todo->setRect(doneWidth, 0, w - doneWidth, h);
+        }
+    }
+
+    // 删除已退出或滚出视口的线程
+    for (auto it = m_threadItems.begin(); it != m_threadItems.end(); ) {
+        if (it.value().generation != m_generation) {
+            delete it.value().frame;
+            m_frameStats.itemsRemoved += 4;
+            m_frameStats.liveItems -= 4;
+            it = m_threadItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    int rowCount = rowCountOf(threadInfos.size(), m_threadGrid.maxPerRow);
+    return baseY + rowCount * (h + style.rowSpacing) + style.topSpacing;
 }
 
 
-/*    
+/*
 第三栏 finishedTaskList区域：
 - 圆角矩形
 - 颜色: 绿色边，淡绿底
 - 任务ID: 显示在圆角矩形上
+- 按完成顺序索引，只为可见范围创建图元
 */
-int PoolView::drawFinishedTasks(const QList<TaskVisualInfo>& finishedTasks, int baseY) {
-    const int w = 45, h = 30, spacing = 8, rowSpacing = 8, topSpacing = 5, radius = 10;
-    auto scenePtr = scene();
-
-    drawGrid(scenePtr, finishedTasks.size(), w, h, spacing, rowSpacing, topSpacing, baseY,
-        [&](int x, int y, int /*col*/, int idx) {
-            QPainterPath path;
-            path.addRoundedRect(x, y, w, h, radius, radius);
-            // 画圆角矩形，绿色边，淡绿底
-            scenePtr->addPath(path, QPen(QColor(60, 180, 60), 2), QBrush(QColor(220, 255, 220)));
-            QString label = QString("%1 T:%2").arg(finishedTasks[idx].taskId).arg(finishedTasks[idx].curThreadId);
-            auto* text = scenePtr->addSimpleText(label);
-            text->setBrush(Qt::black);
-            QRectF r = text->boundingRect();
-            text->setPos(x + (w - r.width()) / 2, y + (h - r.height()) / 2);
+PoolView::FinishedItem PoolView::createFinishedItem()
+{
+    const int w = FINISHED_STYLE.itemWidth, h = FINISHED_STYLE.itemHeight;
+    FinishedItem item;
+    QPainterPath path;
+    path.addRoundedRect(0, 0, w, h, TASK_RADIUS, TASK_RADIUS);
+    item.box = new QGraphicsPathItem(path, m_finishedLayer);
+    item.box->setPen(QPen(QColor(60, 180, 60), 2));
+    item.box->setBrush(QBrush(QColor(220, 255, 220)));
+    item.label = new QGraphicsSimpleTextItem(item.box);
+    item.label->setBrush(Qt::black);
+
+    m_frameStats.itemsCreated += 2;
+    m_frameStats.liveItems += 2;
+    return item;
+}
+
+int PoolView::updateFinishedTasks(const QList<TaskVisualInfo>& finishedTasks, int baseY) {
+    const GridStyle& style = FINISHED_STYLE;
+    m_finishedLayer->setPos(0, baseY);
+
+    VisibleRange range = visibleRange(baseY, style.itemHeight, style.rowSpacing, style.topSpacing,
+                                      m_finishedGrid, finishedTasks.size());
+    for (int idx = range.first; idx < range.last; ++idx) {
+        const auto& task = finishedTasks[idx];
+        auto it = m_finishedItems.find(idx);
+        bool created = it == m_finishedItems.end();
+        if (created) {
+            it = m_finishedItems.insert(idx, createFinishedItem());
+        }
+        FinishedItem& item = it.value();
+        item.generation = m_generation;
+        if (created || m_layoutChanged) {
+            item.box->setPos(gridPos(idx, m_finishedGrid.maxPerRow, m_finishedGrid.leftMargin, style));
+        }
+        // 线程池重启后同一位置可能是另一个任务
+        if (item.taskId != task.taskId) {
+            item.taskId = task.taskId;
+            item.label->setText(QString("%1 T:%2").arg(task.taskId).arg(task.curThreadId));
+            centerLabel(item.label, style.itemWidth, style.itemHeight);
+        }
+    }
+
+    for (auto it = m_finishedItems.begin(); it != m_finishedItems.end(); ) {
+        if (it.value().generation != m_generation) {
+            delete it.value().box;
+            m_frameStats.itemsRemoved += 2;
+            m_frameStats.liveItems -= 2;
+            it = m_finishedItems.erase(it);
+        } else {
+            ++it;
         }
-    );
-    int viewWidth = scenePtr->views().isEmpty() ? 800 : scenePtr->views().first()->viewport()->width();
-    int maxPerRow = (viewWidth + spacing) / (w + spacing);
-    if (maxPerRow < 1) maxPerRow = 1;
-    int rowCount = (finishedTasks.size() + maxPerRow - 1) / maxPerRow;
-    return baseY + rowCount * (h + rowSpacing) + topSpacing;
+    }
+
+    int rowCount = rowCountOf(finishedTasks.size(), m_finishedGrid.maxPerRow);
+    return baseY + rowCount * (style.itemHeight + style.rowSpacing) + style.topSpacing;
 }
+
 /*
-    窗口大小变化时：
-    - 重新绘制线程，每行显示的矩形数量会变化。
-    - 重新绘制任务，任务的动画信息会变化。
+聚合显示 - 线程热力图：
+- 每个线程一个格子，按线程顺序从左到右、从上到下排列
+- 空闲=绿色；忙碌从红色（刚开始）渐变到黄色（快完成）；退出=透明
+*/
+int PoolView::updateThreadHeatmap(const QList<ThreadVisualInfo>& threadInfos, int baseY)
+{
+    m_threadLayer->setPos(0, baseY);
+    if (!m_threadHeatmap) {
+        m_threadHeatmap = new PoolHeatmapItem(m_threadLayer);
+        m_frameStats.itemsCreated++;
+        m_frameStats.liveItems++;
+    }
+    m_threadHeatmap->setPos(AGGREGATE_MARGIN_PX / m_scale, 0);
+
+    int cols = qMax(1, (viewport()->width() - 2 * AGGREGATE_MARGIN_PX) / HEATMAP_CELL_PX);
+    int rows = qMax(1, rowCountOf(threadInfos.size(), cols));
+    QImage image(qMin(cols, qMax(1, int(threadInfos.size()))), rows, QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+
+    int busyCount = 0, idleCount = 0;
+    for (int idx = 0; idx < threadInfos.size(); ++idx) {
+        const auto& info = threadInfos[idx];
+        QRgb color = qRgba(0, 0, 0, 0);
+        if (info.state == THREAD_IDLE) {
+            color = qRgb(60, 200, 60);
+            idleCount++;
+        } else if (info.state == THREAD_BUSY) {
+            int totalTimeMs = m_taskIdToTotalTimeMs.value(info.curTaskId);
+            double percent = totalTimeMs > 0 ? qBound(0.0, double(info.curTimeMs) / totalTimeMs, 1.0) : 0.0;
+            color = qRgb(220 + int(20 * percent), 40 + int(160 * percent), 40);
+            busyCount++;
+        }
+        reinterpret_cast<QRgb*>(image.scanLine(idx / cols))[idx % cols] = color;
+    }
+    m_threadHeatmap->setHeatmap(QString("线程 %1 (忙碌 %2, 空闲 %3)")
+                                    .arg(threadInfos.size()).arg(busyCount).arg(idleCount), image);
 
+    int heightPx = AGGREGATE_TITLE_PX + rows * HEATMAP_CELL_PX + AGGREGATE_MARGIN_PX;
+    return baseY + int(std::ceil(heightPx / m_scale));
+}
+
+/*
+聚合显示 - 任务计数柱状图：
+- PRIO策略下按优先级分桶（高优先级在左），其余按任务耗时分桶
+*/
+int PoolView::updateTaskBars(PoolBarsItem*& bars, QGraphicsRectItem* layer, const QString& title,
+                             const QList<TaskVisualInfo>& tasks, bool byPriority, const QColor& color, int baseY)
+{
+    layer->setPos(0, baseY);
+    if (!bars) {
+        bars = new PoolBarsItem(layer);
+        m_frameStats.itemsCreated++;
+        m_frameStats.liveItems++;
+    }
+    bars->setPos(AGGREGATE_MARGIN_PX / m_scale, 0);
+
+    QVector<PoolBarsItem::Bar> result;
+    if (byPriority) {
+        QMap<int, int> counts;
+        for (const auto& task : tasks) counts[task.priority]++;
+        for (auto it = counts.constEnd(); it != counts.constBegin(); ) {
+            --it;
+            result.append({QString("★%1").arg(it.key()), it.value()});
+        }
+    } else {
+        const int bucketCount = sizeof(DURATION_BUCKETS_MS) / sizeof(DURATION_BUCKETS_MS[0]);
+        QVector<int> counts(bucketCount + 1, 0);
+        for (const auto& task : tasks) {
+            int bucket = 0;
+            while (bucket < bucketCount && task.totalTimeMs >= DURATION_BUCKETS_MS[bucket]) bucket++;
+            counts[bucket]++;
+        }
+        for (int bucket = 0; bucket <= bucketCount; ++bucket) {
+            QString label = bucket < bucketCount
+                ? QString("<%1s").arg(DURATION_BUCKETS_MS[bucket] / 1000.0)
+                : QString("≥%1s").arg(DURATION_BUCKETS_MS[bucketCount - 1] / 1000.0);
+            result.append({label, counts[bucket]});
+        }
+    }
+    bars->setBars(title, result, color, viewport()->width() - 2 * AGGREGATE_MARGIN_PX);
+
+    return baseY + int(std::ceil((BARS_HEIGHT_PX + AGGREGATE_MARGIN_PX) / m_scale));
+}
+
+void PoolView::removeDetailItems()
+{
+    for (const auto& item : m_waitingItems) delete item.box;
+    for (const auto& item : m_threadItems) delete item.frame;
+    for (const auto& item : m_finishedItems) delete item.box;
+    int removed = 4 * (m_waitingItems.size() + m_threadItems.size()) + 2 * m_finishedItems.size();
+    m_frameStats.itemsRemoved += removed;
+    m_frameStats.liveItems -= removed;
+    m_waitingItems.clear();
+    m_threadItems.clear();
+    m_finishedItems.clear();
+}
+
+void PoolView::removeAggregateItems()
+{
+    for (QGraphicsItem* item : {static_cast<QGraphicsItem*>(m_threadHeatmap),
+                                static_cast<QGraphicsItem*>(m_waitingBars),
+                                static_cast<QGraphicsItem*>(m_finishedBars)}) {
+        if (!item) continue;
+        delete item;
+        m_frameStats.itemsRemoved++;
+        m_frameStats.liveItems--;
+    }
+    m_threadHeatmap = nullptr;
+    m_waitingBars = nullptr;
+    m_finishedBars = nullptr;
+}
+
+/*
+    窗口大小变化时：
+    - 重新计算每行显示的矩形数量，移动已有图元到新位置，不重建图元。
 */
 void PoolView::resizeEvent(QResizeEvent* event) {
     QGraphicsView::resizeEvent(event);
-    // 只要有快照就刷新
-    if (!m_lastThreadInfos.isEmpty() ||
-        !m_lastWaitingTasks.isEmpty() ||
-        !m_lastFinishedTasks.isEmpty()) {
-        visualizeAll(m_lastThreadInfos, m_lastWaitingTasks, m_lastFinishedTasks);
+    // 只要有快照就重新布局
+    if (m_lastWaitingTasks && m_lastFinishedTasks) {
+        visualizeAll(m_lastThreadInfos, *m_lastWaitingTasks, *m_lastFinishedTasks);
+    }
+}
+
+void PoolView::wheelEvent(QWheelEvent* event)
+{
+    if (!(event->modifiers() & Qt::ControlModifier)) {
+        QGraphicsView::wheelEvent(event);
+        return;
+    }
+    double factor = event->angleDelta().y() > 0 ? ZOOM_STEP : 1.0 / ZOOM_STEP;
+    double newScale = qBound(MIN_SCALE, m_scale * factor, MAX_SCALE);
+    if (newScale == m_scale) return;
+    double step = newScale / m_scale;
+    m_scale = newScale;     // scale()可能触发滚动，先更新比例
+    scale(step, step);
+    if (m_lastWaitingTasks && m_lastFinishedTasks) {
+        visualizeAll(m_lastThreadInfos, *m_lastWaitingTasks, *m_lastFinishedTasks);
     }
+    event->accept();
 }
 
+void PoolView::scrollContentsBy(int dx, int dy)
+{
+    QGraphicsView::scrollContentsBy(dx, dy);
+    // visualizeAll()内部调整sceneRect引起的滚动不再重入
+    if (m_updating || m_aggregate) return;
+    if (m_lastWaitingTasks && m_lastFinishedTasks) {
+        visualizeAll(m_lastThreadInfos, *m_lastWaitingTasks, *m_lastFinishedTasks);
+    }
+}
+
+void PoolView::paintEvent(QPaintEvent* event)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+    double elapsedMs = timer.nsecsElapsed() / 1e6;
+    m_frameStats.lastPaintMs = elapsedMs;
+    m_frameStats.avgPaintMs += FRAME_STATS_ALPHA * (elapsedMs - m_frameStats.avgPaintMs);
+}
+
+void PoolView::resetItems()
+{
+    // scene()->clear()会删除所有图元（包括分区容器），之后重新创建容器
+    scene()->clear();
+    m_waitingItems.clear();
+    m_threadItems.clear();
+    m_finishedItems.clear();
+    m_threadHeatmap = nullptr;
+    m_waitingBars = nullptr;
+    m_finishedBars = nullptr;
+    m_frameStats.itemsRemoved += m_frameStats.liveItems;
+    m_frameStats.liveItems = 0;
+    m_waitingLayer = createLayer(scene());
+    m_threadLayer = createLayer(scene());
+    m_finishedLayer = createLayer(scene());
+    m_layoutChanged = true;
+}
 
 void PoolView::clear() {
     m_lastThreadInfos.clear();
-    m_lastWaitingTasks.clear();
-    m_lastFinishedTasks.clear();
-    scene()->clear();
+    m_lastWaitingTasks = nullptr;
+    m_lastFinishedTasks = nullptr;
+    resetItems();
 }
@@ -3,9 +3,34 @@
 
 #include <QGraphicsView>
 #include <QGraphicsScene>
+#include <QGraphicsRectItem>
+#include <QGraphicsPathItem>
+#include <QGraphicsSimpleTextItem>
+#include <QGraphicsLineItem>
+#include <QGraphicsPolygonItem>
+#include <QHash>
+#include <QMap>
 #include "visualinfo.h"
 #include "scheduler.h"
 
+// 帧耗时统计：update为visualizeAll()的耗时，paint为视图重绘耗时
+struct PoolViewFrameStats
+{
+    double lastUpdateMs = 0.0;
+    double avgUpdateMs = 0.0;   // 指数滑动平均
+    double maxUpdateMs = 0.0;
+    double lastPaintMs = 0.0;
+    double avgPaintMs = 0.0;
+    quint64 frames = 0;
+    quint64 itemsCreated = 0;   // 累计新建的图元
+    quint64 itemsRemoved = 0;   // 累计删除的图元
+    int liveItems = 0;          // 当前场景中的图元数
+    bool aggregate = false;     // 是否处于聚合显示（缩小视图时）
+};
+
+class PoolHeatmapItem;
+class PoolBarsItem;
+
 class PoolView : public QGraphicsView
 {
     Q_OBJECT
@@ -46,6 +71,18 @@ public:
     效果：按完成顺序排列，方便查看历史记录
    */
 
+    /*
+    保留模式绘制：
+    - 线程、等待任务、已完成任务的图元常驻场景，按线程ID/任务ID索引
+    - 每次刷新只移动位置或修改样式有变化的图元，新增/删除差异部分，不再clear()整个场景
+    - 网格布局参数只在窗口大小变化时重新计算
+    - waitingTasks/finishedTasks由调用者（PoolModel）持有并增量维护，视图只记住它们的地址，
+      滚动/缩放时按下标读可见范围；必须在clear()之前一直有效
+    视口裁剪与细节层次：
+    - 只为视口内（上下各多留一行）的行创建图元，滚动时按快照补建/删除
+    - Ctrl+滚轮缩放；缩小到AGGREGATE_SCALE以下时改为聚合显示：
+      线程画成一条热力图，等待/已完成任务画成按优先级或耗时分桶的计数柱状图
+    */
     void visualizeAll(const QList<ThreadVisualInfo>& threadInfos,
                       const QList<TaskVisualInfo>& waitingTasks,
                       const QList<TaskVisualInfo>& finishedTasks);
@@ -56,24 +93,121 @@ public:
     void setTaskIdToTotalTimeMs(const QMap<int, int>& taskIdToTotalTimeMs) {m_taskIdToTotalTimeMs = taskIdToTotalTimeMs;}
     // 设置当前调度策略,用于switch绘制任务的label
     void setCurrentPolicy(SchedulePolicy policy) {m_currentPolicy = policy;}
+    const PoolViewFrameStats& frameStats() const { return m_frameStats; }
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    // Ctrl+滚轮缩放视图
+    void wheelEvent(QWheelEvent* event) override;
+    // 滚动时按新的可见范围补建/删除图元
+    void scrollContentsBy(int dx, int dy) override;
+
 private:
-    // 重写resizeEvent，在窗口大小变化时，根据快照重新绘制线程和任务,使每行显示的矩形数量自适应。
+    // 网格布局参数（只在宽度变化时重算）
+    struct GridMetrics
+    {
+        int maxPerRow = 1;
+        int leftMargin = 0;
+    };
+    // 等待任务：圆角矩形 + 子图元(文字、与前一个任务之间的连线和箭头)
+    struct WaitingItem
+    {
+        QGraphicsPathItem* box = nullptr;
+        QGraphicsSimpleTextItem* label = nullptr;
+        QGraphicsLineItem* link = nullptr;
+        QGraphicsPolygonItem* arrow = nullptr;
+        int index = -1;
+        quint64 generation = 0;
+    };
+    // 线程：边框矩形 + 子图元(已完成/未完成两段进度、文字)
+    struct ThreadItem
+    {
+        QGraphicsRectItem* frame = nullptr;
+        QGraphicsRectItem* done = nullptr;
+        QGraphicsRectItem* todo = nullptr;
+        QGraphicsSimpleTextItem* label = nullptr;
+        int index = -1;
+        ThreadState state = THREAD_EXIT;
+        int curTaskId = -2;
+        int doneWidth = -1;
+        quint64 generation = 0;
+    };
+    // 已完成任务：按完成顺序索引（只会追加，taskId用于发现列表被重置）
+    struct FinishedItem
+    {
+        QGraphicsPathItem* box = nullptr;
+        QGraphicsSimpleTextItem* label = nullptr;
+        int taskId = -1;
+        quint64 generation = 0;
+    };
+    // 一个分区中处于视口内的下标范围[first, last)
+    struct VisibleRange
+    {
+        int first = 0;
+        int last = 0;
+    };
+
+    // 重写resizeEvent，窗口大小变化时只重算布局并移动已有图元，不重建
     void resizeEvent(QResizeEvent* event) override;
-    // 绘制线程、等待任务、已完成任务,返回下一个可用的y坐标
-    int drawThreads(const QList<ThreadVisualInfo>& threadInfos, int baseY);
-    int drawWaitingTasks(const QList<TaskVisualInfo>& waitingTasks, int baseY);
-    int drawFinishedTasks(const QList<TaskVisualInfo>& finishedTasks, int baseY);
+    void updateLayoutMetrics();
+    // 更新线程、等待任务、已完成任务,返回下一个可用的y坐标
+    int updateWaitingTasks(const QList<TaskVisualInfo>& waitingTasks, int baseY);
+    int updateThreads(const QList<ThreadVisualInfo>& threadInfos, int baseY);
+    int updateFinishedTasks(const QList<TaskVisualInfo>& finishedTasks, int baseY);
+    // 聚合显示：热力图 / 计数柱状图，返回下一个可用的y坐标
+    int updateThreadHeatmap(const QList<ThreadVisualInfo>& threadInfos, int baseY);
+    int updateTaskBars(PoolBarsItem*& bars, QGraphicsRectItem* layer, const QString& title,
+                       const QList<TaskVisualInfo>& tasks, bool byPriority, const QColor& color, int baseY);
+    // 计算分区中与视口相交的下标范围
+    VisibleRange visibleRange(int baseY, int itemHeight, int rowSpacing, int topSpacing,
+                              const GridMetrics& metrics, int count) const;
+    // 切换详细/聚合显示时删除另一种模式的图元
+    void removeDetailItems();
+    void removeAggregateItems();
+
+    WaitingItem createWaitingItem();
+    ThreadItem createThreadItem();
+    FinishedItem createFinishedItem();
+    QString waitingLabel(const TaskVisualInfo& task, int currentTime) const;
+    void resetItems();
     
 private:
     QGraphicsScene* m_scene = nullptr;
-    // 线程池快照：保存上一次绘制的线程信息，用于在窗口大小变化时重新绘制，不需要读线程池。
+    // 线程池快照：保存上一次绘制的线程信息，用于在窗口大小变化时重新布局，不需要读线程池。
     QList<ThreadVisualInfo> m_lastThreadInfos;
-    // 任务池快照
-    QList<TaskVisualInfo> m_lastWaitingTasks;
-    QList<TaskVisualInfo> m_lastFinishedTasks;
+    // 任务列表：只存地址，不拷贝（隐式共享的拷贝会让模型下一次修改时整份分离复制）
+    const QList<TaskVisualInfo>* m_lastWaitingTasks = nullptr;
+    const QList<TaskVisualInfo>* m_lastFinishedTasks = nullptr;
     QMap<int, int> m_taskIdToTotalTimeMs;
-    SchedulePolicy m_currentPolicy; // 当前调度策略,用于switch绘制任务的label
-    
+    SchedulePolicy m_currentPolicy = SchedulePolicy::FIFO; // 当前调度策略,用于switch绘制任务的label
+
+    // 常驻图元：三个分区各一个容器，分区整体上下移动时只移动容器
+    QGraphicsRectItem* m_waitingLayer = nullptr;
+    QGraphicsRectItem* m_threadLayer = nullptr;
+    QGraphicsRectItem* m_finishedLayer = nullptr;
+    QHash<int, WaitingItem> m_waitingItems;     // 任务ID -> 图元
+    QHash<int, ThreadItem> m_threadItems;       // 线程ID -> 图元
+    QHash<int, FinishedItem> m_finishedItems;   // 完成顺序 -> 图元
+    quint64 m_generation = 0;                   // 每次刷新+1，用于找出已消失的图元
+
+    GridMetrics m_waitingGrid;
+    GridMetrics m_threadGrid;
+    GridMetrics m_finishedGrid;
+    int m_layoutWidth = -1;
+    bool m_layoutChanged = true;
+
+    // 视口裁剪 / 细节层次
+    static constexpr double AGGREGATE_SCALE = 0.5;  // 缩放比例低于它时聚合显示
+    static constexpr double MIN_SCALE = 0.05;
+    static constexpr double MAX_SCALE = 2.0;
+    double m_scale = 1.0;
+    bool m_aggregate = false;
+    bool m_updating = false;        // visualizeAll()内部调整sceneRect会触发滚动，避免重入
+    PoolHeatmapItem* m_threadHeatmap = nullptr;
+    PoolBarsItem* m_waitingBars = nullptr;
+    PoolBarsItem* m_finishedBars = nullptr;
+
+    PoolViewFrameStats m_frameStats;
 };
 
 #endif // POOLVIEW_H
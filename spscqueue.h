@@ -0,0 +1,74 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+/*
+ * 单生产者单消费者无锁环形队列
+ * 1. 容量取2的幂，下标用掩码取模。
+ * 2. 生产者只写m_tail，消费者只写m_head，两者放在不同缓存行，避免伪共享。
+ * 3. 满了push返回false，由调用方决定丢弃还是重试；空了pop返回false。
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+    {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        m_capacity = cap;
+        m_mask = cap - 1;
+        m_buffer.reset(new T[cap]);
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 只能在生产者线程调用
+    bool push(const T& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache >= m_capacity) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache >= m_capacity) return false;
+        }
+        m_buffer[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只能在消费者线程调用
+    bool pop(T& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache) return false;
+        }
+        value = m_buffer[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return m_capacity; }
+    // 近似值，仅用于统计
+    size_t sizeApprox() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    static const size_t CACHE_LINE = 64;
+
+    std::unique_ptr<T[]> m_buffer;
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{0};  // 消费者写
+    size_t m_tailCache = 0;                              // 消费者看到的tail
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};  // 生产者写
+    size_t m_headCache = 0;                              // 生产者看到的head
+};
+
+#endif // SPSCQUEUE_H
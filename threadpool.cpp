@@ -1,390 +1,374 @@
 #include "threadpool.h"
-#include <QDebug>
 #include <QTime>
 #include <QTimer>
+#include <QDateTime>
 #include <QJsonArray>
 
 /*
  * 说明：
- * 1. 原始C++用pthread_create/pthread_join，这里用QThread的start/quit/wait。
- * 2. 线程同步用QMutex和QWaitCondition，替代pthread_mutex_t和pthread_cond_t。
- * 3. 线程池和任务队列都支持信号槽，方便和UI联动。
- * 4. 线程退出用thread->quit()和thread->wait()，自动管理线程生命周期。
+ * 1. 线程的创建/退出、取任务和执行都由m_core（StdThreadPool）完成，这里只在回调里记录和通知。
+ * 2. 回调大多在工作线程上执行，信号跨线程发出，界面侧按队列连接处理。
+ * 3. 析构时先关通信、再销毁m_core（等所有工作线程退出），最后停定时器。
  */
 ThreadPool::ThreadPool(int minNum, int maxNum)
-    : m_minNum(minNum), m_maxNum(maxNum), m_busyNum(0), m_aliveNum(0), m_exitNum(0), m_shutdown(false)
 {
     // 记录线程池开始时间
     m_poolStartTimestamp = QTime::currentTime().msecsSinceStartOfDay();
-    // 实例化任务队列
-    m_taskQ = std::make_unique<TaskQueue>();
-
-    // 创建最小数量的线程
-    for (int i = 0; i < minNum; ++i)
-    {
-        auto thread = std::make_unique<WorkerThread>(this, m_nextThreadId++);
-        int threadId = thread->id();
-        thread->start();
-        m_threads.emplace_back(std::move(thread));
-        
-        m_aliveNum++;
-        emitDelayedSignal(QString("[线程池]创建子线程, ID: %1").arg(threadId), threadId);
-    }
-    // 创建管理者线程
-    m_managerThread = std::make_unique<ManagerThread>(this);
-    m_managerThread->start();
-    emitDelayedSignal(QString("[线程池]创建管理者线程"));
-
-    emitDelayedSignal(QString("[线程池]创建完成，最小线程数: %1，最大线程数: %2").arg(minNum).arg(maxNum));
+    LockProfiler::instance().registerMutex(&m_lock, "ThreadPool::m_lock");
+    // 载荷分配器、事件总线需在工作线程之前创建
+    m_payloadAllocator = std::make_unique<PayloadAllocator>();
+    m_events = std::make_unique<PoolEventBus>();
+    m_metrics = std::make_unique<PoolMetrics>();
+    m_timeline = std::make_shared<PoolTimeline>();
+
+    // 创建引擎：最小数量的工作线程和管理者线程，工作线程各自回调onThreadSpawned
+    // 任务完成后的载荷由工作线程释放，走它绑定的缓存
+    PayloadAllocator* allocator = m_payloadAllocator.get();
+    m_core = std::make_unique<StdThreadPool>(minNum, maxNum, static_cast<PoolObserver*>(this),
+                                             [allocator](void* ptr, size_t size) { allocator->deallocate(ptr, size); });
+    POOL_LOG_INFO("[线程池]创建完成，最小线程数: %1，最大线程数: %2", minNum, maxNum);
     
-    // 通信 - 固定路径
-    QString statusFile = "C:\\Users\\hp\\Desktop\\threadpool_status.json";
-    m_comm = std::make_unique<FileCommunication>(statusFile);
+    // 通信：输出由addStatusSink()添加，没有输出时不上报
     // 任务列表变化时，自动上报状态
     connect(this, &ThreadPool::taskListChanged, this, &ThreadPool::autoReportStatus);
     // 心跳机制：定时器
     m_reportTimer = std::make_unique<QTimer>(this);
     connect(m_reportTimer.get(), &QTimer::timeout, this, &ThreadPool::autoReportStatus);
     m_reportTimer->start(1000);
+    // 时间序列指标采样
+    m_metricsTimer = std::make_unique<QTimer>(this);
+    connect(m_metricsTimer.get(), &QTimer::timeout, this, &ThreadPool::sampleMetrics);
+    m_metricsTimer->start(PoolMetrics::BUCKET_MS);
 }
 
-// WorkerThread实现
-ThreadPool::WorkerThread::WorkerThread(ThreadPool* pool, int id)
-    : m_pool(pool), m_id(id)
+ThreadPool::~ThreadPool()
 {
-}
+    POOL_LOG_INFO("[线程池]开始析构，准备关闭...");
 
-void ThreadPool::WorkerThread::run()
-{
-    while(m_pool && !m_pool->m_shutdown)
-    {
-        Task task;
-        bool shouldExit = false;
-        {
-            QMutexLocker locker(&m_pool->m_lock);
-            /// 一、任务队列为空，阻塞等待任务
-            while (m_pool->m_taskQ->taskNumber() == 0   //任务队列为空
-                    && !m_pool->m_shutdown  //线程池未关闭
-                    && m_pool->m_exitNum == 0)   //不需要缩容
-            {
-                // 等待条件变量，内部自动释放锁
-                m_pool->m_notEmpty.wait(&m_pool->m_lock);
-            }
-            /// 二、任务队列里有了任务
-            // 情况1：缩容退出
-            if (m_pool->m_exitNum > 0
-                && m_pool->m_aliveNum > m_pool->m_minNum)
-            {
-                m_pool->m_exitNum--;
-                m_pool->m_aliveNum--;
-                setState(THREAD_EXIT);
-                shouldExit = true;
-            }
-            // 情况2：线程池关闭
-            if (!shouldExit && m_pool->m_shutdown)
-            {
-                setState(THREAD_EXIT);
-                shouldExit = true;
-            }
-            // 情况3：正常取任务
-            if (!shouldExit)
-            {
-                task = m_pool->m_taskQ->takeTask();
-                startTask(task);
-            }
-        }   // 释放锁
-        if (shouldExit)
-        {
-            // 线程退出，发送信号
-            emit m_pool->threadStateChanged(m_id);
-            emit m_pool->taskListChanged();
-            m_pool->threadExit(m_id);
-            return;
-        }
-        // start的emit放在锁外，线程状态变化:IDLE->BUSY
-        emit m_pool->threadStateChanged(m_id);
-        emit m_pool->taskListChanged();
-        // 执行任务
-        executeTask(task);
-        finishTask(task);
+    // 先关掉通信：控制面的服务线程会往线程池提交任务，必须在关闭线程池之前停下
+    m_comms.clear();
+
+    // 等正在执行的任务结束、所有线程退出；排队中的任务释放载荷后丢弃（计入cancelled）
+    m_core = nullptr;
+
+    POOL_LOG_INFO("[线程池]已正常关闭。");
+
+    // 心跳机制
+    if (m_reportTimer) {
+        m_reportTimer->stop();
+        m_reportTimer = nullptr;
+    }
+    if (m_metricsTimer) {
+        m_metricsTimer->stop();
+        m_metricsTimer = nullptr;
     }
 }
-void ThreadPool::WorkerThread::startTask(const Task& task)
-{
-    m_pool->m_busyNum++;
 
-    setState(THREAD_BUSY);    // 设置忙碌状态
-    setCurTaskId(task.id);
-    setCurTimeMs(0);
-    setCurMemSize(task.memSize);    // 设置正在处理的task的内存大小
-}
-void ThreadPool::WorkerThread::executeTask(const Task& task)
+/// 引擎回调/////////
+void ThreadPool::onThreadSpawned(int threadId)
 {
-    // 分段sleep，定期更新curTimeMs
-    int elapsedTimeMs = 0;  // 已耗时
-    int stepTimeMs = STEP_TIME_MS;   // 刷新频率
-
-    while (elapsedTimeMs < task.totalTimeMs) {
-        QThread::msleep(stepTimeMs);
-        elapsedTimeMs += stepTimeMs;
-        if (elapsedTimeMs > task.totalTimeMs) elapsedTimeMs = task.totalTimeMs;  // 防止溢出
-        {
-            QMutexLocker locker(&m_pool->m_lock);
-            setCurTimeMs(elapsedTimeMs);  
-        }
-        // 发送信号
-        emit m_pool->threadStateChanged(m_id);
-    }
-    // 任务结束时，已耗时=总耗时
+    auto worker = std::make_unique<WorkerRecord>(m_payloadAllocator.get(), m_timeline->addLane(threadId));
+    // 本线程的载荷分配/释放走自己的缓存
+    m_payloadAllocator->bindThreadCache(&worker->payloadCache);
+    // CPU统计从线程启动时算起
+    worker->cpuBase = sampleThreadCpu();
+    // 追踪时每个工作线程一条轨道
+    PoolTracer::setCurrentThreadName(QString("工作线程%1").arg(threadId));
+    POOL_TRACE_INSTANT("thread_start", {"threadId", threadId});
     {
-        QMutexLocker locker(&m_pool->m_lock);
-        setCurTimeMs(task.totalTimeMs);
+        POOL_MUTEX_LOCKER(locker, &m_lock);
+        m_workers[threadId] = std::move(worker);
+        publishThreadEvent(PoolEventType::ThreadSpawned, threadId);
     }
-    // 发送信号
-    emit m_pool->threadStateChanged(m_id);
+    POOL_LOG_INFO("[线程池]创建工作线程, ID: %1", threadId);
+    emitDelayedSignal(threadId);
 }
-void ThreadPool::WorkerThread::finishTask(const Task& task)
+
+void ThreadPool::onThreadExited(int threadId)
 {
+    // 最后一次CPU采样，退出后累计值仍计入线程池
+    ThreadCpuSample cpuSample = sampleThreadCpu();
+    std::unique_ptr<WorkerRecord> worker;
     {
-        QMutexLocker locker(&m_pool->m_lock);
-        m_pool->m_busyNum--;
-        // 添加到已完成任务列表 （这里需要加锁，因为finishedTasks是共享资源）
-        TaskVisualInfo info;
-        info.taskId = task.id;
-        info.state = TASK_FINISHED; // finished
-        info.curThreadId = m_id;
-        info.totalTimeMs = task.totalTimeMs;
-        info.priority = task.priority;
-        info.arrivalTimestampMs = task.arrivalTimestampMs;
-        info.finishTimestampMs = QTime::currentTime().msecsSinceStartOfDay();
-
-        m_pool->m_finishedTasks.append(info);
-
-        // 设置空闲状态，重置所有字段
-        setState(THREAD_IDLE);
-        setCurTaskId(-1);
-        setCurTimeMs(0);
-        setCurMemSize(0);
+        POOL_MUTEX_LOCKER(locker, &m_lock);
+        auto it = m_workers.find(threadId);
+        worker = std::move(it->second);
+        m_workers.erase(it);
+        recordCpuLocked(*worker, cpuSample);
+        publishThreadEvent(PoolEventType::ThreadExited, threadId);
     }
+    POOL_LOG_DEBUG("[线程池]线程 %1 CPU时间 %2ms，主动切换 %3 次，被动切换 %4 次",
+                   threadId, int(worker->cpuUsage.cpuNs / 1000000),
+                   int(worker->cpuUsage.voluntarySwitches), int(worker->cpuUsage.involuntarySwitches));
+    POOL_TRACE_INSTANT("thread_exit", {"threadId", threadId});
+    worker->payloadCache.flush();
+    m_payloadAllocator->bindThreadCache(nullptr);
+    worker->timeline->markExited(QDateTime::currentMSecsSinceEpoch());
+    POOL_LOG_INFO("[线程池]线程 %1 退出", threadId);
+    emit threadStateChanged(threadId);
+    emit taskListChanged();
+}
 
+void ThreadPool::onTaskEnqueuedLocked(const Task& task)
+{
+    PoolEvent event;
+    event.type = PoolEventType::TaskEnqueued;
+    event.taskId = task.id;
+    event.totalTimeMs = task.totalTimeMs;
+    event.priority = task.priority;
+    event.arrivalTimestampMs = task.arrivalTimestampMs;
+    // 与入队在同一把锁内发布，保证快照与事件序号一致
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    m_events->publish(event);
+}
 
+void ThreadPool::onTaskDispatchedLocked(int threadId, const Task& task)
+{
+    // 排队等待时间计入指标直方图（原子操作，不加锁）
+    int waitMs = QTime::currentTime().msecsSinceStartOfDay() - task.arrivalTimestampMs;
+    m_metrics->recordDispatch(waitMs);
+    POOL_TRACE_INSTANT("dispatch", {"taskId", task.id}, {"waitMs", waitMs});
+
+    PoolEvent event;
+    event.type = PoolEventType::TaskDispatched;
+    event.threadId = threadId;
+    event.taskId = task.id;
+
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    WorkerRecord& worker = workerLocked(threadId);
+    worker.timeline->begin(task.id, task.priority, m_policy, QDateTime::currentMSecsSinceEpoch());
+    worker.state = THREAD_BUSY;    // 设置忙碌状态
+    worker.curTaskId = task.id;
+    worker.curTimeMs = 0;
+    worker.curMemSize = task.memSize;   // 设置正在处理的task的内存大小
+    m_events->publish(event);
+}
 
-    // 发送信号
-    emit m_pool->threadStateChanged(m_id);
-    emit m_pool->taskListChanged(); // 任务列表变化
-    emit m_pool->logMessage(QString("[线程池]任务 %1 已完成").arg(task.id));
-
+void ThreadPool::onPolicyChangedLocked(SchedulePolicy policy)
+{
+    PoolEvent event;
+    event.type = PoolEventType::PolicyChanged;
+    event.policy = policy;
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    m_policy = policy;
+    m_events->publish(event);
 }
-// 管理者线程实现
-ThreadPool::ManagerThread::ManagerThread(ThreadPool* pool)
-    : m_pool(pool)
+
+void ThreadPool::onTaskStarted(int threadId, const Task& task)
 {
+    POOL_TRACE_BEGIN("task", {"taskId", task.id}, {"priority", task.priority});
+    // 线程状态变化:IDLE->BUSY
+    emit threadStateChanged(threadId);
+    emit taskListChanged();
 }
-void ThreadPool::ManagerThread::run()
+
+void ThreadPool::onTaskProgress(int threadId, const Task& task, int elapsedMs)
 {
-    while(m_pool && !m_pool->m_shutdown)
+    ThreadCpuSample cpuSample = sampleThreadCpu();  // 锁外采样
+    PoolEvent event;
+    event.type = PoolEventType::TaskProgress;
+    event.threadId = threadId;
+    event.taskId = task.id;
+    event.curTimeMs = elapsedMs;
     {
-        // 每隔5s检测一次
-        QThread::sleep(MANAGER_CHECK_INTERVAL_S);
-        // 取出线程池中的任务数和线程数量
-        int queueSize = 0;
-        int liveNum = 0;
-        int busyNum = 0;
-        {
-            QMutexLocker locker(&m_pool->m_lock);
-            queueSize = m_pool->m_taskQ->taskNumber();
-            liveNum = m_pool->m_aliveNum;
-            busyNum = m_pool->m_busyNum;
-        }
-
-        // 控制线程池扩容速度的参数。每次最多创建2个线程
-        const int NUMBER = THREAD_EXPAND_NUMBER;
-        // 当前任务个数>存活的线程数 && 存活的线程数<最大线程个数
-        if (queueSize > liveNum && liveNum < m_pool->m_maxNum)
-        {
-            std::vector<std::unique_ptr<WorkerThread>> newThreads;
-            // 线程池加锁
-            {
-                QMutexLocker locker(&m_pool->m_lock);
-            
-                // 有NUMBER限制，每次只创建2个线程；5s后再检查，如果有需要就再创建2个
-                for (int i = 0; i < NUMBER && m_pool->m_aliveNum < m_pool->m_maxNum; ++i)
-                {
-                    // 创建新线程
-                    auto thread = std::make_unique<WorkerThread>(m_pool, m_pool->m_nextThreadId++);
-                    thread->setState(THREAD_IDLE);
-                    m_pool->m_aliveNum++;
-                    // 先放到newThreads，再移动到m_threads，因为unique_ptr不能复制，必须移动
-                    newThreads.emplace_back(std::move(thread));
-                    
-                }
-            }// 释放锁
-
-            for (auto& thread : newThreads)
-            {
-                int threadId = thread->id();
-                thread->start();
-                m_pool->m_threads.emplace_back(std::move(thread));
-                emit m_pool->logMessage(QString("[管理者线程]创建新工作线程, ID: %1").arg(threadId));
-                emit m_pool->threadStateChanged(threadId);
-            }
-        }
-
-        // 销毁多余的线程
-        // 忙线程*2 < 存活的线程数目 && 存活的线程数 > 最小线程数量
-        if (busyNum * 2 < liveNum && liveNum > m_pool->m_minNum)
-        {
-            {
-                QMutexLocker locker(&m_pool->m_lock);
-                m_pool->m_exitNum = NUMBER;
-            }
-            // 唤醒NUMBER个等待的线程，让他们退出
-            for (int i = 0; i < NUMBER; ++i)
-            {
-                m_pool->m_notEmpty.wakeOne();
-            }
-            emit m_pool->logMessage(QString("[管理者线程]销毁%1个线程").arg(NUMBER));
-        }
+        POOL_MUTEX_LOCKER(locker, &m_lock);
+        WorkerRecord& worker = workerLocked(threadId);
+        recordCpuLocked(worker, cpuSample);
+        worker.curTimeMs = elapsedMs;
+        m_events->publish(event);
     }
-    emit m_pool->logMessage("[管理者线程]退出");
+    emit threadStateChanged(threadId);
 }
 
-
-
-
-ThreadPool::~ThreadPool()
+void ThreadPool::onTaskFinished(int threadId, const Task& task, int64_t wallNs, int64_t cpuNs)
 {
-    emit logMessage("[线程池]开始析构，准备关闭...");
-
-    m_shutdown = true;
-
-    // 唤醒所有等待线程
-    m_notEmpty.wakeAll();
+    POOL_TRACE_END("task", {"taskId", task.id}, {"cpuUs", cpuNs / 1000});
+    ThreadCpuSample cpuSample = sampleThreadCpu();
+
+    TaskVisualInfo info;
+    info.taskId = task.id;
+    info.state = TASK_FINISHED; // finished
+    info.curThreadId = threadId;
+    info.totalTimeMs = task.totalTimeMs;
+    info.priority = task.priority;
+    info.arrivalTimestampMs = task.arrivalTimestampMs;
+    info.finishTimestampMs = task.finishTimestampMs;
+    info.wallTimeUs = int(wallNs / 1000);
+    info.cpuTimeUs = int(cpuNs / 1000);
+
+    PoolEvent event;
+    event.type = PoolEventType::TaskFinished;
+    event.threadId = threadId;
+    event.taskId = info.taskId;
+    event.totalTimeMs = info.totalTimeMs;
+    event.priority = info.priority;
+    event.arrivalTimestampMs = info.arrivalTimestampMs;
+    event.finishTimestampMs = info.finishTimestampMs;
+    event.wallTimeUs = info.wallTimeUs;
+    event.cpuTimeUs = info.cpuTimeUs;
+    {
+        POOL_MUTEX_LOCKER(locker, &m_lock);
+        WorkerRecord& worker = workerLocked(threadId);
+        recordCpuLocked(worker, cpuSample);
+        worker.busyWallNs += wallNs;
+        m_taskCpuNs += cpuNs;
+        m_taskWallNs += wallNs;
+        recordFinishedLocked(info);
+        m_metrics->recordFinish();
+        worker.timeline->end(QDateTime::currentMSecsSinceEpoch());
+        m_events->publish(event);
+        // 设置空闲状态，重置所有字段
+        worker.state = THREAD_IDLE;
+        worker.curTaskId = -1;
+        worker.curTimeMs = 0;
+        worker.curMemSize = 0;
+    }
+    emit threadStateChanged(threadId);
+    emit taskListChanged(); // 任务列表变化
+    POOL_LOG_DEBUG("[线程池]任务 %1 已完成", task.id);
+}
 
-    if (m_managerThread)
+void ThreadPool::onSizingChecked(int queueSize, int aliveNum, int busyNum, int spawned, int exitRequests)
+{
+    // 管理者线程没有单独的启动回调，在这里给它的追踪轨道命名
+    PoolTracer::setCurrentThreadName("管理者线程");
+    // 扩缩容依据：队列长度和线程数，追踪中显示为计数器曲线
+    POOL_TRACE_COUNTER("queue", {"waiting", queueSize});
+    POOL_TRACE_COUNTER("threads", {"alive", aliveNum}, {"busy", busyNum});
+    if (spawned > 0)
     {
-        m_managerThread->wait();
-        m_managerThread = nullptr;
-        emit logMessage("[线程池]管理者线程已安全退出");
+        POOL_TRACE_INSTANT("expand", {"alive", aliveNum}, {"spawned", spawned});
+        POOL_LOG_INFO("[管理者线程]扩容%1个线程", spawned);
     }
-    // 等待所有线程结束
-    for (const auto& thread : m_threads)
+    if (exitRequests > 0)
     {
-        qDebug() << "[线程池] 等待线程" << thread->id() << "退出...";
-        thread->wait();
-        qDebug() << "[线程池] 线程" << thread->id() << "已安全退出";
+        POOL_TRACE_INSTANT("shrink", {"alive", aliveNum}, {"exitRequests", exitRequests});
+        POOL_LOG_INFO("[管理者线程]销毁%1个线程", exitRequests);
     }
+}
 
-    if (m_taskQ) {
-        m_taskQ = nullptr;
-    }
+ThreadPool::WorkerRecord& ThreadPool::workerLocked(int threadId) const
+{
+    // 记录在线程的第一个回调里创建、最后一个回调里删除，其间一定存在
+    return *m_workers.at(threadId);
+}
 
-    emit logMessage("[线程池]已正常关闭。");
+void ThreadPool::recordCpuLocked(WorkerRecord& worker, const ThreadCpuSample& sample)
+{
+    ThreadCpuSample usage = sample - worker.cpuBase;
+    ThreadCpuSample delta = usage - worker.cpuUsage;
+    worker.cpuUsage = usage;
+    m_cpuTotal += delta;
+    m_metrics->recordCpu(delta.cpuNs);
+}
 
-    // 通信
-    if (m_comm) {
-        m_comm = nullptr;
-    }
-    // 心跳机制
-    if (m_reportTimer) {
-        m_reportTimer->stop();
-        m_reportTimer = nullptr;
+/// 任务相关/////////
+void ThreadPool::addTask(Task&& task)
+{
+    // 内部任务（parallelFor的领取票）量大且很短，不记日志和追踪；事件、计数、轨迹由引擎按Task::internal区分
+    const bool internal = task.internal;
+    if (!internal) {
+        // 日志只记录参数，由日志线程格式化；必须在task被移动之前记录
+        POOL_LOG_DEBUG("[线程池]添加任务 %1 到队列 (耗时:%2s, 优先级:%3, 内存:%4B)",
+                       task.id, task.totalTimeMs / 1000.0, task.priority, task.memSize);
+        POOL_TRACE_INSTANT("enqueue", {"taskId", task.id}, {"priority", task.priority});
     }
+    m_core->addTask(std::move(task));
+    if (!internal) emit taskListChanged();
 }
 
-void ThreadPool::addTask(Task task)
-{
-    if (m_shutdown) return;
-    // 添加任务，不需要加锁，任务队列中有锁
-    m_taskQ->addTask(task);
-    // 唤醒一个等待的线程
-    m_notEmpty.wakeOne();
-    // emit logMessage(QString("[线程池]添加任务 %1 到队列").arg(task.id));
-    emit logMessage(
-        QString("[线程池]添加任务 %1 到队列 (耗时:%2s, 优先级:%3, 内存:%4B)")
-            .arg(task.id)
-            .arg(task.totalTimeMs / 1000.0, 0, 'f', 1)
-            .arg(task.priority)
-            .arg(task.memSize)
-    );
+void ThreadPool::addTasks(std::vector<Task>&& tasks)
+{
+    if (tasks.empty()) return;
+    int count = static_cast<int>(tasks.size());
+    for (const auto& task : tasks)
+    {
+        POOL_TRACE_INSTANT("enqueue", {"taskId", task.id}, {"priority", task.priority});
+    }
+    // 一次加锁入队，一次唤醒所有等待线程
+    m_core->addTasks(std::move(tasks));
+    POOL_LOG_INFO("[线程池]批量添加 %1 个任务到队列", count);
     emit taskListChanged();
 }
 
-/// 任务相关/////////
-// 获取任务队列中等待任务个数
+// 获取任务队列中等待任务个数（不含内部任务）
 int ThreadPool::getWaitingTaskNumber() const
 {
-    return m_taskQ->taskNumber();
+    return m_core->getWaitingTaskNumber();
 }
 
 // 获取任务队列中正在执行任务个数
 int ThreadPool::getRunningTaskNumber() const
 {
-    QMutexLocker locker(&m_lock);
-    return m_busyNum;   // 忙碌的线程个数 = 正在执行任务的个数
+    return m_core->getBusyNumber();   // 忙碌的线程个数 = 正在执行任务的个数
 }
 
 // 获取任务队列中已完成任务个数
 int ThreadPool::getFinishedTaskNumber() const
 {
-    QMutexLocker locker(&m_lock);
-    return m_finishedTasks.size();
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    return m_finishedNum;
+}
+
+TaskVisualInfo ThreadPool::waitingTaskInfo(const Task& task)
+{
+    TaskVisualInfo info;
+    info.taskId = task.id;
+    info.state = TASK_WAITING; // waiting
+    info.curThreadId = -1;
+    info.totalTimeMs = task.totalTimeMs;
+    info.priority = task.priority;
+    info.arrivalTimestampMs = task.arrivalTimestampMs;  // 用于统计HR响应比
+    info.finishTimestampMs = 0;  // 等待任务不参与性能统计
+    return info;
 }
 
 QList<TaskVisualInfo> ThreadPool::getWaitingTaskVisualInfo() const
 {
     QList<TaskVisualInfo> waitingTaskInfos;
-    QMutexLocker locker(&m_lock);
-    for (auto task : m_taskQ->getTasks())
+    // 持引擎的锁遍历，不拷贝整个队列
+    m_core->inspectQueue([&waitingTaskInfos](const TaskQueue& queue)
     {
-        TaskVisualInfo info;
-        info.taskId = task.id;
-        info.state = TASK_WAITING; // waiting
-        info.curThreadId = -1;
-        info.totalTimeMs = task.totalTimeMs;
-        info.priority = task.priority;
-        info.arrivalTimestampMs = task.arrivalTimestampMs;  // 用于统计HR响应比
-        info.finishTimestampMs = 0;  // 等待任务不参与性能统计
-        waitingTaskInfos.append(info);
-    }
+        waitingTaskInfos.reserve(queue.taskNumber());
+        queue.forEachTask([&waitingTaskInfos](const Task& task)
+        {
+            // 内部任务没有入队事件，快照里也不出现
+            if (!task.internal) waitingTaskInfos.append(waitingTaskInfo(task));
+        });
+    });
     return waitingTaskInfos;
 }
+
 QList<TaskVisualInfo> ThreadPool::getFinishedTaskVisualInfo() const
 {
-    QMutexLocker locker(&m_lock);
+    POOL_MUTEX_LOCKER(locker, &m_lock);
     return m_finishedTasks;
 }
 
-int ThreadPool::getTotalWaitingTimeMs()
+qint64 ThreadPool::getTotalWaitingTimeMs() const
 {
-    QMutexLocker locker(&m_lock);
-    int totalWaitingTimeMs = 0;
-    for (const auto& finishedTask : m_finishedTasks)
-    {
-        totalWaitingTimeMs += finishedTask.finishTimestampMs - finishedTask.arrivalTimestampMs;
-    }
-    return totalWaitingTimeMs;
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    return m_totalWaitingTimeMs;
 }
 
 // 获取总响应比 = (等待时间 + 服务时间) / 服务时间
-double ThreadPool::getTotalResponseRatio()
+double ThreadPool::getTotalResponseRatio() const
 {
-    QMutexLocker locker(&m_lock);
-    double totalResponseRatio = 0.0;
-    int validTasks = 0;
-    
-    for (const auto& finishedTask : m_finishedTasks)
-    {
-        int waitTime = finishedTask.finishTimestampMs - finishedTask.arrivalTimestampMs;
-        int executionTime = finishedTask.totalTimeMs;
-        
-        if (executionTime > 0) {
-            double responseRatio = (waitTime + executionTime) / (double)executionTime;
-            totalResponseRatio += responseRatio;
-            validTasks++;
-        }
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    return m_totalResponseRatio;
+}
+
+void ThreadPool::recordFinishedLocked(const TaskVisualInfo& info)
+{
+    int waitTime = info.finishTimestampMs - info.arrivalTimestampMs;
+    m_finishedNum++;
+    m_totalWaitingTimeMs += waitTime;
+    if (info.totalTimeMs > 0) {
+        m_totalResponseRatio += (waitTime + info.totalTimeMs) / (double)info.totalTimeMs;
     }
-    return validTasks > 0 ? totalResponseRatio : 0.0;
+    // 列表只留最近的一段，快照拷贝和界面展示的代价不随运行时间增长
+    m_finishedTasks.append(info);
+    if (m_finishedTasks.size() > PoolSnapshot::FINISHED_HISTORY) m_finishedTasks.removeFirst();
 }
 
 int ThreadPool::getTotalTimeMs()
@@ -392,67 +376,99 @@ int ThreadPool::getTotalTimeMs()
     return QTime::currentTime().msecsSinceStartOfDay() - m_poolStartTimestamp;
 }
 
+quint64 ThreadPool::getQueueAllocationCount() const
+{
+    return m_core->getQueueAllocationCount();
+}
 
+quint64 ThreadPool::getSubmittedTaskNumber() const
+{
+    return m_core->getSubmittedTaskNumber();
+}
 
-/// 线程相关/////////
+int ThreadPool::allocateTaskIds(int count)
+{
+    return m_core->allocateTaskIds(count);
+}
 
-int ThreadPool::getAliveNumber() const
+int ThreadPool::getOldestPendingTaskId() const
 {
-    QMutexLocker locker(&m_lock);
-    return m_aliveNum;
+    return m_core->getOldestPendingTaskId();
 }
 
-int ThreadPool::getBusyNumber() const
+void ThreadPool::setThreadRange(int minNum, int maxNum)
+{
+    // 新线程在onThreadSpawned里记录和通知
+    m_core->setThreadRange(minNum, maxNum);
+    POOL_LOG_INFO("[线程池]线程数范围调整为 %1 ~ %2", minNum, maxNum);
+}
+
+
+
+PoolCpuStats ThreadPool::getCpuStats() const
 {
-    QMutexLocker locker(&m_lock);
-    return m_busyNum;
+    PoolCpuStats stats;
+    stats.supported = threadCpuTimeSupported();
+    stats.cpuPercent = m_metrics->latest(PoolMetric::CpuPercent);
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    stats.cpuTimeMs = m_cpuTotal.cpuNs / 1000000;
+    stats.taskCpuTimeMs = m_taskCpuNs / 1000000;
+    stats.taskWallTimeMs = m_taskWallNs / 1000000;
+    stats.efficiency = m_taskWallNs > 0 ? m_taskCpuNs / double(m_taskWallNs) : 0.0;
+    stats.voluntarySwitches = m_cpuTotal.voluntarySwitches;
+    stats.involuntarySwitches = m_cpuTotal.involuntarySwitches;
+    return stats;
 }
 
-void ThreadPool::threadExit(int threadId)
+/// 线程相关/////////
+
+int ThreadPool::getAliveNumber() const
 {
-    emit logMessage(QString("[线程池]线程 %1 退出").arg(threadId));
+    return m_core->getAliveNumber();
 }
 
+int ThreadPool::getBusyNumber() const
+{
+    return m_core->getBusyNumber();
+}
 
-// 构造函数中，延迟广播线程状态变化
-void ThreadPool::emitDelayedSignal(const QString& logMsg, int threadId)
+// 延迟广播线程状态变化：排进线程池所在线程的事件循环
+void ThreadPool::emitDelayedSignal(int threadId)
 {
-    QTimer::singleShot(0, this, [this, logMsg, threadId]() {
-        if (threadId != -1) {
-            emit threadStateChanged(threadId);
-        }
-        if (!logMsg.isEmpty()) {
-            emit logMessage(logMsg);
-        }
-    });
+    QMetaObject::invokeMethod(this, [this, threadId]() {
+        emit threadStateChanged(threadId);
+    }, Qt::QueuedConnection);
 }
 
 ThreadState ThreadPool::getThreadState(int threadId) const
 {
-    QMutexLocker locker(&m_lock);
-    for (const auto& thread : m_threads)
-    {
-        if (thread->id() == threadId)
-        {
-            return thread->state();
-        }
-    }
-    return THREAD_EXIT;
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    auto it = m_workers.find(threadId);
+    return it != m_workers.end() ? it->second->state : THREAD_EXIT;
 }
 
 QList<ThreadVisualInfo> ThreadPool::getThreadVisualInfo() const
+{
+    POOL_MUTEX_LOCKER(locker, &m_lock);
+    return getThreadVisualInfoLocked();
+}
+
+QList<ThreadVisualInfo> ThreadPool::getThreadVisualInfoLocked() const
 {
     QList<ThreadVisualInfo> threadInfos;
-    QMutexLocker locker(&m_lock);
-    for (const auto& thread : m_threads)
+    // 已退出的线程已从m_workers删除
+    for (const auto& entry : m_workers)
     {
-        // 线程退出后不显示
-        if (thread->state() == THREAD_EXIT) continue;
+        const WorkerRecord& worker = *entry.second;
         ThreadVisualInfo info;
-        info.threadId = thread->id();
-        info.state = thread->state();
-        info.curTaskId = thread->curTaskId();
-        info.curTimeMs = thread->curTimeMs();
+        info.threadId = entry.first;
+        info.state = worker.state;
+        info.curTaskId = worker.curTaskId;
+        info.curTimeMs = worker.curTimeMs;
+        info.cpuTimeMs = int(worker.cpuUsage.cpuNs / 1000000);
+        info.busyTimeMs = int(worker.busyWallNs / 1000000);
+        info.voluntarySwitches = int(worker.cpuUsage.voluntarySwitches);
+        info.involuntarySwitches = int(worker.cpuUsage.involuntarySwitches);
         // 更多字段待补充
         threadInfos.append(info);   
     }
@@ -461,61 +477,217 @@ QList<ThreadVisualInfo> ThreadPool::getThreadVisualInfo() const
 
 
 void ThreadPool::setSchedulePolicy(SchedulePolicy policy) {
-    TaskScheduler* scheduler = nullptr;
-    QString policyName;
-    switch (policy) {
-        case SchedulePolicy::FIFO:
-            scheduler = new FIFOScheduler();
-            policyName = "FIFO";
-            break;
-        case SchedulePolicy::LIFO:
-            scheduler = new LIFOScheduler();
-            policyName = "LIFO";
-            break;
-        case SchedulePolicy::SJF:
-            scheduler = new SJFScheduler();
-            policyName = "SJF";
-            break;
-        case SchedulePolicy::LJF:
-            scheduler = new LJFScheduler();
-            policyName = "LJF";
-            break;
-        case SchedulePolicy::PRIO:
-            scheduler = new PRIOScheduler();
-            policyName = "PRIO";
-            break;
-        case SchedulePolicy::HRRN:
-            scheduler = new HRRNScheduler();
-            policyName = "HRRN";
-            break;
-        default:
-            scheduler = new FIFOScheduler();
-            policyName = "FIFO";
-            break;
-    }
-    m_taskQ->setScheduler(scheduler);
-    emit logMessage(QString("[线程池]当前调度策略: %1").arg(policyName));
+    // 重排队列，PolicyChanged事件在onPolicyChangedLocked里发布
+    m_core->setSchedulePolicy(policy);
+    POOL_LOG_INFO("[线程池]当前调度策略: %1", schedulePolicyName(policy));
+}
+
+/// 事件流相关/////////
+std::shared_ptr<PoolEventSubscription> ThreadPool::subscribeEvents(size_t capacity)
+{
+    return m_events->subscribe(capacity);
+}
+
+void ThreadPool::unsubscribeEvents(const std::shared_ptr<PoolEventSubscription>& subscription)
+{
+    m_events->unsubscribe(subscription);
+}
+
+/// 时间序列指标/////////
+void ThreadPool::sampleMetrics()
+{
+    m_metrics->closeBucket(QDateTime::currentMSecsSinceEpoch(), m_core->getWaitingTaskNumber(),
+                           m_core->getAliveNumber(), m_core->getBusyNumber());
+}
+
+QList<MetricsPoint> ThreadPool::getMetricsSeries(PoolMetric metric, qint64 windowMs, int maxPoints) const
+{
+    return m_metrics->series(metric, windowMs, maxPoints);
+}
+
+std::shared_ptr<PoolTimeline> ThreadPool::getTimeline() const
+{
+    return m_timeline;
+}
+
+PoolSnapshot ThreadPool::getSnapshot() const
+{
+    PoolSnapshot snapshot;
+    // 入队/派发/换策略的事件在引擎的锁内发布，其余事件在m_lock内发布：两把锁都持有时读到的序号与状态一致
+    m_core->inspectQueue([this, &snapshot](const TaskQueue& queue)
+    {
+        POOL_MUTEX_LOCKER(locker, &m_lock);
+        snapshot.seq = m_events->lastSeq();
+        snapshot.policy = m_policy;
+        snapshot.threads = getThreadVisualInfoLocked();
+        snapshot.finishedTasks = m_finishedTasks;
+        queue.forEachTask([&snapshot](const Task& task)
+        {
+            if (!task.internal) snapshot.waitingTasks.append(waitingTaskInfo(task));
+        });
+    });
+    return snapshot;
+}
+
+void ThreadPool::publishThreadEvent(PoolEventType type, int threadId)
+{
+    PoolEvent event;
+    event.type = type;
+    event.threadId = threadId;
+    m_events->publish(event);
+}
+
+/// 内存预算相关/////////
+void ThreadPool::setMemoryBudget(size_t budgetBytes)
+{
+    m_core->setMemoryBudget(budgetBytes);
+    if (budgetBytes > 0)
+        POOL_LOG_INFO("[线程池]内存预算: %1B", budgetBytes);
+    else
+        POOL_LOG_INFO("[线程池]内存预算: 不限");
+}
+
+size_t ThreadPool::getMemoryBudget() const
+{
+    return m_core->getMemoryBudget();
+}
+
+size_t ThreadPool::getMemoryReserved() const
+{
+    return m_core->getMemoryReserved();
+}
+
+size_t ThreadPool::getMemoryInUse() const
+{
+    return m_payloadAllocator->requestedBytes();
+}
+
+/// 载荷相关/////////
+void* ThreadPool::allocatePayload(size_t size)
+{
+    return m_payloadAllocator->allocate(size);
+}
+
+void ThreadPool::freePayload(void* ptr, size_t size)
+{
+    m_payloadAllocator->deallocate(ptr, size);
+}
+
+PayloadAllocatorStats ThreadPool::getPayloadAllocatorStats() const
+{
+    return m_payloadAllocator->stats();
 }
 
 /// 通信相关/////////
 void ThreadPool::autoReportStatus()
 {
-    if (!m_comm || m_shutdown) return;
+    if (m_comms.empty()) return;
     QJsonObject data;
     QJsonArray activeTasks;
 
-    QMutexLocker locker(&m_lock);
-    for (const auto& thread : m_threads)
+    // 引擎的计数器无锁读取；内存预算要加引擎的锁，必须在m_lock之外读（加锁顺序见threadpool.h）
+    const PoolCounters& counters = m_core->getCounters();
+    data["aliveThreads"] = counters.aliveThreads.load(std::memory_order_relaxed);
+    data["busyThreads"] = counters.busyThreads.load(std::memory_order_relaxed);
+    data["waitingTasks"] = counters.queuedTasks.load(std::memory_order_relaxed);
+    data["submittedTasks"] = static_cast<qint64>(counters.submitted.load(std::memory_order_relaxed));
+    data["memoryBudget"] = static_cast<qint64>(m_core->getMemoryBudget());
+    data["memoryReserved"] = static_cast<qint64>(m_core->getMemoryReserved());
+
+    // 只在锁内收集数据，编码和写文件由输出端在锁外（TelemetrySink在后台线程）完成
     {
-        if (thread->state() == THREAD_BUSY)//running
+        POOL_MUTEX_LOCKER(locker, &m_lock);
+        for (const auto& entry : m_workers)
         {
-            QJsonObject task;
-            task["id"] = thread->curTaskId();
-            task["memSize"] = static_cast<qint64>(thread->curMemSize());
-            activeTasks.append(task);
+            const WorkerRecord& worker = *entry.second;
+            if (worker.state == THREAD_BUSY)//running
+            {
+                QJsonObject task;
+                task["id"] = worker.curTaskId;
+                task["threadId"] = entry.first;
+                task["memSize"] = static_cast<qint64>(worker.curMemSize);
+                activeTasks.append(task);
+            }
         }
-    }
     
-    data["activeTasks"] = activeTasks;  // 活跃线程
-    m_comm->send(data);
+        data["activeTasks"] = activeTasks;  // 活跃线程
+
+        // 各工作线程的CPU时间与上下文切换
+        QJsonArray workers;
+        for (const auto& entry : m_workers)
+        {
+            const WorkerRecord& record = *entry.second;
+            QJsonObject worker;
+            worker["id"] = entry.first;
+            worker["state"] = static_cast<int>(record.state);
+            worker["curTaskId"] = record.state == THREAD_BUSY ? record.curTaskId : -1;
+            worker["cpuTimeMs"] = static_cast<qint64>(record.cpuUsage.cpuNs / 1000000);
+            worker["busyTimeMs"] = static_cast<qint64>(record.busyWallNs / 1000000);
+            worker["voluntarySwitches"] = static_cast<qint64>(record.cpuUsage.voluntarySwitches);
+            worker["involuntarySwitches"] = static_cast<qint64>(record.cpuUsage.involuntarySwitches);
+            workers.append(worker);
+        }
+        data["workers"] = workers;
+        // 计数器
+        data["policy"] = static_cast<int>(m_policy);
+        data["finishedTasks"] = m_finishedNum;
+        data["cpuTimeMs"] = static_cast<qint64>(m_cpuTotal.cpuNs / 1000000);
+        data["taskCpuEfficiency"] = m_taskWallNs > 0 ? m_taskCpuNs / double(m_taskWallNs) : 0.0;
+
+        // 载荷分配器占用与碎片情况
+        PayloadAllocatorStats allocStats = m_payloadAllocator->stats();
+        QJsonObject allocator;
+        allocator["slabBytes"] = static_cast<qint64>(allocStats.slabBytes);
+        allocator["inUseBytes"] = static_cast<qint64>(allocStats.inUseBytes);
+        allocator["requestedBytes"] = static_cast<qint64>(allocStats.requestedBytes);
+        allocator["cachedBytes"] = static_cast<qint64>(allocStats.cachedBytes);
+        allocator["largeBytes"] = static_cast<qint64>(allocStats.largeBytes);
+        allocator["largeCount"] = static_cast<qint64>(allocStats.largeCount);
+        allocator["occupancy"] = allocStats.occupancy;
+        allocator["internalFragmentation"] = allocStats.internalFragmentation;
+        QJsonArray classes;
+        for (const auto& classStats : allocStats.classes)
+        {
+            QJsonObject cls;
+            cls["blockSize"] = static_cast<qint64>(classStats.blockSize);
+            cls["slabs"] = static_cast<qint64>(classStats.slabCount);
+            cls["totalBlocks"] = static_cast<qint64>(classStats.totalBlocks);
+            cls["inUseBlocks"] = static_cast<qint64>(classStats.inUseBlocks);
+            cls["cachedBlocks"] = static_cast<qint64>(classStats.cachedBlocks);
+            classes.append(cls);
+        }
+        allocator["classes"] = classes;
+        data["payloadAllocator"] = allocator;
+    }
+
+    for (const auto& comm : m_comms)
+    {
+        comm->send(data);
+    }
+}
+
+void ThreadPool::addStatusSink(std::unique_ptr<ICommunication> sink)
+{
+    m_comms.push_back(std::move(sink));
+}
+
+bool ThreadPool::startWorkloadRecording(const QString& path)
+{
+    if (!m_core->startWorkloadRecording(path.toStdString())) {
+        POOL_LOG_WARNING("[线程池]无法打开负载轨迹文件，未记录");
+        return false;
+    }
+    POOL_LOG_INFO("[线程池]开始记录负载轨迹");
+    return true;
+}
+
+void ThreadPool::stopWorkloadRecording()
+{
+    m_core->stopWorkloadRecording();
+    POOL_LOG_INFO("[线程池]负载轨迹记录结束，共 %1 个任务", m_core->getRecordedTaskNumber());
+}
+
+quint64 ThreadPool::getRecordedTaskNumber() const
+{
+    return m_core->getRecordedTaskNumber();
 }
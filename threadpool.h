@@ -3,26 +3,49 @@
 
 #include <QObject>
 #include <QMutex>
-#include <QThread>
 #include <QList>
-#include <vector>
-#include <QWaitCondition>
 #include <QTimer>
+#include <vector>
+#include <map>
 #include <memory>
-#include "taskqueue.h"
+#include "lockprofiler.h"
 #include "visualinfo.h"
 #include "scheduler.h"
-#include "communication/filecommunication.h"
+#include "payloadallocator.h"
+#include "poolevents.h"
+#include "poollog.h"
+#include "pooltrace.h"
+#include "poolmetrics.h"
+#include "poolcounters.h"
+#include "poolobserver.h"
+#include "stdthreadpool.h"
+#include "pooltimeline.h"
+#include "threadcpu.h"
+#include "communication/ICommunication.h"
 
 
 /*
  * 说明：
- * 1. 原始C++用pthread_t数组和pthread_cond_t，这里用QThread子类和QWaitCondition。
- * 2. QMutex/QWaitCondition配合使用，替代pthread_mutex_t/pthread_cond_t。
- * 3. 线程池本身继承QObject，方便信号槽和UI联动。
+ * 1. 队列、调度、工作线程和管理线程都在core/StdThreadPool里，这里不再有第二套工作/管理循环。
+ * 2. ThreadPool是它的Qt层：实现PoolObserver，在回调里维护线程的可视化状态、事件流、指标、时间线和载荷缓存，
+ *    再发信号给界面。入队/派发/换策略的事件在StdThreadPool的锁内发布，快照与事件序号保持一致。
+ * 3. 加锁顺序固定为StdThreadPool的锁在前、m_lock在后：持有m_lock时不调用m_core的任何接口。
+ * 4. 线程池本身继承QObject，方便信号槽和UI联动。
  */
+// 线程池CPU统计（累计值包含已退出的线程）
+struct PoolCpuStats
+{
+    bool supported = false;             // 平台不支持线程CPU时间时其余字段无意义
+    qint64 cpuTimeMs = 0;               // 所有工作线程实际占用的CPU时间
+    qint64 taskCpuTimeMs = 0;           // 已完成任务执行期间的CPU时间
+    qint64 taskWallTimeMs = 0;          // 已完成任务执行期间的墙钟时间
+    double cpuPercent = 0.0;            // 最近一个指标桶的CPU占用（相对全部CPU核）
+    double efficiency = 0.0;            // taskCpuTimeMs / taskWallTimeMs
+    qint64 voluntarySwitches = 0;
+    qint64 involuntarySwitches = 0;
+};
 
-class ThreadPool : public QObject
+class ThreadPool : public QObject, private PoolObserver
 {
     Q_OBJECT
 public:
@@ -30,13 +53,15 @@ public:
     ~ThreadPool();
 
     /// 任务相关/////////
-    // 添加任务
-    void addTask(Task task);
+    // 添加任务（Task只能移动，调用方需std::move）
+    void addTask(Task&& task);
+    // 批量添加任务，一次加锁、一次唤醒
+    void addTasks(std::vector<Task>&& tasks);
     // 获取任务队列中等待任务个数
     int getWaitingTaskNumber() const;
     // 获取任务队列中正在执行任务个数
     int getRunningTaskNumber() const;
-    // 获取任务队列中已完成任务个数
+    // 获取已完成任务个数（累计）
     int getFinishedTaskNumber() const;
 
     /// 线程相关/////////
@@ -50,122 +75,164 @@ public:
     QList<ThreadVisualInfo> getThreadVisualInfo() const;
     // 获得任务可视化信息
     QList<TaskVisualInfo> getWaitingTaskVisualInfo() const;
+    // 最近PoolSnapshot::FINISHED_HISTORY个已完成任务
     QList<TaskVisualInfo> getFinishedTaskVisualInfo() const;
 
-    // 线程池性能指标
-    int getTotalWaitingTimeMs();
-    double getTotalResponseRatio();
+    // 线程池性能指标：完成时累加，读取是O(1)
+    qint64 getTotalWaitingTimeMs() const;
+    double getTotalResponseRatio() const;
     int getTotalTimeMs();
+    // 任务队列节点池的堆分配次数、累计提交任务数（用于统计每个任务的分配开销）
+    quint64 getQueueAllocationCount() const;
+    quint64 getSubmittedTaskNumber() const;
+    // 分配count个连续的任务ID，返回第一个（UI和外部提交方共用，ID不会冲突）
+    int allocateTaskIds(int count);
+    // 排队中和执行中任务的最小ID，没有时返回下一个要分配的ID：比它小的已提交任务都已结束。
+    // 要遍历队列，只适合偶尔调用（如控制面在事件溢出后清理批次）
+    int getOldestPendingTaskId() const;
+
+    // 数据并行：[begin,end)按懒惰二分拆给工作线程，调用线程（也可以是工作线程）一起做，返回时全部完成。
+    // body(b, e)每次处理不超过grain个下标；parallelReduce的map(b, e)返回部分结果，由combine从左到右合并。
+    // 拆出的块以内部任务（Task::internal）进入任务队列，占用工作线程，但不算在任务数、统计和任务列表里；细节见parallelfor.h
+    template <typename Body>
+    void parallelFor(qint64 begin, qint64 end, qint64 grain, Body&& body)
+    {
+        m_core->parallelFor(begin, end, grain, std::forward<Body>(body));
+    }
+    template <typename T, typename Map, typename Combine>
+    T parallelReduce(qint64 begin, qint64 end, qint64 grain, T identity, Map&& map, Combine&& combine)
+    {
+        return m_core->parallelReduce(begin, end, grain, std::move(identity),
+                                      std::forward<Map>(map), std::forward<Combine>(combine));
+    }
+
+    // 运行中调整最小/最大线程数：不足最小值立即创建，超过最大值的线程空闲后退出
+    void setThreadRange(int minNum, int maxNum);
+
+    // CPU统计：线程CPU时间、CPU占用、任务CPU效率、上下文切换
+    PoolCpuStats getCpuStats() const;
+    // 累计计数器和延迟直方图：无锁读取，供外部抓取（不会阻塞工作线程）
+    const PoolCounters& getCounters() const { return m_core->getCounters(); }
 
     // 设置调度策略
     void setSchedulePolicy(SchedulePolicy policy);
 
+    // 时间序列指标：最近windowMs内某项指标，按maxPoints降采样（min/max）
+    QList<MetricsPoint> getMetricsSeries(PoolMetric metric, qint64 windowMs, int maxPoints) const;
+    // 各工作线程的执行时间线（甘特图），线程池析构后仍可读取
+    std::shared_ptr<PoolTimeline> getTimeline() const;
+
+    // 增量事件流：订阅者各自一条无锁队列，配合getSnapshot()做首次同步/丢事件后的重新同步
+    std::shared_ptr<PoolEventSubscription> subscribeEvents(size_t capacity = PoolEventBus::DEFAULT_CAPACITY);
+    void unsubscribeEvents(const std::shared_ptr<PoolEventSubscription>& subscription);
+    PoolSnapshot getSnapshot() const;
+
+    // 内存预算（0表示不限）：调度时跳过放不下的任务，优先调度能放下的任务
+    void setMemoryBudget(size_t budgetBytes);
+    size_t getMemoryBudget() const;
+    // 已预留内存：正在执行任务的memSize之和（占用预算的部分）
+    size_t getMemoryReserved() const;
+    // 实际使用内存：任务载荷当前占用的字节数（含排队中的任务）
+    size_t getMemoryInUse() const;
+
+    // 任务载荷分配：由线程池的slab分配器管理，任务执行完成后自动释放
+    void* allocatePayload(size_t size);
+    void freePayload(void* ptr, size_t size);
+    PayloadAllocatorStats getPayloadAllocatorStats() const;
+
+    // 添加状态上报输出（TelemetrySink、SharedMemoryCommunication等），每次上报依次发给所有输出；
+    // 需在线程池所在线程调用
+    void addStatusSink(std::unique_ptr<ICommunication> sink);
+
+    // 负载轨迹：记录此后每次提交的任务（到达时刻、执行时间、优先级、载荷大小、批次），poolcli --replay可重放
+    bool startWorkloadRecording(const QString& path);
+    void stopWorkloadRecording();
+    quint64 getRecordedTaskNumber() const;
+
 signals:
     // 线程状态变化、任务完成、日志输出（方便UI联动）
     void threadStateChanged(int threadId); 
     // 任务列表变化
     void taskListChanged();
-    // 日志输出
-    void logMessage(const QString& message);
+    // 日志不再走信号，统一写入PoolLogger（见poollog.h）
 
 private:
-    void threadExit(int threadId);
-    void emitDelayedSignal(const QString& logMsg = "", int threadId = -1);
+    // 工作线程在Qt层的记录：可视化状态、CPU采样、载荷缓存和时间线
+    // 在工作线程的onThreadSpawned里创建、onThreadExited里删除；字段由m_lock保护，载荷缓存只在所属线程上使用
+    struct WorkerRecord
+    {
+        WorkerRecord(PayloadAllocator* allocator, std::shared_ptr<ThreadTimeline> lane)
+            : payloadCache(allocator), timeline(std::move(lane)) {}
+
+        ThreadState state = THREAD_IDLE;
+        int curTaskId = -1;         // 线程忙碌时正在处理的task的id
+        int curTimeMs = 0;          // 线程忙碌时正在处理的task的已耗时
+        size_t curMemSize = 0;      // 线程忙碌时正在处理的task的内存大小
+        PayloadAllocator::ThreadCache payloadCache;     // 本线程的载荷缓存
+        std::shared_ptr<ThreadTimeline> timeline;       // 本线程的执行时间线
+        ThreadCpuSample cpuBase;    // 线程启动时的采样
+        ThreadCpuSample cpuUsage;   // 启动以来的累计
+        qint64 busyWallNs = 0;
+    };
+
+    // PoolObserver：Locked结尾的在StdThreadPool的锁内调用，其余在工作线程/管理线程上锁外调用
+    void onTaskEnqueuedLocked(const Task& task) override;
+    void onTaskDispatchedLocked(int threadId, const Task& task) override;
+    void onPolicyChangedLocked(SchedulePolicy policy) override;
+    void onTaskStarted(int threadId, const Task& task) override;
+    int progressStepMs() const override { return STEP_TIME_MS; }
+    void onTaskProgress(int threadId, const Task& task, int elapsedMs) override;
+    void onTaskFinished(int threadId, const Task& task, int64_t wallNs, int64_t cpuNs) override;
+    void onThreadSpawned(int threadId) override;
+    void onThreadExited(int threadId) override;
+    void onSizingChecked(int queueSize, int aliveNum, int busyNum, int spawned, int exitRequests) override;
+
+    // 以下调用方需持有m_lock
+    WorkerRecord& workerLocked(int threadId) const;
+    void publishThreadEvent(PoolEventType type, int threadId);
+    // 记录线程的CPU采样，增量计入线程池
+    void recordCpuLocked(WorkerRecord& worker, const ThreadCpuSample& sample);
+    // 已完成任务计入累计统计和最近列表
+    void recordFinishedLocked(const TaskVisualInfo& info);
+    QList<ThreadVisualInfo> getThreadVisualInfoLocked() const;
+    static TaskVisualInfo waitingTaskInfo(const Task& task);
+    // 排到线程池所在线程的事件循环里再发（构造期间创建的线程，界面还没来得及连接信号）
+    void emitDelayedSignal(int threadId);
 
     // 通信相关
     void autoReportStatus();
+    // 指标采样：每PoolMetrics::BUCKET_MS结束一个桶
+    void sampleMetrics();
 
+    // 常量
+    static const int STEP_TIME_MS = 20;     // 任务进度的刷新步长
 
-/*
-    QThread 线程类核心说明
-    - start()    // 启动线程，自动调用 run()
-    - run()      // 线程主函数，写线程要做的事（本项目：取任务并执行）
-    - exec()     // 启动事件循环（本项目未用）
-    - quit()     // 退出事件循环（本项目未用）
-    - wait()     // 等待线程结束（析构时用）
-    - 信号槽     // 线程与主线程通信（如任务完成、状态变化）
-
-    【本项目流程简述】
-    - WorkerThread 继承 QThread，重写 run()，实现线程池工作循环。
-    - 线程池用 start() 启动线程，run() 里不断取任务、执行任务、更新状态。
-    - 线程状态和当前任务ID通过成员变量和信号槽与主线程/UI联动。
-    - 析构时用 wait() 等待所有线程安全退出。
-*/
-    // 工作线程类，继承QThread，重写run方法
-    class WorkerThread : public QThread
-    {
-    public:
-        WorkerThread(ThreadPool* pool, int id);
-        void run() override;
-        int id() const { return m_id; }
-        // 新增state字段，线程状态：0=空闲, 1=忙碌, -1=退出
-        ThreadState state() const { return m_state; }   // 内部使用，如果外部使用需要用getThreadState()
-        // 新增curTaskId字段：线程忙碌时正在处理的task的id
-        int curTaskId() const { return m_curTaskId; }
-        // 新增curTimeMs字段：线程忙碌时正在处理的task的已耗时
-        int curTimeMs() const { return m_curTimeMs; }
-        // 新增curMemSize字段：线程忙碌时正在处理的task的内存大小
-        size_t curMemSize() const { return m_curMemSize; }
-        
-        // setter
-        void setState(ThreadState state) { m_state = state; }
-        void setCurTaskId(int curTaskId) { m_curTaskId = curTaskId; }
-        void setCurTimeMs(int curTimeMs) { m_curTimeMs = curTimeMs; }
-        void setCurMemSize(size_t curMemSize) { m_curMemSize = curMemSize; }
-   
-    private:
-        // 任务状态统一管理入口
-        void startTask(const Task& task);
-        void executeTask(const Task& task);
-        void finishTask(const Task& task);
-    
-
-        ThreadPool* m_pool;
-        int m_id;
-        ThreadState m_state = THREAD_IDLE; // 0=空闲, 1=忙碌, -1=退出
-        int m_curTaskId = -1;
-        int m_curTimeMs = 0;
-        size_t m_curMemSize = 0;    
-    };
-
-    // 管理者线程类，继承QThread，重写run方法
-    class ManagerThread : public QThread
-    {
-    public:
-        ManagerThread(ThreadPool* pool);
-        void run() override;
-    private:
-        ThreadPool* m_pool;
-    };
+    mutable QMutex m_lock;          // 保护本层的状态（线程记录、已完成列表、CPU统计、事件发布）
 
-    // 常量
-    static const int MANAGER_CHECK_INTERVAL_S = 5;
-    static const int STEP_TIME_MS = 20;
-    static const int THREAD_EXPAND_NUMBER = 2;
-
-    mutable QMutex m_lock;          // Qt互斥锁，替代pthread_mutex_t
-    QWaitCondition m_notEmpty;      // Qt条件变量，替代pthread_cond_t
-
-    // 普通指针->智能指针
-   std::vector<std::unique_ptr<WorkerThread>> m_threads;
-   std::unique_ptr<TaskQueue> m_taskQ;
-   std::unique_ptr<ManagerThread> m_managerThread;
-   std::unique_ptr<FileCommunication> m_comm;
+    // 载荷分配器要比工作线程活得久（线程退出时缓存会归还给它），所以放在m_core之前
+   std::unique_ptr<PayloadAllocator> m_payloadAllocator;
+   std::unique_ptr<PoolEventBus> m_events;
+   std::unique_ptr<PoolMetrics> m_metrics;
+   std::shared_ptr<PoolTimeline> m_timeline;
+   std::map<int, std::unique_ptr<WorkerRecord>> m_workers;    // 存活的工作线程，按线程ID
+   std::vector<std::unique_ptr<ICommunication>> m_comms;
    std::unique_ptr<QTimer> m_reportTimer;
+   std::unique_ptr<QTimer> m_metricsTimer;
 
-    int m_minNum;
-    int m_maxNum;
-    int m_busyNum;  // 正在执行任务的线程个数
-    int m_aliveNum;
-    int m_exitNum;
+    SchedulePolicy m_policy = SchedulePolicy::FIFO;     // 与PolicyChanged事件同步更新，快照用
 
-    QList<TaskVisualInfo> m_finishedTasks;
-    bool m_shutdown = false;
+    QList<TaskVisualInfo> m_finishedTasks;     // 最近PoolSnapshot::FINISHED_HISTORY个
+    int m_finishedNum = 0;                  // 以下为全部已完成任务的累计
+    qint64 m_totalWaitingTimeMs = 0;
+    double m_totalResponseRatio = 0.0;      // totalTimeMs为0的任务不计
+    ThreadCpuSample m_cpuTotal;     // 所有工作线程（含已退出）的CPU累计
+    qint64 m_taskCpuNs = 0;         // 已完成任务的CPU时间之和
+    qint64 m_taskWallNs = 0;        // 已完成任务的墙钟时间之和
 
     int m_poolStartTimestamp;   // 线程池开始时间,用于计算吞吐量中的总耗时
-    int m_nextThreadId = 1;
-
 
+    // 线程池引擎，最后构造；析构时最先销毁（等工作线程退出），之后不会再有回调
+   std::unique_ptr<StdThreadPool> m_core;
 };
 
 #endif // THREADPOOL_H
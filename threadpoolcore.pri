@@ -0,0 +1,43 @@
+# 线程池核心（不依赖QtWidgets）：GUI程序ThreadPool.pro和命令行程序tools/poolcli共用
+# 其中不依赖Qt的部分在core/core.pri：线程池引擎StdThreadPool在那里，Qt版ThreadPool是它上面的一层
+QT       += core network
+
+INCLUDEPATH += $$PWD
+
+include($$PWD/core/core.pri)
+
+SOURCES += \
+    $$PWD/communication/filecommunication.cpp \
+    $$PWD/communication/localsocketcommunication.cpp \
+    $$PWD/communication/prometheusendpoint.cpp \
+    $$PWD/communication/sharedmemorycommunication.cpp \
+    $$PWD/communication/telemetrysink.cpp \
+    $$PWD/lockprofiler.cpp \
+    $$PWD/payloadallocator.cpp \
+    $$PWD/poolevents.cpp \
+    $$PWD/poollog.cpp \
+    $$PWD/poolmetrics.cpp \
+    $$PWD/pooltimeline.cpp \
+    $$PWD/pooltrace.cpp \
+    $$PWD/threadpool.cpp
+
+HEADERS += \
+    $$PWD/communication/ICommunication.h \
+    $$PWD/communication/controlprotocol.h \
+    $$PWD/communication/filecommunication.h \
+    $$PWD/communication/localsocketcommunication.h \
+    $$PWD/communication/prometheusendpoint.h \
+    $$PWD/communication/sharedmemorycommunication.h \
+    $$PWD/communication/shmstatus.h \
+    $$PWD/communication/telemetryformat.h \
+    $$PWD/communication/telemetrysink.h \
+    $$PWD/lockprofiler.h \
+    $$PWD/payloadallocator.h \
+    $$PWD/poolevents.h \
+    $$PWD/poollog.h \
+    $$PWD/poolmetrics.h \
+    $$PWD/pooltimeline.h \
+    $$PWD/pooltrace.h \
+    $$PWD/spscqueue.h \
+    $$PWD/threadpool.h \
+    $$PWD/visualinfo.h
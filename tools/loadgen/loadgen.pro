@@ -0,0 +1,15 @@
+# 控制面压测客户端：通过本地套接字批量提交任务，统计提交/完成吞吐和端到端延迟
+QT       += core network
+QT       -= gui
+
+CONFIG += console c++17
+include($$PWD/../../warnings.pri)
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../communication
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    ../../communication/controlprotocol.h
@@ -0,0 +1,318 @@
+#include "controlprotocol.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalSocket>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+using namespace ControlProtocol;
+
+/*
+ * 用法：loadgen [选项]
+ *   --server NAME      控制面名字（默认threadpool-control）
+ *   --tasks N          提交的任务总数（默认1000000）
+ *   --batch B          每批任务数（默认1024，最大65536）
+ *   --task-ms MS       每个任务的执行时间（默认0，只测调度开销）
+ *   --priority-max P   优先级在1~P之间随机（默认10）
+ *   --mem BYTES        每个任务的载荷大小（默认0）
+ *   --rate R           限速：每秒提交的任务数（默认0，不限速）
+ *   --policy N         提交前切换调度策略（0=FIFO ... 5=HRRN）
+ *   --threads MIN:MAX  提交前调整线程数范围
+ *   --no-wait          提交完就退出，不等完成通知
+ * 延迟 = 收到某任务完成通知的时刻 - 发出该任务所在批次的时刻。
+ */
+
+namespace {
+
+struct Options
+{
+    QString server = DEFAULT_SERVER_NAME;
+    qint64 tasks = 1000000;
+    int batch = 1024;
+    int taskMs = 0;
+    int priorityMax = 10;
+    quint32 mem = 0;
+    qint64 rate = 0;
+    int policy = -1;
+    int minThreads = -1;
+    int maxThreads = -1;
+    bool wait = true;
+};
+
+// 已确认（收到SubmitAck）的批次，用于从任务ID找回发送时刻
+struct AckedBatch
+{
+    int count = 0;
+    qint64 sentNs = 0;
+};
+
+class LoadGenerator
+{
+public:
+    explicit LoadGenerator(const Options& options) : m_options(options) {}
+
+    int run();
+
+private:
+    bool readFrames();
+    void sendBatch(int count);
+    void handleFrame(const Frame& frame);
+    void printSummary(qint64 submitNs, qint64 totalNs);
+
+    const Options& m_options;
+    QLocalSocket m_socket;
+    QElapsedTimer m_clock;
+    QByteArray m_input;
+    QByteArray m_output;
+    quint32 m_nextRequestId = 1;
+    std::unordered_map<quint32, qint64> m_pendingAcks;      // requestId -> 发送时刻
+    std::map<int, AckedBatch> m_batches;                    // firstTaskId -> 批次
+    std::vector<qint64> m_latenciesNs;
+    qint64 m_acked = 0;
+    qint64 m_finished = 0;
+    bool m_failed = false;
+};
+
+int LoadGenerator::run()
+{
+    m_socket.connectToServer(m_options.server);
+    if (!m_socket.waitForConnected(3000)) {
+        fprintf(stderr, "loadgen: cannot connect to %s: %s\n", qPrintable(m_options.server), qPrintable(m_socket.errorString()));
+        return 1;
+    }
+    if (m_options.policy >= 0) {
+        int start = beginFrame(m_output, SetPolicy);
+        append<quint8>(m_output, quint8(m_options.policy));
+        endFrame(m_output, start);
+    }
+    if (m_options.minThreads >= 0) {
+        int start = beginFrame(m_output, SetThreadRange);
+        append<quint32>(m_output, quint32(m_options.minThreads));
+        append<quint32>(m_output, quint32(m_options.maxThreads));
+        endFrame(m_output, start);
+    }
+    if (m_options.wait) m_latenciesNs.reserve(size_t(m_options.tasks));
+
+    m_clock.start();
+    qint64 submitted = 0;
+    while (submitted < m_options.tasks && !m_failed) {
+        if (m_options.rate > 0) {
+            // 按目标速率算出这一批最早的发送时刻
+            qint64 dueNs = submitted * 1000000000LL / m_options.rate;
+            qint64 aheadNs = dueNs - m_clock.nsecsElapsed();
+            if (aheadNs > 0) {
+                m_socket.waitForReadyRead(int(qMax<qint64>(1, aheadNs / 1000000)));
+                if (!readFrames()) break;
+                continue;
+            }
+        }
+        int count = int(qMin<qint64>(m_options.batch, m_options.tasks - submitted));
+        sendBatch(count);
+        submitted += count;
+        // 写缓冲积压时等一等，同时把已到达的确认和完成通知读掉，避免两端互相堵住
+        while (m_socket.bytesToWrite() > 4 * 1024 * 1024 && m_socket.state() == QLocalSocket::ConnectedState) {
+            m_socket.waitForBytesWritten(10);
+            if (!readFrames()) break;
+        }
+        if (!readFrames()) break;
+    }
+    m_socket.flush();
+    while (m_socket.bytesToWrite() > 0 && m_socket.state() == QLocalSocket::ConnectedState) {
+        m_socket.waitForBytesWritten(100);
+    }
+    qint64 submitNs = m_clock.nsecsElapsed();
+
+    if (m_options.wait) {
+        while (!m_failed && m_finished < submitted) {
+            if (m_socket.state() != QLocalSocket::ConnectedState) {
+                fprintf(stderr, "loadgen: server closed the connection\n");
+                m_failed = true;
+                break;
+            }
+            m_socket.waitForReadyRead(1000);
+            readFrames();
+        }
+    }
+    printSummary(submitNs, m_clock.nsecsElapsed());
+    m_socket.disconnectFromServer();
+    return m_failed ? 1 : 0;
+}
+
+void LoadGenerator::sendBatch(int count)
+{
+    quint32 requestId = m_nextRequestId++;
+    int start = beginFrame(m_output, SubmitBatch);
+    append<quint32>(m_output, requestId);
+    append<quint32>(m_output, quint32(count));
+    QRandomGenerator* random = QRandomGenerator::global();
+    for (int i = 0; i < count; ++i) {
+        append<quint32>(m_output, quint32(m_options.taskMs));
+        append<qint32>(m_output, random->bounded(1, m_options.priorityMax + 1));
+        append<quint32>(m_output, m_options.mem);
+    }
+    endFrame(m_output, start);
+    m_pendingAcks[requestId] = m_clock.nsecsElapsed();
+    m_socket.write(m_output);
+    m_output.clear();
+}
+
+bool LoadGenerator::readFrames()
+{
+    if (m_socket.bytesAvailable() > 0) m_input.append(m_socket.readAll());
+    int offset = 0;
+    Frame frame;
+    while (true) {
+        ParseResult result = parseFrame(m_input, offset, frame);
+        if (result == ParseResult::Incomplete) break;
+        if (result == ParseResult::Invalid) {
+            fprintf(stderr, "loadgen: malformed frame from server\n");
+            m_failed = true;
+            return false;
+        }
+        handleFrame(frame);
+        offset += frame.totalSize;
+    }
+    m_input.remove(0, offset);
+    return !m_failed;
+}
+
+void LoadGenerator::handleFrame(const Frame& frame)
+{
+    switch (frame.type) {
+    case SubmitAck: {
+        quint32 requestId = read<quint32>(frame.payload, 0);
+        auto it = m_pendingAcks.find(requestId);
+        if (it == m_pendingAcks.end()) break;
+        AckedBatch batch;
+        batch.count = int(read<quint32>(frame.payload, 8));
+        batch.sentNs = it->second;
+        m_batches[read<qint32>(frame.payload, 4)] = batch;
+        m_pendingAcks.erase(it);
+        m_acked += batch.count;
+        break;
+    }
+    case TasksFinished: {
+        qint64 nowNs = m_clock.nsecsElapsed();
+        quint32 count = read<quint32>(frame.payload, 0);
+        const uchar* entry = frame.payload + 4;
+        for (quint32 i = 0; i < count; ++i, entry += FINISHED_ENTRY_SIZE) {
+            int taskId = read<qint32>(entry, 0);
+            auto it = m_batches.upper_bound(taskId);
+            if (it == m_batches.begin()) continue;
+            --it;
+            if (m_options.wait) m_latenciesNs.push_back(nowNs - it->second.sentNs);
+            m_finished++;
+            if (--it->second.count == 0) m_batches.erase(it);
+        }
+        break;
+    }
+    case NotificationsLost:
+        fprintf(stderr, "loadgen: server dropped completion notifications, latency stats are partial\n");
+        // 丢了哪些任务的通知无法得知，不再等待剩余的完成通知
+        m_failed = true;
+        break;
+    case Error:
+        fprintf(stderr, "loadgen: server error %d: %s\n", frame.payload[0],
+                QByteArray(reinterpret_cast<const char*>(frame.payload) + 1, frame.size - 1).constData());
+        m_failed = true;
+        break;
+    default:
+        break;
+    }
+}
+
+void LoadGenerator::printSummary(qint64 submitNs, qint64 totalNs)
+{
+    printf("submitted   %lld tasks in %.3f s (%.0f tasks/s), acked %lld\n",
+           m_options.tasks, submitNs / 1e9, m_options.tasks / qMax(submitNs / 1e9, 1e-9), m_acked);
+    if (!m_options.wait) return;
+    printf("finished    %lld tasks in %.3f s (%.0f tasks/s)\n",
+           m_finished, totalNs / 1e9, m_finished / qMax(totalNs / 1e9, 1e-9));
+    if (m_latenciesNs.empty()) return;
+    std::sort(m_latenciesNs.begin(), m_latenciesNs.end());
+    auto percentile = [this](double p) {
+        size_t index = size_t(p * double(m_latenciesNs.size() - 1));
+        return m_latenciesNs[index] / 1e3;
+    };
+    printf("latency us  p50 %.0f  p90 %.0f  p99 %.0f  max %.0f\n",
+           percentile(0.50), percentile(0.90), percentile(0.99), m_latenciesNs.back() / 1e3);
+}
+
+bool parseInt(const QString& text, qint64 minValue, qint64& value)
+{
+    bool ok = false;
+    qint64 parsed = text.toLongLong(&ok);
+    if (!ok || parsed < minValue) return false;
+    value = parsed;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+    Options options;
+    bool ok = true;
+    for (int i = 0; i < args.size() && ok; ++i) {
+        const QString& arg = args[i];
+        if (arg == "--no-wait") {
+            options.wait = false;
+            continue;
+        }
+        if (i + 1 >= args.size()) {
+            ok = false;
+            break;
+        }
+        const QString value = args[++i];
+        qint64 number = 0;
+        if (arg == "--server") {
+            options.server = value;
+        } else if (arg == "--tasks") {
+            ok = parseInt(value, 1, number);
+            options.tasks = number;
+        } else if (arg == "--batch") {
+            ok = parseInt(value, 1, number) && number <= MAX_BATCH_TASKS;
+            options.batch = int(number);
+        } else if (arg == "--task-ms") {
+            ok = parseInt(value, 0, number);
+            options.taskMs = int(number);
+        } else if (arg == "--priority-max") {
+            ok = parseInt(value, 1, number);
+            options.priorityMax = int(number);
+        } else if (arg == "--mem") {
+            ok = parseInt(value, 0, number);
+            options.mem = quint32(number);
+        } else if (arg == "--rate") {
+            ok = parseInt(value, 0, number);
+            options.rate = number;
+        } else if (arg == "--policy") {
+            ok = parseInt(value, 0, number) && number <= 5;
+            options.policy = int(number);
+        } else if (arg == "--threads") {
+            QStringList range = value.split(':');
+            qint64 minNum = 0;
+            qint64 maxNum = 0;
+            ok = range.size() == 2 && parseInt(range[0], 0, minNum) && parseInt(range[1], 1, maxNum) && minNum <= maxNum;
+            options.minThreads = int(minNum);
+            options.maxThreads = int(maxNum);
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: loadgen [--server NAME] [--tasks N] [--batch B] [--task-ms MS] [--priority-max P]\n"
+                        "               [--mem BYTES] [--rate TASKS_PER_SEC] [--policy N] [--threads MIN:MAX] [--no-wait]\n");
+        return 2;
+    }
+
+    LoadGenerator generator(options);
+    return generator.run();
+}
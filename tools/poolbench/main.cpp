@@ -0,0 +1,778 @@
+#include "threadpool.h"
+#include "stdthreadpool.h"
+#include "referenceworkloads.h"
+#include "lockprofiler.h"
+#include "poollog.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QThread>
+#include <QSysInfo>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+/*
+ * 用法：poolbench [选项]
+ *   --json FILE          结果写入FILE（默认输出到stdout），可读摘要始终输出到stderr
+ *   --baseline FILE      与之前的结果对比，逐项输出变化百分比
+ *   --filter NAME        只跑名字包含NAME的组：submit dispatch throughput workload parallel scheduler visual
+ *   --max-threads N      吞吐测试的最大线程数（默认CPU核数），按1、2、4…N递增
+ *   --quick              缩小任务数和队列长度，几秒内跑完，用于冒烟
+ * 每组对Qt版ThreadPool和core/StdThreadPool（有的话）各测一遍，空任务（totalTimeMs=0）只测框架本身的开销；
+ * ThreadPool建在StdThreadPool之上，两者之差就是Qt层的开销。
+ * 单项结果：name + params唯一确定一项，value为主指标（延迟类取p50，吞吐类取tasks/s），
+ * 延迟类另有min/p50/p90/p99/max/mean（纳秒）。submit和throughput组另有allocsPerTask：这段时间内任务队列节点池的
+ * 堆分配次数除以入队次数（getQueueAllocationCount()/getSubmittedTaskNumber()的差值），稳态下应为0。
+ * workload组用core/referenceworkloads.h的真实负载（只测std后端），效率=实际吞吐/线程数×单线程理想吞吐，
+ * 随线程数下降的快慢反映各类负载在算力、缓存和内存带宽上的瓶颈。
+ * parallel组在工作量不均匀的循环上对比手工静态分块（按线程数等分、每块一个addTask、调用线程干等）和parallelFor，
+ * 取每轮的总耗时。
+ * 编译时打开POOL_LOCK_PROFILING时，额外输出"locks"：各加锁调用点的次数、持有/等待时间。
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct Options
+{
+    QString jsonFile;
+    QString baselineFile;
+    QString filter;
+    int maxThreads = qMax(1, QThread::idealThreadCount());
+    bool quick = false;
+};
+
+struct Stats
+{
+    qint64 count = 0;
+    qint64 min = 0;
+    qint64 p50 = 0;
+    qint64 p90 = 0;
+    qint64 p99 = 0;
+    qint64 max = 0;
+    double mean = 0.0;
+};
+
+Stats summarize(std::vector<qint64>& samples)
+{
+    Stats stats;
+    if (samples.empty()) return stats;
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double p) { return samples[size_t(p * double(samples.size() - 1))]; };
+    double sum = 0.0;
+    for (qint64 sample : samples) sum += double(sample);
+    stats.count = qint64(samples.size());
+    stats.min = samples.front();
+    stats.p50 = at(0.50);
+    stats.p90 = at(0.90);
+    stats.p99 = at(0.99);
+    stats.max = samples.back();
+    stats.mean = sum / double(samples.size());
+    return stats;
+}
+
+// 收集结果，写JSON并在stderr打印一行摘要
+class Reporter
+{
+public:
+    // allocsPerTask<0表示不统计
+    void addLatency(const QString& name, const QJsonObject& params, std::vector<qint64>& samplesNs, double allocsPerTask = -1.0)
+    {
+        Stats stats = summarize(samplesNs);
+        QJsonObject entry = makeEntry(name, params, "ns", double(stats.p50));
+        entry["samples"] = stats.count;
+        entry["min"] = stats.min;
+        entry["p50"] = stats.p50;
+        entry["p90"] = stats.p90;
+        entry["p99"] = stats.p99;
+        entry["max"] = stats.max;
+        entry["mean"] = stats.mean;
+        if (allocsPerTask >= 0.0) entry["allocsPerTask"] = allocsPerTask;
+        m_results.append(entry);
+        fprintf(stderr, "%-34s %-40s p50 %9lld  p99 %10lld  max %11lld ns  (n=%lld)%s\n",
+                qPrintable(name), qPrintable(paramText(params)), stats.p50, stats.p99, stats.max, stats.count,
+                qPrintable(allocText(allocsPerTask)));
+    }
+
+    void addValue(const QString& name, const QJsonObject& params, const char* unit, double value, double allocsPerTask = -1.0)
+    {
+        QJsonObject entry = makeEntry(name, params, unit, value);
+        if (allocsPerTask >= 0.0) entry["allocsPerTask"] = allocsPerTask;
+        m_results.append(entry);
+        fprintf(stderr, "%-34s %-40s %12.0f %s%s\n", qPrintable(name), qPrintable(paramText(params)), value, unit,
+                qPrintable(allocText(allocsPerTask)));
+    }
+
+    void setLocks(const QJsonArray& locks) { m_locks = locks; }
+
+    QJsonObject document(const Options& options) const
+    {
+        QJsonObject host;
+        host["cpus"] = QThread::idealThreadCount();
+        host["os"] = QSysInfo::prettyProductName();
+        host["arch"] = QSysInfo::currentCpuArchitecture();
+        host["qt"] = QString(qVersion());
+        QJsonObject root;
+        root["format"] = "poolbench";
+        root["version"] = 1;
+        root["host"] = host;
+        root["quick"] = options.quick;
+        root["lockProfiling"] = LockProfiler::enabled();
+        root["results"] = m_results;
+        if (LockProfiler::enabled()) root["locks"] = m_locks;
+        return root;
+    }
+
+    // 与基线按name+params逐项对比，输出value的变化
+    void compare(const QJsonObject& baseline) const
+    {
+        std::map<QString, double> previous;
+        for (const QJsonValue& value : baseline["results"].toArray()) {
+            QJsonObject entry = value.toObject();
+            previous[key(entry)] = entry["value"].toDouble();
+        }
+        fprintf(stderr, "\n对比基线（value，延迟类为p50纳秒，吞吐类为tasks/s）：\n");
+        for (const QJsonValue& value : m_results) {
+            QJsonObject entry = value.toObject();
+            auto it = previous.find(key(entry));
+            if (it == previous.end() || it->second == 0.0) continue;
+            double now = entry["value"].toDouble();
+            fprintf(stderr, "%-34s %-40s %12.0f -> %12.0f  %+6.1f%%\n",
+                    qPrintable(entry["name"].toString()), qPrintable(paramText(entry["params"].toObject())),
+                    it->second, now, (now - it->second) / it->second * 100.0);
+        }
+    }
+
+private:
+    static QJsonObject makeEntry(const QString& name, const QJsonObject& params, const char* unit, double value)
+    {
+        QJsonObject entry;
+        entry["name"] = name;
+        entry["params"] = params;
+        entry["unit"] = unit;
+        entry["value"] = value;
+        return entry;
+    }
+
+    static QString paramText(const QJsonObject& params)
+    {
+        QStringList parts;
+        for (auto it = params.begin(); it != params.end(); ++it) {
+            QJsonValue value = it.value();
+            parts << it.key() + "=" + (value.isString() ? value.toString() : QString::number(value.toDouble()));
+        }
+        return parts.join(' ');
+    }
+
+    static QString allocText(double allocsPerTask)
+    {
+        return allocsPerTask >= 0.0 ? QString("  alloc/task %1").arg(allocsPerTask, 0, 'f', 5) : QString();
+    }
+
+    static QString key(const QJsonObject& entry)
+    {
+        return entry["name"].toString() + "|" + QString::fromUtf8(QJsonDocument(entry["params"].toObject()).toJson(QJsonDocument::Compact));
+    }
+
+    QJsonArray m_results;
+    QJsonArray m_locks;
+};
+
+// 空任务，只测线程池自身的开销
+Task emptyTask(int id)
+{
+    Task task;
+    task.id = id;
+    task.totalTimeMs = 0;
+    task.priority = 1;
+    task.arrivalTimestampMs = currentTimeOfDayMs();
+    return task;
+}
+
+// 等待Qt线程池完成target个任务；工作线程的信号排队投递到本线程，等待期间要处理事件
+bool waitFinished(ThreadPool& pool, quint64 target, int timeoutMs = 60000)
+{
+    qint64 deadline = nowNs() + qint64(timeoutMs) * 1000000;
+    while (pool.getCounters().finished.load(std::memory_order_relaxed) < target) {
+        QCoreApplication::processEvents();
+        if (nowNs() > deadline) return false;
+        QThread::yieldCurrentThread();
+    }
+    QCoreApplication::processEvents();
+    return true;
+}
+
+// 记录std后端最近开始/完成的任务，派发延迟测试用
+class LatencyObserver : public PoolObserver
+{
+public:
+    void onTaskStarted(int threadId, const Task& task) override
+    {
+        Q_UNUSED(threadId);
+        startedNs.store(nowNs(), std::memory_order_relaxed);
+        startedId.store(task.id, std::memory_order_release);
+    }
+    void onTaskFinished(int threadId, const Task& task, int64_t wallNs, int64_t cpuNs) override
+    {
+        Q_UNUSED(threadId);
+        Q_UNUSED(wallNs);
+        Q_UNUSED(cpuNs);
+        finishedId.store(task.id, std::memory_order_release);
+    }
+
+    std::atomic<qint64> startedNs{0};
+    std::atomic<int> startedId{0};
+    std::atomic<int> finishedId{0};
+};
+
+QJsonObject params(std::initializer_list<std::pair<const char*, QJsonValue>> values)
+{
+    QJsonObject object;
+    for (const auto& value : values) object[value.first] = value.second;
+    return object;
+}
+
+// 任务队列节点池的堆分配次数和入队次数，前后两次采样的差值之比即这段时间每个任务的分配次数
+struct AllocationSample
+{
+    quint64 allocations = 0;
+    quint64 enqueued = 0;
+};
+
+template <typename Pool>
+AllocationSample sampleAllocations(const Pool& pool)
+{
+    AllocationSample sample;
+    sample.allocations = pool.getQueueAllocationCount();
+    sample.enqueued = pool.getSubmittedTaskNumber();
+    return sample;
+}
+
+template <typename Pool>
+double allocationsPerTask(const Pool& pool, const AllocationSample& before)
+{
+    AllocationSample after = sampleAllocations(pool);
+    quint64 enqueued = after.enqueued - before.enqueued;
+    return enqueued == 0 ? 0.0 : double(after.allocations - before.allocations) / double(enqueued);
+}
+
+std::vector<int> threadCounts(int maxThreads)
+{
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) counts.push_back(threads);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+/// submit：单次addTask()调用耗时，以及addTasks()按批提交时摊到每个任务的耗时
+void benchSubmit(Reporter& reporter, const Options& options)
+{
+    const int count = options.quick ? 20000 : 200000;
+    const int batch = 1024;
+    const int threads = qMin(2, options.maxThreads);
+    std::vector<qint64> samples;
+    samples.reserve(size_t(count));
+
+    {
+        ThreadPool pool(threads, threads);
+        AllocationSample allocations = sampleAllocations(pool);
+        for (int i = 0; i < count; ++i) {
+            Task task = emptyTask(pool.allocateTaskIds(1));
+            qint64 start = nowNs();
+            pool.addTask(std::move(task));
+            samples.push_back(nowNs() - start);
+            if ((i & 1023) == 0) QCoreApplication::processEvents();
+        }
+        waitFinished(pool, quint64(count));
+        reporter.addLatency("submit.addTask", params({{"backend", "qt"}, {"threads", threads}}), samples,
+                           allocationsPerTask(pool, allocations));
+
+        samples.clear();
+        allocations = sampleAllocations(pool);
+        int batched = 0;
+        for (; batched < count; batched += batch) {
+            int firstId = pool.allocateTaskIds(batch);
+            std::vector<Task> tasks;
+            tasks.reserve(size_t(batch));
+            for (int i = 0; i < batch; ++i) tasks.push_back(emptyTask(firstId + i));
+            qint64 start = nowNs();
+            pool.addTasks(std::move(tasks));
+            samples.push_back((nowNs() - start) / batch);
+            QCoreApplication::processEvents();
+        }
+        waitFinished(pool, quint64(count + batched));
+        reporter.addLatency("submit.addTasks.perTask", params({{"backend", "qt"}, {"threads", threads}, {"batch", batch}}), samples,
+                           allocationsPerTask(pool, allocations));
+    }
+
+    samples.clear();
+    {
+        StdThreadPool pool(threads, threads);
+        AllocationSample allocations = sampleAllocations(pool);
+        for (int i = 0; i < count; ++i) {
+            Task task = emptyTask(pool.allocateTaskIds(1));
+            qint64 start = nowNs();
+            pool.addTask(std::move(task));
+            samples.push_back(nowNs() - start);
+        }
+        pool.waitForDone();
+        reporter.addLatency("submit.addTask", params({{"backend", "std"}, {"threads", threads}}), samples,
+                           allocationsPerTask(pool, allocations));
+
+        samples.clear();
+        allocations = sampleAllocations(pool);
+        for (int submitted = 0; submitted < count; submitted += batch) {
+            int firstId = pool.allocateTaskIds(batch);
+            std::vector<Task> tasks;
+            tasks.reserve(size_t(batch));
+            for (int i = 0; i < batch; ++i) tasks.push_back(emptyTask(firstId + i));
+            qint64 start = nowNs();
+            pool.addTasks(std::move(tasks));
+            samples.push_back((nowNs() - start) / batch);
+        }
+        pool.waitForDone();
+        reporter.addLatency("submit.addTasks.perTask", params({{"backend", "std"}, {"threads", threads}, {"batch", batch}}), samples,
+                           allocationsPerTask(pool, allocations));
+    }
+}
+
+/// dispatch：空闲线程池里提交一个任务到它开始执行的时间（入队+唤醒+取任务），逐个串行测
+void benchDispatch(Reporter& reporter, const Options& options)
+{
+    const int count = options.quick ? 500 : 5000;
+    std::vector<qint64> samples;
+    samples.reserve(size_t(count));
+
+    {
+        ThreadPool pool(1, 1);
+        auto subscription = pool.subscribeEvents();
+        for (int i = 0; i < count; ++i) {
+            int id = pool.allocateTaskIds(1);
+            qint64 start = nowNs();
+            pool.addTask(emptyTask(id));
+            // 事件队列是无锁的，忙等取到本任务的TaskDispatched即为开始时刻
+            bool dispatched = false;
+            bool finished = false;
+            PoolEvent event;
+            while (!finished) {
+                while (subscription->pop(event)) {
+                    if (event.taskId != id) continue;
+                    if (event.type == PoolEventType::TaskDispatched && !dispatched) {
+                        samples.push_back(nowNs() - start);
+                        dispatched = true;
+                    } else if (event.type == PoolEventType::TaskFinished) {
+                        finished = true;
+                    }
+                }
+                if (subscription->takeOverflowed()) break;
+            }
+            QCoreApplication::processEvents();
+        }
+        pool.unsubscribeEvents(subscription);
+        reporter.addLatency("dispatch.enqueueToStart", params({{"backend", "qt"}, {"threads", 1}}), samples);
+    }
+
+    samples.clear();
+    {
+        LatencyObserver observer;
+        StdThreadPool pool(1, 1, &observer);
+        for (int i = 0; i < count; ++i) {
+            int id = pool.allocateTaskIds(1);
+            qint64 start = nowNs();
+            pool.addTask(emptyTask(id));
+            while (observer.startedId.load(std::memory_order_acquire) != id) {}
+            samples.push_back(observer.startedNs.load(std::memory_order_relaxed) - start);
+            while (observer.finishedId.load(std::memory_order_acquire) != id) {}
+        }
+        reporter.addLatency("dispatch.enqueueToStart", params({{"backend", "std"}, {"threads", 1}}), samples);
+    }
+}
+
+/// throughput：一次提交大量空任务，1~N个线程下的完成吞吐
+void benchThroughput(Reporter& reporter, const Options& options)
+{
+    const int count = options.quick ? 20000 : 200000;
+    const int batch = 4096;
+
+    for (int threads : threadCounts(options.maxThreads)) {
+        {
+            ThreadPool pool(threads, threads);
+            int firstId = pool.allocateTaskIds(count);
+            AllocationSample allocations = sampleAllocations(pool);
+            qint64 start = nowNs();
+            for (int submitted = 0; submitted < count; submitted += batch) {
+                int size = qMin(batch, count - submitted);
+                std::vector<Task> tasks;
+                tasks.reserve(size_t(size));
+                for (int i = 0; i < size; ++i) tasks.push_back(emptyTask(firstId + submitted + i));
+                pool.addTasks(std::move(tasks));
+            }
+            bool done = waitFinished(pool, quint64(count));
+            double seconds = double(nowNs() - start) / 1e9;
+            if (!done) fprintf(stderr, "poolbench: qt backend timed out at %d threads\n", threads);
+            reporter.addValue("throughput.emptyTasks", params({{"backend", "qt"}, {"threads", threads}, {"tasks", count}}),
+                              "tasks/s", done ? count / seconds : 0.0, allocationsPerTask(pool, allocations));
+        }
+        {
+            StdThreadPool pool(threads, threads);
+            int firstId = pool.allocateTaskIds(count);
+            AllocationSample allocations = sampleAllocations(pool);
+            qint64 start = nowNs();
+            for (int submitted = 0; submitted < count; submitted += batch) {
+                int size = qMin(batch, count - submitted);
+                std::vector<Task> tasks;
+                tasks.reserve(size_t(size));
+                for (int i = 0; i < size; ++i) tasks.push_back(emptyTask(firstId + submitted + i));
+                pool.addTasks(std::move(tasks));
+            }
+            pool.waitForDone();
+            double seconds = double(nowNs() - start) / 1e9;
+            reporter.addValue("throughput.emptyTasks", params({{"backend", "std"}, {"threads", threads}, {"tasks", count}}),
+                              "tasks/s", count / seconds, allocationsPerTask(pool, allocations));
+        }
+    }
+}
+
+/// workload：每种参考负载在1、2、4…N个线程下的吞吐和并行效率
+void benchWorkloads(Reporter& reporter, const Options& options)
+{
+    const int taskMs = options.quick ? 5 : 20;
+    const int tasksPerThread = options.quick ? 10 : 50;
+    ReferenceWorkloads::calibrate();
+    for (int i = int(TaskKind::MatMul); i < ReferenceWorkloads::KIND_COUNT; ++i) {
+        TaskKind kind = static_cast<TaskKind>(i);
+        QString name = QString("workload.") + taskKindName(kind);
+        for (int threads : threadCounts(options.maxThreads)) {
+            const int count = tasksPerThread * threads;
+            StdThreadPool pool(threads, threads);
+            int firstId = pool.allocateTaskIds(count);
+            std::vector<Task> tasks;
+            tasks.reserve(size_t(count));
+            for (int t = 0; t < count; ++t) {
+                Task task = emptyTask(firstId + t);
+                task.totalTimeMs = taskMs;
+                task.kind = kind;
+                tasks.push_back(std::move(task));
+            }
+            qint64 start = nowNs();
+            pool.addTasks(std::move(tasks));
+            pool.waitForDone();
+            double seconds = double(nowNs() - start) / 1e9;
+            double rate = count / seconds;
+            double ideal = threads * 1000.0 / taskMs;
+            reporter.addValue(name, params({{"threads", threads}, {"taskMs", taskMs}}), "tasks/s", rate);
+            reporter.addValue(name + ".efficiency", params({{"threads", threads}, {"taskMs", taskMs}}), "%", rate / ideal * 100.0);
+        }
+    }
+}
+
+std::atomic<quint64> g_spinSink{0};
+
+// 下标i的工作量（LCG迭代次数）：uniform各下标相同；skewed随i线性增长，最后一段约为平均的2倍；
+// spiky每100个下标有1个重100倍
+qint64 loopWork(const char* profile, qint64 i, qint64 n)
+{
+    const qint64 base = 200;
+    if (strcmp(profile, "skewed") == 0) return base * 2 * i / n + 1;
+    if (strcmp(profile, "spiky") == 0) return (i * 2654435761u) % 100 == 0 ? base * 100 : base;
+    return base;
+}
+
+void spinRange(const char* profile, qint64 begin, qint64 end, qint64 n)
+{
+    quint64 x = quint64(begin);
+    for (qint64 i = begin; i < end; ++i) {
+        for (qint64 k = loopWork(profile, i, n); k > 0; --k) x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    g_spinSink.fetch_add(x, std::memory_order_relaxed);
+}
+
+// 手工静态分块：每块一个任务，调用线程只等不干
+struct StaticChunk
+{
+    const char* profile;
+    qint64 begin;
+    qint64 end;
+    qint64 n;
+    std::atomic<int>* remaining;
+};
+
+void runStaticChunk(void* arg)
+{
+    StaticChunk* chunk = static_cast<StaticChunk*>(arg);
+    spinRange(chunk->profile, chunk->begin, chunk->end, chunk->n);
+    chunk->remaining->fetch_sub(1, std::memory_order_release);
+}
+
+template <typename Pool>
+qint64 runStaticChunks(Pool& pool, const char* profile, qint64 n, int chunks)
+{
+    std::atomic<int> remaining{chunks};
+    std::vector<StaticChunk> ranges(static_cast<size_t>(chunks));
+    int firstId = pool.allocateTaskIds(chunks);
+    qint64 start = nowNs();
+    std::vector<Task> tasks;
+    for (int c = 0; c < chunks; ++c) {
+        ranges[size_t(c)] = StaticChunk{profile, n * c / chunks, n * (c + 1) / chunks, n, &remaining};
+        Task task = emptyTask(firstId + c);
+        task.function = &runStaticChunk;
+        task.arg = &ranges[size_t(c)];
+        tasks.push_back(std::move(task));
+    }
+    pool.addTasks(std::move(tasks));
+    while (remaining.load(std::memory_order_acquire) > 0) QThread::yieldCurrentThread();
+    return nowNs() - start;
+}
+
+template <typename Pool>
+void benchParallelOn(Reporter& reporter, const Options& options, const char* backend, Pool& pool, int threads)
+{
+    const qint64 n = options.quick ? 1 << 14 : 1 << 16;
+    const int rounds = options.quick ? 3 : 10;
+    const qint64 grain = 64;
+    for (const char* profile : {"uniform", "skewed", "spiky"}) {
+        std::vector<qint64> staticNs;
+        std::vector<qint64> lazyNs;
+        for (int round = 0; round < rounds; ++round) {
+            staticNs.push_back(runStaticChunks(pool, profile, n, threads));
+            qint64 start = nowNs();
+            pool.parallelFor(0, n, grain, [profile, n](qint64 begin, qint64 end) { spinRange(profile, begin, end, n); });
+            lazyNs.push_back(nowNs() - start);
+            QCoreApplication::processEvents();
+        }
+        reporter.addLatency("parallel.staticChunks", params({{"backend", backend}, {"threads", threads}, {"profile", profile}}), staticNs);
+        reporter.addLatency("parallel.parallelFor", params({{"backend", backend}, {"threads", threads}, {"profile", profile}, {"grain", grain}}), lazyNs);
+    }
+}
+
+/// parallel：不均匀循环上静态分块与parallelFor（懒惰二分）的总耗时
+void benchParallel(Reporter& reporter, const Options& options)
+{
+    for (int threads : threadCounts(options.maxThreads)) {
+        {
+            ThreadPool pool(threads, threads);
+            benchParallelOn(reporter, options, "qt", pool, threads);
+        }
+        {
+            StdThreadPool pool(threads, threads);
+            benchParallelOn(reporter, options, "std", pool, threads);
+        }
+    }
+}
+
+/// scheduler：不经过线程池，直接测各调度器在队列长度L下的整队排序和一次入队+出队
+void benchSchedulers(Reporter& reporter, const Options& options)
+{
+    static const qint64 OP_BUDGET_NS = 300 * 1000000LL;    // 每种组合最多测这么久（HRRN每次入队都整队排序）
+    static const int MIN_SAMPLES = 3;
+    const int maxLength = options.quick ? 100000 : 1000000;
+    const int ops = options.quick ? 200 : 1000;
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> runTime(1, 1000);
+    std::uniform_int_distribution<int> priority(1, 10);
+    std::uniform_int_distribution<int> age(0, 10000);
+    auto randomTask = [&](int id, int nowMs) {
+        Task task;
+        task.id = id;
+        task.totalTimeMs = runTime(random);
+        task.priority = priority(random);
+        task.arrivalTimestampMs = nowMs - age(random);
+        return task;
+    };
+
+    for (int policy = int(SchedulePolicy::FIFO); policy <= int(SchedulePolicy::HRRN); ++policy) {
+        const char* policyName = schedulePolicyName(static_cast<SchedulePolicy>(policy));
+        for (int length = 10; length <= maxLength; length *= 10) {
+            std::unique_ptr<TaskScheduler> scheduler(createScheduler(static_cast<SchedulePolicy>(policy)));
+            TaskNodePool nodes;
+            TaskList queue;
+            int nowMs = currentTimeOfDayMs();
+            int nextId = 1;
+            for (int i = 0; i < length; ++i) queue.pushBack(nodes.acquire(randomTask(nextId++, nowMs)));
+
+            std::vector<qint64> samples;
+            qint64 budgetEnd = nowNs() + OP_BUDGET_NS;
+            for (int i = 0; i < ops && (i < MIN_SAMPLES || nowNs() < budgetEnd); ++i) {
+                qint64 start = nowNs();
+                scheduler->sortQueue(queue);
+                samples.push_back(nowNs() - start);
+            }
+            reporter.addLatency("scheduler.sortQueue", params({{"policy", policyName}, {"length", length}}), samples);
+
+            // 稳态：入队一个、出队一个，队列长度保持L
+            samples.clear();
+            budgetEnd = nowNs() + OP_BUDGET_NS;
+            for (int i = 0; i < ops && (i < MIN_SAMPLES || nowNs() < budgetEnd); ++i) {
+                TaskNode* node = nodes.acquire(randomTask(nextId++, nowMs));
+                qint64 start = nowNs();
+                scheduler->insertByPolicy(queue, node);
+                TaskNode* first = queue.takeFirst();
+                samples.push_back(nowNs() - start);
+                nodes.release(first);
+            }
+            reporter.addLatency("scheduler.insertTake", params({{"policy", policyName}, {"length", length}}), samples);
+
+            while (TaskNode* node = queue.takeFirst()) nodes.release(node);
+        }
+    }
+}
+
+/// visual：线程全忙、队列里有L个任务时，UI读取快照的耗时（整个过程持有ThreadPool::m_lock，即锁持有时间）
+void benchVisualInfo(Reporter& reporter, const Options& options)
+{
+    const int threads = qMin(4, options.maxThreads);
+    const int calls = options.quick ? 100 : 500;
+    std::vector<int> lengths = options.quick ? std::vector<int>{100, 1000} : std::vector<int>{100, 1000, 10000};
+
+    for (int length : lengths) {
+        ThreadPool pool(threads, threads);
+        int firstId = pool.allocateTaskIds(length + threads);
+        std::vector<Task> tasks;
+        tasks.reserve(size_t(length + threads));
+        for (int i = 0; i < length + threads; ++i) {
+            Task task = emptyTask(firstId + i);
+            // 任务足够长，测量期间队列基本不动；执行中的任务每STEP_TIME_MS更新进度，与读取方争锁
+            task.totalTimeMs = 1000;
+            tasks.push_back(std::move(task));
+        }
+        pool.addTasks(std::move(tasks));
+        while (pool.getBusyNumber() < threads) QThread::yieldCurrentThread();
+
+        std::vector<qint64> threadSamples;
+        std::vector<qint64> taskSamples;
+        for (int i = 0; i < calls; ++i) {
+            qint64 start = nowNs();
+            QList<ThreadVisualInfo> threadInfo = pool.getThreadVisualInfo();
+            qint64 middle = nowNs();
+            QList<TaskVisualInfo> taskInfo = pool.getWaitingTaskVisualInfo();
+            taskSamples.push_back(nowNs() - middle);
+            threadSamples.push_back(middle - start);
+            if ((i & 15) == 0) QCoreApplication::processEvents();
+        }
+        reporter.addLatency("visual.getThreadVisualInfo", params({{"threads", threads}, {"queued", length}}), threadSamples);
+        reporter.addLatency("visual.getWaitingTaskVisualInfo", params({{"threads", threads}, {"queued", length}}), taskSamples);
+        // 析构时丢弃排队任务，只等正在执行的任务（至多1秒）
+    }
+}
+
+QJsonArray lockReport()
+{
+    QJsonArray locks;
+    for (const LockSiteStats& site : LockProfiler::instance().snapshot()) {
+        QJsonObject entry;
+        entry["lock"] = site.lockName;
+        entry["site"] = site.site;
+        entry["acquisitions"] = qint64(site.acquisitions);
+        entry["contended"] = qint64(site.contended);
+        entry["totalHoldNs"] = qint64(site.totalHoldNs);
+        entry["maxHoldNs"] = qint64(site.maxHoldNs);
+        entry["meanHoldNs"] = site.acquisitions > 0 ? double(site.totalHoldNs) / double(site.acquisitions) : 0.0;
+        entry["totalWaitNs"] = qint64(site.totalWaitNs);
+        entry["maxWaitNs"] = qint64(site.maxWaitNs);
+        locks.append(entry);
+    }
+    return locks;
+}
+
+bool parseOptions(const QStringList& args, Options& options)
+{
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        if (arg == "--quick") {
+            options.quick = true;
+            continue;
+        }
+        if (i + 1 >= args.size()) return false;
+        const QString value = args[++i];
+        bool ok = true;
+        if (arg == "--json") options.jsonFile = value;
+        else if (arg == "--baseline") options.baselineFile = value;
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--max-threads") options.maxThreads = value.toInt(&ok);
+        else return false;
+        if (!ok) return false;
+    }
+    return options.maxThreads >= 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Options options;
+    if (!parseOptions(app.arguments().mid(1), options)) {
+        fprintf(stderr, "usage: poolbench [--json FILE] [--baseline FILE] [--filter submit|dispatch|throughput|workload|parallel|scheduler|visual]\n"
+                        "                 [--max-threads N] [--quick]\n");
+        return 2;
+    }
+
+    QJsonObject baseline;
+    if (!options.baselineFile.isEmpty()) {
+        QFile file(options.baselineFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "poolbench: cannot read %s\n", qPrintable(options.baselineFile));
+            return 1;
+        }
+        baseline = QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    // 线程池日志只保留警告和错误，走stderr
+    PoolLogger& logger = PoolLogger::instance();
+    logger.setMinLevel(LogLevel::Warning);
+    QObject::connect(&logger, &PoolLogger::linesReady, [](const QStringList& lines) {
+        for (const QString& line : lines) fprintf(stderr, "%s\n", qPrintable(line));
+    });
+    logger.start();
+
+    Reporter reporter;
+    LockProfiler::instance().reset();
+    struct Group { const char* name; void (*run)(Reporter&, const Options&); };
+    const Group groups[] = {
+        {"submit", benchSubmit},
+        {"dispatch", benchDispatch},
+        {"throughput", benchThroughput},
+        {"workload", benchWorkloads},
+        {"parallel", benchParallel},
+        {"scheduler", benchSchedulers},
+        {"visual", benchVisualInfo},
+    };
+    for (const Group& group : groups) {
+        if (!options.filter.isEmpty() && !QString(group.name).contains(options.filter)) continue;
+        group.run(reporter, options);
+    }
+    if (LockProfiler::enabled()) reporter.setLocks(lockReport());
+
+    QByteArray json = QJsonDocument(reporter.document(options)).toJson(QJsonDocument::Indented);
+    if (options.jsonFile.isEmpty()) {
+        fwrite(json.constData(), 1, size_t(json.size()), stdout);
+    } else {
+        QFile file(options.jsonFile);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            fprintf(stderr, "poolbench: cannot write %s\n", qPrintable(options.jsonFile));
+            logger.stop();
+            return 1;
+        }
+    }
+    if (!baseline.isEmpty()) reporter.compare(baseline);
+    logger.stop();
+    return 0;
+}
@@ -0,0 +1,15 @@
+# 线程池微基准：提交、派发、完成路径和各调度器随队列长度的扩展性，结果输出为JSON便于对比
+QT       -= gui
+
+CONFIG += console c++17
+include($$PWD/../../warnings.pri)
+CONFIG -= app_bundle
+CONFIG += release
+
+# 打开后额外输出每个加锁调用点的持有/等待时间（统计本身有开销，测吞吐时建议关闭）
+#DEFINES += POOL_LOCK_PROFILING
+
+include(../../threadpoolcore.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,664 @@
+#include "threadpool.h"
+#include "stdthreadpool.h"
+#include "workloadtrace.h"
+#include "loadgenerator.h"
+#include "poollog.h"
+#include "pooltrace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QThread>
+#include <QTime>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+/*
+ * 用法：poolcli [选项]
+ *   --backend B          线程池实现：qt（ThreadPool，默认）或std（core/StdThreadPool）
+ *   --min N              最小线程数（默认2）
+ *   --max N              最大线程数（默认CPU核数）
+ *   --policy P           调度策略，名字或编号：FIFO LIFO SJF LJF PRIO HRRN（默认FIFO）
+ *   --tasks N            任务总数（默认1000）
+ *   --rate R             每秒提交的任务数（默认0，开始时一次提交全部）
+ *   --duration S         最多提交S秒（与--rate配合，默认0不限）
+ *   --task-ms MIN:MAX    每个任务的执行时间范围（默认20:200）
+ *   --priority-max P     优先级在1~P之间随机（默认10）
+ *   --mem BYTES          每个任务的载荷大小（默认0）
+ *   --mem-budget BYTES   线程池内存预算（默认0不限）
+ *   --kind-mix M         任务类型及权重（见core/referenceworkloads.h），如matmul:1,chase:1；默认全部为sleep。
+ *                        非sleep的任务按校准结果做约--task-ms（或--service）毫秒的真实计算/访存
+ *   --timeout S          提交结束后最多再等S秒（默认0一直等）
+ *   --verbose            线程池日志输出到stderr（默认只输出警告和错误）
+ *   --record FILE        把提交的任务记录为负载轨迹（格式见core/workloadtrace.h）
+ *   --replay FILE        按轨迹重放：到达间隔、执行时间、优先级、载荷大小和批次都取自轨迹，
+ *                        忽略--tasks/--rate/--task-ms/--priority-max/--mem
+ *   --speed X            重放加速倍数（默认1，2表示到达间隔减半）
+ *   --loop N             轨迹重放N遍（默认1），每遍接在上一遍之后
+ *   --arrival A          改由core/LoadGenerator的生产者线程开环提交（与--replay互斥），到达过程：
+ *                        uniform | poisson | onoff:ON_MS:OFF_MS | diurnal:PERIOD_S:AMPLITUDE，速率取--rate
+ *   --service S          执行时间分布（默认取--task-ms的均匀分布）：
+ *                        fixed:MS | uniform:MIN:MAX | exp:MEAN | lognormal:MEDIAN:SIGMA | bimodal:SHORT:LONG:P_LONG
+ *   --priority-mix M     优先级及权重，如1:70,5:20,10:10（默认1~--priority-max等概率）
+ *   --producers N        生产者线程数（默认1），每个分到rate/N
+ *   --seed S             生成器的随机种子（默认1）
+ *   给出后四项中任一项也会启用生成器，到达过程默认poisson。
+ * 跑完输出提交/完成吞吐量，以及排队等待和端到端延迟的p50/p90/p99/max。
+ * 两种后端负载和统计口径相同：qt后端从事件流取开始/完成时刻，std后端在PoolObserver回调里直接记录，
+ * 同一组参数分别用两种后端各跑一次即可对比。两者是同一个引擎（StdThreadPool），差别就是Qt层（事件、信号、可视化状态）的开销。
+ * 重放时另输出实际提交时刻相对轨迹时刻的延后（late），衡量重放本身的时间精度（约为SUBMIT_INTERVAL_MS）。
+ * 生成器模式下等待和延迟都从计划到达时刻算起（生产者落后时，落后的时间也计入延迟），late为实际提交相对计划的延后。
+ * 环境变量THREADPOOL_LOG_FILE、THREADPOOL_TRACE_FILE与GUI程序含义相同。
+ */
+
+namespace {
+
+enum class Backend { Qt, Std };
+
+struct Options
+{
+    Backend backend = Backend::Qt;
+    int minThreads = 2;
+    int maxThreads = qMax(2, QThread::idealThreadCount());
+    SchedulePolicy policy = SchedulePolicy::FIFO;
+    qint64 tasks = 1000;
+    double rate = 0.0;
+    double durationS = 0.0;
+    int taskMsMin = 20;
+    int taskMsMax = 200;
+    int priorityMax = 10;
+    quint32 mem = 0;
+    qint64 memoryBudget = 0;
+    int timeoutS = 0;
+    bool verbose = false;
+    QString recordFile;
+    QString replayFile;
+    double speed = 1.0;
+    int loops = 1;
+    bool generator = false;
+    LoadSpec load;                      // load.kinds在两种提交方式下都生效
+    bool serviceSet = false;
+};
+
+// 单线程驱动：提交和统计都在主线程的事件循环里（std后端的开始/完成时刻由工作线程在回调里写入）
+class CliRunner : private PoolObserver
+{
+public:
+    static const int SUBMIT_INTERVAL_MS = 1;
+    static const int DRAIN_INTERVAL_MS = 1;     // 延迟在排空事件时计时，误差约为这个间隔
+    static const int MAX_BATCH = 4096;
+    static const size_t EVENT_QUEUE_CAPACITY = 1 << 16;
+
+    explicit CliRunner(const Options& options) : m_options(options) {}
+
+    void start();
+    int exitCode() const { return m_exitCode; }
+
+private:
+    void submitDue();
+    void submitReplayDue(qint64 nowNs);
+    void startGenerator();
+    // 在生产者线程上调用
+    void submitGenerated(int producer, std::vector<Task>& tasks, const std::vector<int64_t>& dueNs);
+    bool loadReplay();
+    // 重放的第index个任务（跨遍连续编号）应在何时提交
+    qint64 replayDueNs(qint64 index) const;
+    void drainEvents();
+    void finish(bool timedOut);
+    void printSummary(qint64 totalNs);
+    const PoolCounters& counters() const;
+    TaskKind nextKind();
+    void calibrateIfNeeded();
+
+    // PoolObserver（std后端），每个任务ID只会被一个工作线程写一次
+    void onTaskStarted(int threadId, const Task& task) override;
+    void onTaskFinished(int threadId, const Task& task, int64_t wallNs, int64_t cpuNs) override;
+
+    const Options& m_options;
+    std::unique_ptr<ThreadPool> m_pool;
+    std::vector<qint64> m_dispatchNs;   // std后端：以任务ID为下标，线程池销毁后再汇总
+    std::vector<qint64> m_finishNs;
+    std::atomic<qint64> m_taskWallNs{0};
+    std::atomic<qint64> m_taskCpuNs{0};
+    std::shared_ptr<PoolEventSubscription> m_subscription;
+    QTimer m_submitTimer;
+    QTimer m_drainTimer;
+    QElapsedTimer m_clock;
+
+    qint64 m_target = 0;                // 提交目标，--duration到期时截断为已提交数
+    qint64 m_submitted = 0;
+    qint64 m_finished = 0;
+    qint64 m_submitDoneNs = -1;
+    std::vector<qint64> m_submitNs;     // 以任务ID为下标
+    std::vector<qint64> m_waitNs;
+    std::vector<qint64> m_latencyNs;
+    bool m_eventsLost = false;
+    int m_exitCode = 0;
+    std::vector<TraceRecord> m_trace;
+    qint64 m_loopUs = 0;                // 每遍的时长
+    std::vector<qint64> m_lateNs;
+    std::vector<std::vector<qint64>> m_producerLateNs;     // 每个生产者一份，结束时并入m_lateNs
+    qint64 m_generatorBaseNs = 0;       // 生成器startTime()对应的m_clock读数
+    std::mt19937 m_kindRandom;
+    std::discrete_distribution<size_t> m_kindPick;
+    bool m_calibrated = false;
+    std::unique_ptr<StdThreadPool> m_stdPool;   // 回调用到的成员都在它之前声明，析构时仍有效
+    std::unique_ptr<LoadGenerator> m_generator; // 最后声明、最先析构：生产者线程要用到线程池
+};
+
+bool CliRunner::loadReplay()
+{
+    std::string error;
+    bool truncated = false;
+    if (!WorkloadTraceReader::load(m_options.replayFile.toStdString(), m_trace, &error, &truncated)) {
+        fprintf(stderr, "poolcli: %s: %s\n", qPrintable(m_options.replayFile), error.c_str());
+        return false;
+    }
+    if (m_trace.empty()) {
+        fprintf(stderr, "poolcli: %s: trace is empty\n", qPrintable(m_options.replayFile));
+        return false;
+    }
+    if (truncated) fprintf(stderr, "poolcli: %s: last record truncated, ignored\n", qPrintable(m_options.replayFile));
+    // 下一遍接在最后一个任务之后，间隔取平均到达间隔
+    qint64 lastUs = m_trace.back().arrivalUs;
+    qint64 gapUs = m_trace.size() > 1 ? lastUs / qint64(m_trace.size() - 1) : 0;
+    m_loopUs = lastUs + qMax<qint64>(gapUs, 1);
+    m_target = qint64(m_trace.size()) * m_options.loops;
+    return true;
+}
+
+qint64 CliRunner::replayDueNs(qint64 index) const
+{
+    qint64 loop = index / qint64(m_trace.size());
+    const TraceRecord& record = m_trace[size_t(index % qint64(m_trace.size()))];
+    return qint64(double(loop * m_loopUs + record.arrivalUs) * 1000.0 / m_options.speed);
+}
+
+void CliRunner::start()
+{
+    m_target = m_options.tasks;
+    if (!m_options.replayFile.isEmpty()) {
+        if (!loadReplay() || m_target >= INT_MAX) {
+            m_exitCode = 2;
+            QCoreApplication::quit();
+            return;
+        }
+        m_lateNs.reserve(size_t(m_target));
+    }
+    calibrateIfNeeded();
+    m_submitNs.resize(size_t(m_target) + 1, -1);
+    m_waitNs.reserve(size_t(m_target));
+    m_latencyNs.reserve(size_t(m_target));
+
+    if (m_options.backend == Backend::Std) {
+        m_dispatchNs.resize(size_t(m_target) + 1, -1);
+        m_finishNs.resize(size_t(m_target) + 1, -1);
+        m_stdPool = std::make_unique<StdThreadPool>(m_options.minThreads, m_options.maxThreads, static_cast<PoolObserver*>(this),
+                                                    [](void* ptr, size_t) { free(ptr); });
+        m_stdPool->setSchedulePolicy(m_options.policy);
+        m_stdPool->setMemoryBudget(size_t(m_options.memoryBudget));
+        if (!m_options.recordFile.isEmpty() && !m_stdPool->startWorkloadRecording(m_options.recordFile.toStdString())) {
+            fprintf(stderr, "poolcli: cannot record to %s\n", qPrintable(m_options.recordFile));
+        }
+    } else {
+        m_pool = std::make_unique<ThreadPool>(m_options.minThreads, m_options.maxThreads);
+        m_pool->setSchedulePolicy(m_options.policy);
+        m_pool->setMemoryBudget(size_t(m_options.memoryBudget));
+        m_subscription = m_pool->subscribeEvents(EVENT_QUEUE_CAPACITY);
+        if (!m_options.recordFile.isEmpty() && !m_pool->startWorkloadRecording(m_options.recordFile)) {
+            fprintf(stderr, "poolcli: cannot record to %s\n", qPrintable(m_options.recordFile));
+        }
+    }
+
+    m_clock.start();
+    if (m_options.generator) startGenerator();
+    m_submitTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&m_submitTimer, &QTimer::timeout, [this]() { submitDue(); });
+    m_submitTimer.start(SUBMIT_INTERVAL_MS);
+    m_drainTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&m_drainTimer, &QTimer::timeout, [this]() { drainEvents(); });
+    m_drainTimer.start(DRAIN_INTERVAL_MS);
+    submitDue();
+}
+
+// 参考负载按单线程的速度折算工作量，要在线程池开始干活之前校准
+void CliRunner::calibrateIfNeeded()
+{
+    std::vector<double> weights;
+    for (const TaskKindWeight& entry : m_options.load.kinds) {
+        weights.push_back(entry.weight);
+        if (entry.kind != TaskKind::Sleep) m_calibrated = true;
+    }
+    m_kindRandom.seed(unsigned(m_options.load.seed));
+    m_kindPick = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+    for (const TraceRecord& record : m_trace) {
+        if (record.kind != uint8_t(TaskKind::Sleep)) m_calibrated = true;
+    }
+    if (!m_calibrated) return;
+    QElapsedTimer timer;
+    timer.start();
+    ReferenceWorkloads::calibrate();
+    fprintf(stderr, "poolcli: calibrated reference workloads in %lld ms\n", timer.elapsed());
+}
+
+TaskKind CliRunner::nextKind()
+{
+    const std::vector<TaskKindWeight>& kinds = m_options.load.kinds;
+    if (kinds.empty()) return TaskKind::Sleep;
+    return kinds.size() == 1 ? kinds[0].kind : kinds[m_kindPick(m_kindRandom)].kind;
+}
+
+void CliRunner::startGenerator()
+{
+    LoadSpec spec = m_options.load;
+    spec.tasks = m_target;
+    spec.durationS = m_options.durationS;
+    spec.memSize = m_options.mem;
+    spec.maxBatch = MAX_BATCH;
+    m_producerLateNs.resize(size_t(spec.producers));
+    m_generator = std::make_unique<LoadGenerator>(spec, [this](int producer, std::vector<Task>& tasks, const std::vector<int64_t>& dueNs) {
+        submitGenerated(producer, tasks, dueNs);
+    });
+    // 两个时钟的起点相差不到1us，忽略
+    m_generatorBaseNs = m_clock.nsecsElapsed();
+    m_generator->start();
+}
+
+void CliRunner::submitGenerated(int producer, std::vector<Task>& tasks, const std::vector<int64_t>& dueNs)
+{
+    int count = int(tasks.size());
+    int firstId = m_stdPool ? m_stdPool->allocateTaskIds(count) : m_pool->allocateTaskIds(count);
+    int arrivalMs = QTime::currentTime().msecsSinceStartOfDay();
+    for (int i = 0; i < count; ++i) {
+        Task& task = tasks[size_t(i)];
+        task.id = firstId + i;
+        if (task.memSize > 0) task.memPtr = m_stdPool ? malloc(task.memSize) : m_pool->allocatePayload(task.memSize);
+        task.arrivalTimestampMs = arrivalMs;
+    }
+    // 各生产者的ID区间互不重叠，m_submitNs已按总任务数预先分配，这里只写不扩容
+    qint64 submitNs = m_clock.nsecsElapsed();
+    std::vector<qint64>& lateNs = m_producerLateNs[size_t(producer)];
+    for (int i = 0; i < count; ++i) {
+        qint64 dueClockNs = m_generatorBaseNs + dueNs[size_t(i)];
+        m_submitNs[size_t(firstId + i)] = dueClockNs;
+        lateNs.push_back(submitNs - dueClockNs);
+    }
+    if (m_stdPool) m_stdPool->addTasks(std::move(tasks));
+    else m_pool->addTasks(std::move(tasks));
+}
+
+void CliRunner::submitDue()
+{
+    if (m_submitDoneNs >= 0) return;
+    if (m_generator) {
+        // 提交由生产者线程完成，这里只跟踪进度
+        bool done = m_generator->isFinished();
+        m_submitted = m_generator->generatedCount();
+        if (done) {
+            m_submitDoneNs = m_clock.nsecsElapsed();
+            m_submitTimer.stop();
+        }
+        return;
+    }
+    qint64 nowNs = m_clock.nsecsElapsed();
+    if (m_options.durationS > 0 && nowNs >= qint64(m_options.durationS * 1e9)) {
+        m_target = m_submitted;
+    }
+    qint64 due = m_target;
+    if (!m_trace.empty()) {
+        submitReplayDue(nowNs);
+        due = m_submitted;
+    } else if (m_options.rate > 0) {
+        due = qMin(m_target, qint64(nowNs / 1e9 * m_options.rate) + 1);
+    }
+    QRandomGenerator* random = QRandomGenerator::global();
+    while (m_submitted < due) {
+        int count = int(qMin<qint64>(MAX_BATCH, due - m_submitted));
+        int firstId = m_stdPool ? m_stdPool->allocateTaskIds(count) : m_pool->allocateTaskIds(count);
+        int arrivalMs = QTime::currentTime().msecsSinceStartOfDay();
+        std::vector<Task> tasks(static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i) {
+            Task& task = tasks[size_t(i)];
+            task.id = firstId + i;
+            task.totalTimeMs = random->bounded(m_options.taskMsMin, m_options.taskMsMax + 1);
+            task.priority = random->bounded(1, m_options.priorityMax + 1);
+            task.kind = nextKind();
+            task.memSize = m_options.mem;
+            if (task.memSize > 0) task.memPtr = m_stdPool ? malloc(task.memSize) : m_pool->allocatePayload(task.memSize);
+            task.arrivalTimestampMs = arrivalMs;
+        }
+        // ID由本程序独占分配，从1开始连续
+        qint64 submitNs = m_clock.nsecsElapsed();
+        for (int i = 0; i < count; ++i) m_submitNs[size_t(firstId + i)] = submitNs;
+        if (m_stdPool) m_stdPool->addTasks(std::move(tasks));
+        else m_pool->addTasks(std::move(tasks));
+        m_submitted += count;
+    }
+    if (m_submitted >= m_target) {
+        m_submitDoneNs = m_clock.nsecsElapsed();
+        m_submitTimer.stop();
+    }
+}
+
+void CliRunner::submitReplayDue(qint64 nowNs)
+{
+    const qint64 traceSize = qint64(m_trace.size());
+    while (m_submitted < m_target && replayDueNs(m_submitted) <= nowNs) {
+        // 同一批次（原来的一次addTask/addTasks调用）的任务一起提交
+        qint64 end = m_submitted + 1;
+        const TraceRecord& first = m_trace[size_t(m_submitted % traceSize)];
+        while (end < m_target && end % traceSize != 0 && m_trace[size_t(end % traceSize)].group == first.group) ++end;
+        int count = int(end - m_submitted);
+        int firstId = m_stdPool ? m_stdPool->allocateTaskIds(count) : m_pool->allocateTaskIds(count);
+        int arrivalMs = QTime::currentTime().msecsSinceStartOfDay();
+        std::vector<Task> tasks(static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i) {
+            const TraceRecord& record = m_trace[size_t((m_submitted + i) % traceSize)];
+            Task& task = tasks[size_t(i)];
+            task.id = firstId + i;
+            task.totalTimeMs = record.totalTimeMs;
+            task.priority = record.priority;
+            task.kind = record.kind < ReferenceWorkloads::KIND_COUNT ? static_cast<TaskKind>(record.kind) : TaskKind::Sleep;
+            task.memSize = size_t(record.memSize);
+            if (task.memSize > 0) task.memPtr = m_stdPool ? malloc(task.memSize) : m_pool->allocatePayload(task.memSize);
+            task.arrivalTimestampMs = arrivalMs;
+        }
+        qint64 submitNs = m_clock.nsecsElapsed();
+        for (int i = 0; i < count; ++i) {
+            m_submitNs[size_t(firstId + i)] = submitNs;
+            m_lateNs.push_back(submitNs - replayDueNs(m_submitted + i));
+        }
+        if (count == 1) {
+            if (m_stdPool) m_stdPool->addTask(std::move(tasks[0]));
+            else m_pool->addTask(std::move(tasks[0]));
+        } else {
+            if (m_stdPool) m_stdPool->addTasks(std::move(tasks));
+            else m_pool->addTasks(std::move(tasks));
+        }
+        m_submitted += count;
+    }
+}
+
+void CliRunner::drainEvents()
+{
+    qint64 nowNs = m_clock.nsecsElapsed();
+    PoolEvent event;
+    while (m_subscription && m_subscription->pop(event)) {
+        if (event.taskId <= 0 || size_t(event.taskId) >= m_submitNs.size()) continue;
+        qint64 submitNs = m_submitNs[size_t(event.taskId)];
+        if (event.type == PoolEventType::TaskDispatched) {
+            m_waitNs.push_back(nowNs - submitNs);
+        } else if (event.type == PoolEventType::TaskFinished) {
+            m_latencyNs.push_back(nowNs - submitNs);
+        }
+    }
+    if (m_subscription && m_subscription->takeOverflowed()) m_eventsLost = true;
+
+    // 完成数以计数器为准，事件丢失时也能正确结束
+    m_finished = qint64(counters().finished.load(std::memory_order_relaxed));
+    if (m_submitDoneNs < 0) return;
+    if (m_finished >= m_submitted) {
+        finish(false);
+    } else if (m_options.timeoutS > 0 && nowNs - m_submitDoneNs > qint64(m_options.timeoutS) * 1000000000LL) {
+        finish(true);
+    }
+}
+
+void CliRunner::finish(bool timedOut)
+{
+    qint64 totalNs = m_clock.nsecsElapsed();
+    m_submitTimer.stop();
+    m_drainTimer.stop();
+    if (m_generator) {
+        // 超时结束时生产者可能还在提交，先停下来再动线程池
+        m_generator->stop();
+        m_submitted = m_generator->generatedCount();
+        for (const std::vector<qint64>& lateNs : m_producerLateNs) m_lateNs.insert(m_lateNs.end(), lateNs.begin(), lateNs.end());
+    }
+    if (m_subscription) {
+        m_pool->unsubscribeEvents(m_subscription);
+        m_subscription = nullptr;
+    }
+    if (m_pool) m_pool->stopWorkloadRecording();
+    if (m_stdPool) {
+        m_stdPool->stopWorkloadRecording();
+        // 析构会join所有工作线程，之后回调写入的时刻对本线程可见
+        m_stdPool = nullptr;
+        for (size_t id = 1; id < m_submitNs.size(); ++id) {
+            if (m_dispatchNs[id] >= 0) m_waitNs.push_back(m_dispatchNs[id] - m_submitNs[id]);
+            if (m_finishNs[id] >= 0) m_latencyNs.push_back(m_finishNs[id] - m_submitNs[id]);
+        }
+    }
+    if (timedOut) {
+        fprintf(stderr, "poolcli: timed out, %lld of %lld tasks finished\n", m_finished, m_submitted);
+        m_exitCode = 1;
+    }
+    printSummary(totalNs);
+    // 析构会等待正在执行的任务结束，排队中的任务直接丢弃
+    m_pool = nullptr;
+    QCoreApplication::quit();
+}
+
+const PoolCounters& CliRunner::counters() const
+{
+    return m_stdPool ? m_stdPool->getCounters() : m_pool->getCounters();
+}
+
+void CliRunner::onTaskStarted(int threadId, const Task& task)
+{
+    Q_UNUSED(threadId);
+    m_dispatchNs[size_t(task.id)] = m_clock.nsecsElapsed();
+}
+
+void CliRunner::onTaskFinished(int threadId, const Task& task, int64_t wallNs, int64_t cpuNs)
+{
+    Q_UNUSED(threadId);
+    m_finishNs[size_t(task.id)] = m_clock.nsecsElapsed();
+    m_taskWallNs.fetch_add(wallNs, std::memory_order_relaxed);
+    m_taskCpuNs.fetch_add(cpuNs, std::memory_order_relaxed);
+}
+
+void percentileLine(const char* name, std::vector<qint64>& samples)
+{
+    if (samples.empty()) {
+        printf("%-11s (no samples)\n", name);
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double p) { return samples[size_t(p * double(samples.size() - 1))] / 1e6; };
+    printf("%-11s p50 %.1f  p90 %.1f  p99 %.1f  max %.1f  (n=%zu)\n",
+           name, at(0.50), at(0.90), at(0.99), samples.back() / 1e6, samples.size());
+}
+
+void CliRunner::printSummary(qint64 totalNs)
+{
+    qint64 submitNs = m_submitDoneNs >= 0 ? m_submitDoneNs : totalNs;
+    printf("pool        %s backend  min %d  max %d  policy %s\n", m_options.backend == Backend::Std ? "std" : "qt",
+           m_options.minThreads, m_options.maxThreads, schedulePolicyName(m_options.policy));
+    printf("submitted   %lld tasks in %.3f s (%.0f tasks/s)\n",
+           m_submitted, submitNs / 1e9, m_submitted / qMax(submitNs / 1e9, 1e-9));
+    printf("finished    %lld tasks in %.3f s (%.1f tasks/s)\n",
+           m_finished, totalNs / 1e9, m_finished / qMax(totalNs / 1e9, 1e-9));
+    if (!m_trace.empty()) {
+        printf("replay      %zu records x %d loop(s) at %.2fx, trace span %.3f s\n",
+               m_trace.size(), m_options.loops, m_options.speed, m_loopUs / 1e6);
+        percentileLine("late ms", m_lateNs);
+    }
+    if (m_generator) {
+        printf("generator   %s, %lld batches\n", describeLoadSpec(m_options.load).c_str(), (long long)m_generator->batchCount());
+        percentileLine("late ms", m_lateNs);
+    }
+    if (m_calibrated) {
+        printf("kinds      ");
+        for (int i = int(TaskKind::MatMul); i < ReferenceWorkloads::KIND_COUNT; ++i) {
+            TaskKind kind = static_cast<TaskKind>(i);
+            printf(" %s %.4g %s/ms", taskKindName(kind), ReferenceWorkloads::unitsPerMs(kind), ReferenceWorkloads::unitName(kind));
+        }
+        printf("\n");
+    }
+    percentileLine("wait ms", m_waitNs);
+    percentileLine("latency ms", m_latencyNs);
+    if (m_eventsLost) {
+        printf("note        event queue overflowed, percentiles cover a subset of tasks\n");
+    }
+    if (!m_pool) {
+        // std后端没有线程级CPU统计，只有任务执行期间的CPU时间
+        qint64 wallNs = m_taskWallNs.load(std::memory_order_relaxed);
+        qint64 cpuNs = m_taskCpuNs.load(std::memory_order_relaxed);
+        if (wallNs > 0) {
+            printf("cpu         %lld ms in tasks, task efficiency %.3f\n", cpuNs / 1000000, double(cpuNs) / double(wallNs));
+        }
+        return;
+    }
+    PoolCpuStats cpu = m_pool->getCpuStats();
+    if (cpu.supported) {
+        printf("cpu         %lld ms total, task efficiency %.3f, switches %lld voluntary / %lld involuntary\n",
+               cpu.cpuTimeMs, cpu.efficiency, cpu.voluntarySwitches, cpu.involuntarySwitches);
+    }
+}
+
+bool parseRange(const QString& text, int& minValue, int& maxValue)
+{
+    QStringList parts = text.split(':');
+    bool okMin = false;
+    bool okMax = false;
+    int low = parts.value(0).toInt(&okMin);
+    int high = parts.size() == 2 ? parts[1].toInt(&okMax) : low;
+    if (parts.size() == 1) okMax = okMin;
+    if (!okMin || !okMax || low < 0 || high < low) return false;
+    minValue = low;
+    maxValue = high;
+    return true;
+}
+
+bool parsePolicy(const QString& text, SchedulePolicy& policy)
+{
+    for (int i = int(SchedulePolicy::FIFO); i <= int(SchedulePolicy::HRRN); ++i) {
+        SchedulePolicy candidate = static_cast<SchedulePolicy>(i);
+        if (text.compare(schedulePolicyName(candidate), Qt::CaseInsensitive) == 0 || text == QString::number(i)) {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseOptions(const QStringList& args, Options& options)
+{
+    for (int i = 0; i < args.size(); ++i) {
+        const QString& arg = args[i];
+        if (arg == "--verbose") {
+            options.verbose = true;
+            continue;
+        }
+        if (i + 1 >= args.size()) return false;
+        const QString value = args[++i];
+        bool ok = true;
+        if (arg == "--backend") {
+            if (value == "qt") options.backend = Backend::Qt;
+            else if (value == "std") options.backend = Backend::Std;
+            else ok = false;
+        }
+        else if (arg == "--min") options.minThreads = value.toInt(&ok);
+        else if (arg == "--max") options.maxThreads = value.toInt(&ok);
+        else if (arg == "--policy") ok = parsePolicy(value, options.policy);
+        else if (arg == "--tasks") options.tasks = value.toLongLong(&ok);
+        else if (arg == "--rate") options.rate = value.toDouble(&ok);
+        else if (arg == "--duration") options.durationS = value.toDouble(&ok);
+        else if (arg == "--task-ms") ok = parseRange(value, options.taskMsMin, options.taskMsMax);
+        else if (arg == "--priority-max") options.priorityMax = value.toInt(&ok);
+        else if (arg == "--mem") options.mem = value.toUInt(&ok);
+        else if (arg == "--mem-budget") options.memoryBudget = value.toLongLong(&ok);
+        else if (arg == "--timeout") options.timeoutS = value.toInt(&ok);
+        else if (arg == "--record") options.recordFile = value;
+        else if (arg == "--replay") options.replayFile = value;
+        else if (arg == "--speed") options.speed = value.toDouble(&ok);
+        else if (arg == "--loop") options.loops = value.toInt(&ok);
+        else if (arg == "--arrival") ok = parseArrivalSpec(value.toStdString(), options.load.arrival);
+        else if (arg == "--service") ok = options.serviceSet = parseServiceSpec(value.toStdString(), options.load.service);
+        else if (arg == "--priority-mix") ok = parsePriorityMix(value.toStdString(), options.load.priorities);
+        else if (arg == "--producers") options.load.producers = value.toInt(&ok);
+        else if (arg == "--seed") options.load.seed = value.toULongLong(&ok);
+        else if (arg == "--kind-mix") ok = parseTaskKindMix(value.toStdString(), options.load.kinds);
+        else return false;
+        if (!ok) return false;
+        if (arg == "--arrival" || arg == "--service" || arg == "--priority-mix" || arg == "--producers" || arg == "--seed") {
+            options.generator = true;
+        }
+    }
+    if (options.generator) {
+        options.load.arrival.ratePerSec = options.rate;
+        if (!options.serviceSet) {
+            options.load.service.distribution = ServiceDistribution::Uniform;
+            options.load.service.a = options.taskMsMin;
+            options.load.service.b = options.taskMsMax;
+        }
+        if (options.load.priorities.empty()) {
+            for (int p = 1; p <= options.priorityMax; ++p) options.load.priorities.push_back(PriorityWeight{p, 1.0});
+        }
+    }
+    return options.minThreads >= 0 && options.maxThreads >= qMax(1, options.minThreads)
+        && options.tasks > 0 && options.tasks < INT_MAX && options.rate >= 0 && options.durationS >= 0
+        && options.priorityMax >= 1 && options.memoryBudget >= 0 && options.timeoutS >= 0
+        && (options.backend == Backend::Qt || options.memoryBudget == 0)
+        && options.speed > 0 && options.loops >= 1
+        && (!options.generator || (options.replayFile.isEmpty() && options.load.producers >= 1 && options.load.producers <= 256));
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    Options options;
+    if (!parseOptions(app.arguments().mid(1), options)) {
+        fprintf(stderr, "usage: poolcli [--backend qt|std] [--min N] [--max N] [--policy FIFO|LIFO|SJF|LJF|PRIO|HRRN] [--tasks N]\n"
+                        "               [--rate TASKS_PER_SEC] [--duration S] [--task-ms MIN:MAX] [--priority-max P]\n"
+                        "               [--mem BYTES] [--mem-budget BYTES] [--timeout S] [--verbose]\n"
+                        "               [--record FILE] [--replay FILE [--speed X] [--loop N]]\n"
+                        "               [--arrival uniform|poisson|onoff:ON_MS:OFF_MS|diurnal:PERIOD_S:AMPLITUDE]\n"
+                        "               [--service fixed:MS|uniform:MIN:MAX|exp:MEAN|lognormal:MEDIAN:SIGMA|bimodal:SHORT:LONG:P_LONG]\n"
+                        "               [--priority-mix P:W,...] [--producers N] [--seed S]\n"
+                        "               [--kind-mix sleep|matmul|checksum|memstream|chase|mixedio:W,...]\n");
+        return 2;
+    }
+
+    // 日志走stderr，不和stdout上的汇总混在一起
+    PoolLogger& logger = PoolLogger::instance();
+    logger.setMinLevel(options.verbose ? LogLevel::Info : LogLevel::Warning);
+    QObject::connect(&logger, &PoolLogger::linesReady, [](const QStringList& lines) {
+        for (const QString& line : lines) fprintf(stderr, "%s\n", qPrintable(line));
+    });
+    logger.start();
+    QString logFile = qEnvironmentVariable("THREADPOOL_LOG_FILE");
+    if (!logFile.isEmpty()) {
+        logger.setFileSink(logFile);
+    }
+    PoolTracer::setCurrentThreadName("主线程");
+    QString traceFile = qEnvironmentVariable("THREADPOOL_TRACE_FILE");
+    if (!traceFile.isEmpty()) {
+        PoolTracer::instance().start();
+    }
+
+    int ret = 0;
+    {
+        CliRunner runner(options);
+        QTimer::singleShot(0, [&runner]() { runner.start(); });
+        app.exec();
+        ret = runner.exitCode();
+    }
+    logger.stop();
+    if (!traceFile.isEmpty()) {
+        PoolTracer::instance().stop();
+        PoolTracer::instance().exportChromeJson(traceFile);
+    }
+    return ret;
+}
@@ -0,0 +1,15 @@
+# 无界面运行线程池：按命令行参数生成负载，跑完输出吞吐量和延迟分位数（不依赖QtWidgets）
+QT       -= gui
+
+CONFIG += console c++17
+include($$PWD/../../warnings.pri)
+CONFIG -= app_bundle
+
+# 与GUI程序相同的编译开关
+#DEFINES += POOL_LOG_MIN_LEVEL=1
+#DEFINES += POOL_LOCK_PROFILING
+
+include(../../threadpoolcore.pri)
+
+SOURCES += \
+    main.cpp
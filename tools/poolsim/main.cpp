@@ -0,0 +1,195 @@
+#include "poolsimulator.h"
+#include "workloadtrace.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * 用法：poolsim [选项]
+ *   --policy P           只跑一种策略（名字或编号），默认all：6种策略各跑一遍同一份负载
+ *   --min N / --max N    最小/最大线程数（默认2/8）
+ *   --tasks N            任务数（默认10000）
+ *   --task-ms MIN:MAX    执行时间范围（默认1000:10000，与界面“添加任务”相同）
+ *   --priority-max P     优先级在1~P之间随机（默认10）
+ *   --rate R             每秒到达R个任务（泊松到达），默认0：全部在0时刻到达
+ *   --step-ms S          执行时间按S取整，对应ThreadPool::STEP_TIME_MS（默认20，0为不取整）
+ *   --manager-ms M       管理线程检查间隔（默认5000）
+ *   --seed S             负载的随机种子（默认1）
+ *   --trace FILE         改用录制的负载轨迹（THREADPOOL_WORKLOAD_FILE或poolcli --record），忽略上面的负载参数
+ * 输出一张对比表：sum列与ThreadPool::getTotalWaitingTimeMs()/getTotalResponseRatio()口径相同，
+ * 其余为排队等待、周转时间（到达→完成）和响应比的分位数，以及线程数和仿真相对真实时间的加速比。
+ */
+
+namespace {
+
+struct Options
+{
+    SimConfig config;
+    bool allPolicies = true;
+    int tasks = 10000;
+    int taskMsMin = 1000;
+    int taskMsMax = 10000;
+    int priorityMax = 10;
+    double rate = 0.0;
+    unsigned seed = 1;
+    std::string traceFile;
+};
+
+bool parseInt(const char* text, int& value)
+{
+    char* end = nullptr;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0') return false;
+    value = int(parsed);
+    return true;
+}
+
+// 不区分大小写比较（strcasecmp只有POSIX有）
+bool equalsIgnoreCase(const char* a, const char* b)
+{
+    for (; *a && *b; ++a, ++b) {
+        if (std::tolower(static_cast<unsigned char>(*a)) != std::tolower(static_cast<unsigned char>(*b))) return false;
+    }
+    return *a == *b;
+}
+
+bool parsePolicy(const char* text, Options& options)
+{
+    if (strcmp(text, "all") == 0) {
+        options.allPolicies = true;
+        return true;
+    }
+    for (int i = int(SchedulePolicy::FIFO); i <= int(SchedulePolicy::HRRN); ++i) {
+        SchedulePolicy policy = static_cast<SchedulePolicy>(i);
+        if (equalsIgnoreCase(text, schedulePolicyName(policy)) || (text[0] == char('0' + i) && text[1] == '\0')) {
+            options.config.policy = policy;
+            options.allPolicies = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        bool ok = true;
+        if (strcmp(arg, "--policy") == 0) ok = parsePolicy(value, options);
+        else if (strcmp(arg, "--min") == 0) ok = parseInt(value, options.config.minThreads);
+        else if (strcmp(arg, "--max") == 0) ok = parseInt(value, options.config.maxThreads);
+        else if (strcmp(arg, "--tasks") == 0) ok = parseInt(value, options.tasks);
+        else if (strcmp(arg, "--task-ms") == 0) ok = sscanf(value, "%d:%d", &options.taskMsMin, &options.taskMsMax) == 2;
+        else if (strcmp(arg, "--priority-max") == 0) ok = parseInt(value, options.priorityMax);
+        else if (strcmp(arg, "--rate") == 0) options.rate = atof(value);
+        else if (strcmp(arg, "--step-ms") == 0) ok = parseInt(value, options.config.stepMs);
+        else if (strcmp(arg, "--manager-ms") == 0) ok = parseInt(value, options.config.managerIntervalMs);
+        else if (strcmp(arg, "--seed") == 0) options.seed = unsigned(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--trace") == 0) options.traceFile = value;
+        else return false;
+        if (!ok) return false;
+    }
+    return options.config.minThreads >= 0 && options.config.maxThreads >= 1
+        && options.config.maxThreads >= options.config.minThreads && options.tasks > 0
+        && options.taskMsMin >= 1 && options.taskMsMax >= options.taskMsMin && options.priorityMax >= 1
+        && options.rate >= 0 && options.config.stepMs >= 0 && options.config.managerIntervalMs > 0;
+}
+
+std::vector<SimTask> generateWorkload(const Options& options)
+{
+    std::mt19937 random(options.seed);
+    std::uniform_int_distribution<int> runTime(options.taskMsMin, options.taskMsMax);
+    std::uniform_int_distribution<int> priority(1, options.priorityMax);
+    std::exponential_distribution<double> gap(options.rate > 0 ? options.rate / 1000.0 : 1.0);
+    std::vector<SimTask> workload(static_cast<size_t>(options.tasks));
+    double arrivalMs = 0.0;
+    for (int i = 0; i < options.tasks; ++i) {
+        SimTask& task = workload[size_t(i)];
+        task.id = i + 1;
+        task.totalTimeMs = runTime(random);
+        task.priority = priority(random);
+        if (options.rate > 0 && i > 0) arrivalMs += gap(random);
+        task.arrivalMs = int(arrivalMs);
+    }
+    return workload;
+}
+
+bool loadTrace(const std::string& path, std::vector<SimTask>& workload)
+{
+    std::vector<TraceRecord> records;
+    std::string error;
+    if (!WorkloadTraceReader::load(path, records, &error)) {
+        fprintf(stderr, "poolsim: %s: %s\n", path.c_str(), error.c_str());
+        return false;
+    }
+    workload.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        workload[i].id = int(i) + 1;
+        workload[i].arrivalMs = int(records[i].arrivalUs / 1000);
+        workload[i].totalTimeMs = records[i].totalTimeMs;
+        workload[i].priority = records[i].priority;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: poolsim [--policy all|FIFO|LIFO|SJF|LJF|PRIO|HRRN] [--min N] [--max N] [--tasks N]\n"
+                        "               [--task-ms MIN:MAX] [--priority-max P] [--rate TASKS_PER_SEC]\n"
+                        "               [--step-ms S] [--manager-ms M] [--seed S] [--trace FILE]\n");
+        return 2;
+    }
+
+    std::vector<SimTask> workload;
+    if (options.traceFile.empty()) {
+        workload = generateWorkload(options);
+    } else if (!loadTrace(options.traceFile, workload)) {
+        return 1;
+    }
+    std::vector<SchedulePolicy> policies;
+    if (options.allPolicies) {
+        for (int i = int(SchedulePolicy::FIFO); i <= int(SchedulePolicy::HRRN); ++i) policies.push_back(static_cast<SchedulePolicy>(i));
+    } else {
+        policies.push_back(options.config.policy);
+    }
+
+    if (!options.traceFile.empty()) {
+        printf("workload    %zu tasks from %s  threads %d..%d\n\n", workload.size(), options.traceFile.c_str(),
+               options.config.minThreads, options.config.maxThreads);
+    } else {
+        printf("workload    %d tasks  run %d..%d ms  priority 1..%d  %s  threads %d..%d  seed %u\n\n",
+               options.tasks, options.taskMsMin, options.taskMsMax, options.priorityMax,
+               options.rate > 0 ? (std::to_string(options.rate) + " tasks/s").c_str() : "all at t=0",
+               options.config.minThreads, options.config.maxThreads, options.seed);
+    }
+    printf("%-6s %10s %14s %12s | %9s %9s %9s | %9s %9s %9s | %7s %7s %7s | %4s %6s %5s | %8s %9s\n",
+           "policy", "makespan_s", "sum_wait_ms", "sum_ratio",
+           "wait_p50", "wait_p90", "wait_p99", "turn_p50", "turn_p90", "turn_p99",
+           "rr_mean", "rr_p90", "rr_p99", "peak", "avg_th", "util", "sim_ms", "speedup");
+    for (SchedulePolicy policy : policies) {
+        SimConfig config = options.config;
+        config.policy = policy;
+        auto start = std::chrono::steady_clock::now();
+        SimResult r = PoolSimulator(config).run(workload);
+        double simMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        printf("%-6s %10.1f %14lld %12.1f | %9.0f %9.0f %9.0f | %9.0f %9.0f %9.0f | %7.2f %7.2f %7.2f | %4d %6.2f %5.2f | %8.1f %8.0fx\n",
+               schedulePolicyName(policy), r.makespanMs / 1000.0, (long long)r.totalWaitingTimeMs, r.totalResponseRatio,
+               r.queueWaitMs.p50, r.queueWaitMs.p90, r.queueWaitMs.p99,
+               r.turnaroundMs.p50, r.turnaroundMs.p90, r.turnaroundMs.p99,
+               r.responseRatio.mean, r.responseRatio.p90, r.responseRatio.p99,
+               r.peakThreads, r.averageThreads, r.utilization, simMs, simMs > 0 ? r.makespanMs / simMs : 0.0);
+    }
+    return 0;
+}
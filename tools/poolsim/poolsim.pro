@@ -0,0 +1,13 @@
+# 离散事件仿真：用虚拟时钟跑同一份负载，对比各调度策略的等待时间和响应比，只依赖core，不需要Qt
+TEMPLATE = app
+CONFIG += console c++17
+include($$PWD/../../warnings.pri)
+CONFIG -= qt app_bundle
+
+unix: LIBS += -pthread
+unix: QMAKE_CXXFLAGS += -pthread
+
+include(../../core/core.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,117 @@
+#include "shmstatusreader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+/*
+ * 用法：shmtop [-d 刷新间隔ms] [-n 刷新次数] [段名，默认/threadpool_status]
+ * 像top一样定时刷新：计数器、每个工作线程的状态和CPU、正在执行的任务。
+ * 写者退出（writerPid为0或进程不存在）后每次刷新都尝试重新打开，线程池重启后自动接上。
+ */
+
+namespace {
+    // 与SchedulePolicy的顺序一致
+    const char* const POLICY_NAMES[] = {"FIFO", "LIFO", "SJF", "LJF", "PRIO", "HRRN"};
+
+    const char* policyName(int policy)
+    {
+        int count = int(sizeof(POLICY_NAMES) / sizeof(POLICY_NAMES[0]));
+        return policy >= 0 && policy < count ? POLICY_NAMES[policy] : "?";
+    }
+
+    long long nowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::string formatBytes(long long bytes)
+    {
+        char text[32];
+        if (bytes >= 1024LL * 1024 * 1024) snprintf(text, sizeof(text), "%.1fG", bytes / (1024.0 * 1024 * 1024));
+        else if (bytes >= 1024LL * 1024) snprintf(text, sizeof(text), "%.1fM", bytes / (1024.0 * 1024));
+        else if (bytes >= 1024) snprintf(text, sizeof(text), "%.1fK", bytes / 1024.0);
+        else snprintf(text, sizeof(text), "%lldB", bytes);
+        return text;
+    }
+
+    void render(const ShmStatusSnapshot& s, const std::string& name, bool writerAlive)
+    {
+        const ShmStatus::Counters& c = s.counters;
+        printf("\033[H\033[2J");
+        printf("shmtop - %s  writer pid %d%s  update #%lld  age %lldms\n",
+               name.c_str(), c.writerPid, writerAlive ? "" : " (exited)",
+               (long long)c.updateCount, nowMs() - (long long)c.timestampMs);
+        printf("Policy: %-5s Threads: %d alive, %d busy   Tasks: %d waiting, %d finished, %lld submitted\n",
+               policyName(c.policy), c.aliveThreads, c.busyThreads, c.waitingTasks, c.finishedTasks,
+               (long long)c.submittedTasks);
+        printf("Memory: %s reserved / %s budget   CPU: %lldms total, task efficiency %.1f%%%s\n\n",
+               formatBytes(c.memoryReserved).c_str(),
+               c.memoryBudget > 0 ? formatBytes(c.memoryBudget).c_str() : "unlimited",
+               (long long)c.cpuTimeMs, c.taskCpuEfficiency * 100.0,
+               c.truncated ? "   [truncated]" : "");
+
+        printf("%6s %-5s %7s %10s %10s %6s %8s %8s\n",
+               "THREAD", "STATE", "TASK", "CPU(ms)", "BUSY(ms)", "CPU%", "VOL_CS", "INVOL_CS");
+        for (const ShmStatus::ThreadEntry& t : s.threads) {
+            double cpuPercent = t.busyTimeMs > 0 ? 100.0 * t.cpuTimeMs / t.busyTimeMs : 0.0;
+            char task[16] = "-";
+            if (t.curTaskId >= 0) snprintf(task, sizeof(task), "%d", t.curTaskId);
+            printf("%6d %-5s %7s %10lld %10lld %6.1f %8lld %8lld\n",
+                   t.id, t.state == 1 ? "BUSY" : "IDLE", task,
+                   (long long)t.cpuTimeMs, (long long)t.busyTimeMs, cpuPercent,
+                   (long long)t.voluntarySwitches, (long long)t.involuntarySwitches);
+        }
+
+        printf("\n%7s %6s %10s\n", "TASK", "THREAD", "MEM");
+        for (const ShmStatus::ActiveTask& t : s.activeTasks) {
+            printf("%7d %6d %10s\n", t.id, t.threadId, formatBytes(t.memSize).c_str());
+        }
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int delayMs = 1000;
+    long long iterations = -1;
+    std::string name = ShmStatus::DEFAULT_NAME;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            delayMs = std::max(50, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = atoll(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: shmtop [-d ms] [-n count] [name]\n");
+            return 2;
+        } else {
+            name = argv[i];
+        }
+    }
+
+    ShmStatusReader reader;
+    ShmStatusSnapshot snapshot;
+    for (long long n = 0; iterations < 0 || n < iterations; ++n) {
+        if (n > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        if (!reader.isOpen() && !reader.open(name)) {
+            printf("\033[H\033[2Jshmtop - waiting for %s: %s\n", name.c_str(), reader.errorString().c_str());
+            fflush(stdout);
+            continue;
+        }
+        if (!reader.read(snapshot)) {
+            printf("\033[H\033[2Jshmtop - %s: %s\n", name.c_str(), reader.errorString().c_str());
+            fflush(stdout);
+            continue;
+        }
+        bool alive = ShmStatusReader::writerAlive(snapshot);
+        render(snapshot, name, alive);
+        // 写者已退出：下次刷新重新打开（线程池重启后会重建同名段）
+        if (!alive) reader.close();
+    }
+    return 0;
+}
@@ -0,0 +1,16 @@
+# 共享内存状态段的top风格查看器，只依赖shmstatusreader，不需要Qt
+TEMPLATE = app
+CONFIG += console c++17
+include($$PWD/../../warnings.pri)
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ../../communication
+unix:!macx: LIBS += -lrt
+
+SOURCES += \
+    ../../communication/shmstatusreader.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../communication/shmstatus.h \
+    ../../communication/shmstatusreader.h
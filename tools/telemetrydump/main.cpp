@@ -0,0 +1,51 @@
+#include "telemetryreader.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QStringList>
+#include <cstdio>
+
+/*
+ * 用法：telemetrydump [--pretty] <遥测文件>
+ * 每条记录输出一行紧凑JSON（时间戳放回"timestamp"字段），--pretty时改为缩进格式并带可读时间。
+ * 统计信息（记录数、跳过的损坏行）输出到stderr，方便和jq等工具串联。
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments().mid(1);
+    bool pretty = args.removeAll("--pretty") > 0;
+    if (args.size() != 1) {
+        fprintf(stderr, "usage: telemetrydump [--pretty] <file>\n");
+        return 2;
+    }
+
+    TelemetryReader reader(args.first());
+    if (!reader.open()) {
+        fprintf(stderr, "telemetrydump: %s\n", qPrintable(reader.errorString()));
+        return 1;
+    }
+
+    qint64 count = 0;
+    TelemetryRecord record;
+    while (reader.next(record)) {
+        QJsonObject object = record.data;
+        object[TelemetryFile::TIMESTAMP_KEY] = record.timestampMs;
+        if (pretty) {
+            QString time = QDateTime::fromMSecsSinceEpoch(record.timestampMs).toString("yyyy-MM-dd hh:mm:ss.zzz");
+            printf("# %s\n%s", qPrintable(time), QJsonDocument(object).toJson(QJsonDocument::Indented).constData());
+        } else {
+            printf("%s\n", QJsonDocument(object).toJson(QJsonDocument::Compact).constData());
+        }
+        count++;
+    }
+
+    fprintf(stderr, "telemetrydump: %lld records (%s), %d skipped\n", count,
+            reader.format() == TelemetryFormat::Binary ? "binary" : "json-lines", reader.skippedCount());
+    if (!reader.errorString().isEmpty()) {
+        fprintf(stderr, "telemetrydump: stopped at corrupt data: %s\n", qPrintable(reader.errorString()));
+        return 1;
+    }
+    return 0;
+}
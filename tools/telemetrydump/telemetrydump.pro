@@ -0,0 +1,17 @@
+# 遥测文件解码工具：把TelemetrySink写出的二进制/JSON行文件逐条打印为JSON行
+QT       += core
+QT       -= gui
+
+CONFIG += console c++17
+include($$PWD/../../warnings.pri)
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../communication
+
+SOURCES += \
+    ../../communication/telemetryreader.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../communication/telemetryformat.h \
+    ../../communication/telemetryreader.h
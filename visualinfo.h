@@ -16,7 +16,11 @@ struct ThreadVisualInfo {
     ThreadState state;  // 线程状态: 0=idle，1=busy, -1=exit
     int curTaskId = -1;  // 正在执行的任务id
     int curTimeMs = 0;  // 已耗时
-
+    // CPU统计（线程启动以来），只在线程池快照中填写
+    int cpuTimeMs = 0;  // 实际占用的CPU时间
+    int busyTimeMs = 0;  // 执行任务的墙钟时间
+    int voluntarySwitches = 0;  // 主动上下文切换
+    int involuntarySwitches = 0;  // 被动上下文切换（被抢占）
 };
 // 只把totalTimeMs放在TaskVisualInfo中
 struct TaskVisualInfo {
@@ -27,6 +31,8 @@ struct TaskVisualInfo {
     int priority = 0;  // 优先级
     int arrivalTimestampMs = 0;  // 到达时间
     int finishTimestampMs = 0;   // 完成时间
+    int wallTimeUs = 0;  // 实际执行的墙钟时间
+    int cpuTimeUs = 0;  // 执行期间实际占用的CPU时间，cpuTimeUs/wallTimeUs即CPU效率
 };
 
 #endif // VISUALINFO_H
@@ -0,0 +1,8 @@
+# 所有工程共用的告警设置（GUI、tools/*和core.pro都包含它）
+# 合并前用 qmake CONFIG+=werror 编译整棵树：告警即报错，确认零告警
+CONFIG += warn_on
+*g++*|*clang*: QMAKE_CXXFLAGS_WARN_ON += -Wextra
+werror {
+    *g++*|*clang*: QMAKE_CXXFLAGS_WARN_ON += -Werror
+    msvc: QMAKE_CXXFLAGS_WARN_ON += /WX
+}